@@ -0,0 +1,51 @@
+/**
+ * Batch framing benchmarks. Run with `pnpm bench`.
+ *
+ * Compares one BatchEncoder arena against encode() per record followed by
+ * Buffer.concat, and reading the frames back.
+ */
+
+import { bench, describe } from 'vitest';
+import { encode, decode, BatchEncoder, BatchDecoder } from '../src/index';
+
+const records = Array.from({ length: 1000 }, (_, i) => ({ id: i, name: `record ${i}`, active: i % 2 === 0, score: i / 7 }));
+
+function concatFrames(): Buffer {
+  const parts: Buffer[] = [];
+  for (const record of records) {
+    const message = encode(record);
+    const header = Buffer.allocUnsafe(4);
+    header.writeUInt32LE(message.length);
+    parts.push(header, message);
+  }
+  return Buffer.concat(parts);
+}
+
+const batchEncoder = new BatchEncoder();
+for (const record of records) batchEncoder.add(record);
+const batch = batchEncoder.finish();
+
+describe('frame 1000 small records', () => {
+  bench('BatchEncoder', () => {
+    for (const record of records) batchEncoder.add(record);
+    batchEncoder.finish();
+  });
+
+  bench('encode() + Buffer.concat', () => {
+    concatFrames();
+  });
+});
+
+describe('read 1000 frames', () => {
+  bench('BatchDecoder.decodeAll', () => {
+    BatchDecoder.decodeAll(batch);
+  });
+
+  bench('BatchDecoder.push in 16 KB chunks', () => {
+    const decoder = new BatchDecoder();
+    for (let offset = 0; offset < batch.length; offset += 16 * 1024) {
+      for (const frame of decoder.push(batch.subarray(offset, offset + 16 * 1024))) decode(frame);
+    }
+    decoder.end();
+  });
+});
@@ -0,0 +1,66 @@
+/**
+ * Decode benchmarks for wide objects and long arrays.
+ *
+ * Run with `pnpm bench`. To compare against another revision, record a
+ * baseline there with `pnpm bench --outputJson bench-baseline.json` and then
+ * run `pnpm bench --compare bench-baseline.json` on this one.
+ */
+
+import { bench, describe } from 'vitest';
+import { encode, decode } from '../src/index';
+
+const wide = Object.fromEntries(
+  Array.from({ length: 1000 }, (_, i) => [`field_${i}`, i % 3 === 0 ? `value ${i}` : i * 1.5])
+);
+const wideBuf = encode(wide);
+const wideJson = JSON.stringify(wide);
+
+const longArray = { values: Array.from({ length: 10_000 }, (_, i) => i * 0.25) };
+const longArrayBuf = encode(longArray);
+const longArrayJson = JSON.stringify(longArray);
+
+const records = {
+  rows: Array.from({ length: 1000 }, (_, i) => ({ id: i, name: `row ${i}`, active: i % 2 === 0, score: i / 7 })),
+};
+const recordsBuf = encode(records);
+const recordsJson = JSON.stringify(records);
+
+describe('decode: wide object (1000 fields)', () => {
+  bench('lite3 decode', () => {
+    decode(wideBuf);
+  });
+
+  bench('JSON.parse', () => {
+    JSON.parse(wideJson);
+  });
+});
+
+describe('decode: long array (10k numbers)', () => {
+  bench('lite3 decode', () => {
+    decode(longArrayBuf);
+  });
+
+  bench('JSON.parse', () => {
+    JSON.parse(longArrayJson);
+  });
+});
+
+describe('decode: long array as Float64Array (10k numbers)', () => {
+  bench('lite3 decode { typedArrays: true }', () => {
+    decode(longArrayBuf, { typedArrays: true });
+  });
+
+  bench('lite3 decode', () => {
+    decode(longArrayBuf);
+  });
+});
+
+describe('decode: array of 1000 records', () => {
+  bench('lite3 decode', () => {
+    decode(recordsBuf);
+  });
+
+  bench('JSON.parse', () => {
+    JSON.parse(recordsJson);
+  });
+});
@@ -0,0 +1,19 @@
+/**
+ * Encode benchmarks. Run with `pnpm bench`.
+ */
+
+import { bench, describe } from 'vitest';
+import { encode } from '../src/index';
+
+const numbers = Array.from({ length: 100_000 }, (_, i) => i * 0.25);
+const typed = Float64Array.from(numbers);
+
+describe('encode: 100k numbers', () => {
+  bench('plain array', () => {
+    encode({ values: numbers });
+  });
+
+  bench('Float64Array', () => {
+    encode({ values: typed });
+  });
+});
@@ -0,0 +1,105 @@
+/**
+ * Benchmark documents: three shapes at three sizes.
+ *
+ *   wide  - one object with many scalar fields
+ *   deep  - a chain of nested objects, a few fields per level
+ *   array - an array of small records, the typical API payload
+ *
+ * Documents are generated deterministically so runs are comparable across
+ * machines and commits. Each fixture names one leaf for single-field reads.
+ */
+
+export type Shape = 'wide' | 'deep' | 'array';
+export type Size = 'small' | 'medium' | 'huge';
+
+export interface Fixture {
+  /** Used to label benchmark groups, e.g. "medium array" */
+  name: string;
+  shape: Shape;
+  size: Size;
+  value: Record<string, unknown>;
+  /** Number of leaf values in the document */
+  fields: number;
+  /** Path of the leaf read by the single-field benchmarks */
+  path: string;
+  /** Reads the same leaf from a decoded document or proxy */
+  read(doc: any): unknown;
+}
+
+function record(i: number): Record<string, unknown> {
+  return {
+    id: i,
+    name: `record ${i}`,
+    active: i % 2 === 0,
+    score: i / 7,
+    tags: ['alpha', 'beta', 'gamma'].slice(0, 1 + (i % 3)),
+    owner: i % 5 === 0 ? null : { id: i * 31, email: `user${i}@example.com` },
+  };
+}
+
+function wide(fields: number): Fixture['value'] {
+  const value: Record<string, unknown> = {};
+  for (let i = 0; i < fields; i++) {
+    switch (i % 4) {
+      case 0: value[`field_${i}`] = i; break;
+      case 1: value[`field_${i}`] = `value ${i}`; break;
+      case 2: value[`field_${i}`] = i * 1.5; break;
+      default: value[`field_${i}`] = i % 8 === 3; break;
+    }
+  }
+  return value;
+}
+
+function deep(depth: number, fieldsPerLevel: number): Fixture['value'] {
+  let node: Record<string, unknown> = { leaf: 'bottom' };
+  for (let level = depth - 1; level >= 0; level--) {
+    const parent: Record<string, unknown> = { level, child: node };
+    for (let i = 0; i < fieldsPerLevel; i++) parent[`f${i}`] = `level ${level} field ${i}`;
+    node = parent;
+  }
+  return node;
+}
+
+/** Counts the leaves of a decoded document, or of a proxy over one */
+export function countFields(value: unknown): number {
+  if (value === null || typeof value !== 'object' || ArrayBuffer.isView(value)) return 1;
+  let count = 0;
+  for (const key of Object.keys(value)) count += countFields((value as Record<string, unknown>)[key]);
+  return count;
+}
+
+function fixture(shape: Shape, size: Size, value: Fixture['value'], path: string, read: Fixture['read']): Fixture {
+  return { name: `${size} ${shape}`, shape, size, value, fields: countFields(value), path, read };
+}
+
+function deepFixture(size: Size, depth: number, fieldsPerLevel: number): Fixture {
+  const path = `${'child.'.repeat(depth)}leaf`;
+  return fixture('deep', size, deep(depth, fieldsPerLevel), path, (doc) => {
+    let node = doc;
+    for (let i = 0; i < depth; i++) node = node.child;
+    return node.leaf;
+  });
+}
+
+function arrayFixture(size: Size, rows: number): Fixture {
+  const middle = rows >> 1;
+  const value = { rows: Array.from({ length: rows }, (_, i) => record(i)) };
+  return fixture('array', size, value, `rows[${middle}].name`, (doc) => doc.rows[middle].name);
+}
+
+function wideFixture(size: Size, fields: number): Fixture {
+  const key = `field_${fields - 3}`;
+  return fixture('wide', size, wide(fields), key, (doc) => doc[key]);
+}
+
+export const fixtures: Fixture[] = [
+  wideFixture('small', 32),
+  deepFixture('small', 8, 2),
+  arrayFixture('small', 8),
+  wideFixture('medium', 4_000),
+  deepFixture('medium', 64, 16),
+  arrayFixture('medium', 1_000),
+  wideFixture('huge', 200_000),
+  deepFixture('huge', 200, 1_000),
+  arrayFixture('huge', 100_000),
+];
@@ -0,0 +1,88 @@
+/**
+ * JSON ingress/egress benchmarks. Run with `pnpm bench`.
+ *
+ * Compares converting JSON text to and from lite3 natively against going
+ * through JS objects, and how long encodeAsync() holds the calling thread
+ * compared to encode().
+ */
+
+import { bench, describe } from 'vitest';
+import { encode, encodeAsync, decode, fromJSON, toJSON } from '../src/index';
+
+const records = {
+  rows: Array.from({ length: 1000 }, (_, i) => ({ id: i, name: `row ${i}`, active: i % 2 === 0, score: i / 7 })),
+};
+const recordsJson = JSON.stringify(records);
+const recordsJsonBytes = Buffer.from(recordsJson);
+const recordsBuf = fromJSON(recordsJson);
+
+const wide = Object.fromEntries(
+  Array.from({ length: 1000 }, (_, i) => [`field_${i}`, i % 3 === 0 ? `value ${i}` : i * 1.5])
+);
+const wideJson = JSON.stringify(wide);
+const wideBuf = fromJSON(wideJson);
+
+describe('JSON -> lite3: array of 1000 records', () => {
+  bench('fromJSON(string)', () => {
+    fromJSON(recordsJson);
+  });
+
+  bench('fromJSON(Buffer)', () => {
+    fromJSON(recordsJsonBytes);
+  });
+
+  bench('encode(JSON.parse(string))', () => {
+    encode(JSON.parse(recordsJson));
+  });
+});
+
+describe('JSON -> lite3: wide object (1000 fields)', () => {
+  bench('fromJSON(string)', () => {
+    fromJSON(wideJson);
+  });
+
+  bench('encode(JSON.parse(string))', () => {
+    encode(JSON.parse(wideJson));
+  });
+});
+
+// encodeAsync() promises still running; each bench times only the calls and
+// waits for them afterwards.
+const pending: Promise<Buffer>[] = [];
+const drain = async () => {
+  await Promise.all(pending.splice(0));
+};
+
+describe('calling-thread time: array of 1000 records', () => {
+  bench('encode()', () => {
+    encode(records);
+  });
+
+  bench('encodeAsync()', () => {
+    pending.push(encodeAsync(records, { asyncThreshold: 0 }));
+  }, { teardown: drain });
+});
+
+describe('lite3 -> JSON: array of 1000 records', () => {
+  bench('toJSON', () => {
+    toJSON(recordsBuf);
+  });
+
+  bench('toJSON { asBuffer: true }', () => {
+    toJSON(recordsBuf, { asBuffer: true });
+  });
+
+  bench('JSON.stringify(decode())', () => {
+    JSON.stringify(decode(recordsBuf));
+  });
+});
+
+describe('lite3 -> JSON: wide object (1000 fields)', () => {
+  bench('toJSON', () => {
+    toJSON(wideBuf);
+  });
+
+  bench('JSON.stringify(decode())', () => {
+    JSON.stringify(decode(wideBuf));
+  });
+});
@@ -0,0 +1,59 @@
+/**
+ * Proxy access benchmarks. Run with `pnpm bench`.
+ *
+ * A single field read should cost the same regardless of how large the
+ * message around it is.
+ */
+
+import { bench, describe } from 'vitest';
+import { encode, getValue, getArrayElement, Lite3Buffer } from '../src/index';
+
+function message(padding: number) {
+  return encode({
+    id: 7,
+    name: 'needle',
+    padding: 'x'.repeat(padding),
+    items: [1, 2, 3],
+  });
+}
+
+const sizes = [
+  ['1 KB', message(1_000)],
+  ['1 MB', message(1_000_000)],
+  ['16 MB', message(16_000_000)],
+] as const;
+
+describe('getValue: one field', () => {
+  for (const [label, buf] of sizes) {
+    bench(label, () => {
+      getValue(buf, 0, 'name');
+    });
+  }
+});
+
+describe('getArrayElement: one element', () => {
+  for (const [label, buf] of sizes) {
+    const items = getValue(buf, 0, 'items') as number;
+    bench(label, () => {
+      getArrayElement(buf, items, 1);
+    });
+  }
+});
+
+describe('Lite3Buffer: fresh proxy, one field', () => {
+  for (const [label, buf] of sizes) {
+    bench(label, () => {
+      void Lite3Buffer.from<{ name: string }>(buf).name;
+    });
+  }
+});
+
+const records = encode({
+  rows: Array.from({ length: 10_000 }, (_, i) => ({ id: i, name: `row-${i}` })),
+});
+
+describe('Lite3Buffer: map over 10k rows', () => {
+  bench('proxy', () => {
+    Lite3Buffer.from<{ rows: { id: number }[] }>(records).rows.map((row) => row.id);
+  });
+});
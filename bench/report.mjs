@@ -0,0 +1,99 @@
+#!/usr/bin/env node
+/**
+ * Summarizes a benchmark run of suite.bench.ts and checks it for regressions.
+ *
+ *   node bench/report.mjs [results.json] [--check] [--ci] [--baseline file]
+ *
+ * Reads the JSON written by `vitest bench --outputJson` (default:
+ * bench/results/latest.json) and the per-fixture metrics the suite writes to
+ * bench/results/fixtures.json, and prints ops/s, ns/field, MB/s and native
+ * allocations per benchmark. With --check, exits non-zero when a benchmark is
+ * slower than in the baseline (default: bench/baseline.json) by more than
+ * BENCH_TOLERANCE percent (default: 15). Without a baseline the check is
+ * skipped: baselines are machine-specific, so none is committed. In CI (with
+ * --ci, or when the CI environment variable is set) a missing baseline fails
+ * the check instead, so a misconfigured job can't pass without comparing.
+ */
+
+import { existsSync, readFileSync } from 'node:fs';
+
+const args = process.argv.slice(2);
+const check = args.includes('--check');
+const ci = args.includes('--ci') || !['', '0', 'false'].includes(process.env.CI ?? '');
+const baselineIndex = args.indexOf('--baseline');
+const baselinePath = baselineIndex >= 0 ? args[baselineIndex + 1] : 'bench/baseline.json';
+const resultsPath =
+  args.find((arg, i) => !arg.startsWith('--') && (baselineIndex < 0 || i !== baselineIndex + 1)) ??
+  'bench/results/latest.json';
+const tolerance = Number(process.env.BENCH_TOLERANCE ?? 15) / 100;
+
+const readJson = (path) => JSON.parse(readFileSync(path, 'utf8'));
+
+/** Maps "<group> > <bench>" to hz, for the groups of suite.bench.ts */
+function benchmarks(results) {
+  const hz = new Map();
+  for (const file of results.files) {
+    for (const group of file.groups) {
+      const name = group.fullName.split(' > ').pop();
+      for (const bench of group.benchmarks) hz.set(`${name} > ${bench.name}`, bench.hz);
+    }
+  }
+  return hz;
+}
+
+/** Size of the input or output a benchmark processes, in bytes */
+function bytesFor(fixture, bench) {
+  if (bench.startsWith('lite3')) return fixture.lite3Bytes;
+  if (bench.startsWith('msgpack')) return fixture.msgpackBytes;
+  return fixture.jsonBytes;
+}
+
+const results = benchmarks(readJson(resultsPath));
+const fixtures = new Map(readJson('bench/results/fixtures.json').map((fixture) => [fixture.name, fixture]));
+
+const rows = [];
+for (const [key, hz] of results) {
+  const [group, bench] = key.split(' > ');
+  const [fixtureName, op] = group.split(' | ');
+  const fixture = fixtures.get(fixtureName);
+  if (!fixture) continue;
+
+  // A single-field read touches one field and no meaningful number of bytes;
+  // everything else processes the whole document:
+  const single = bench.endsWith('field') && !bench.startsWith('JSON');
+  const fields = single ? 1 : fixture.fields;
+  const bytes = single ? undefined : bytesFor(fixture, bench);
+  rows.push({
+    fixture: fixtureName,
+    op,
+    bench,
+    'ops/s': Math.round(hz),
+    'ns/field': +(1e9 / hz / fields).toFixed(2),
+    'MB/s': bytes === undefined ? '' : +((bytes * hz) / 1e6).toFixed(1),
+    allocs: bench === 'lite3 encode' ? fixture.encodeAllocations : '',
+  });
+}
+console.table(rows);
+
+if (check && !existsSync(baselinePath) && ci) {
+  console.error(`No baseline at ${baselinePath}; CI jobs must provide one to compare against`);
+  process.exit(1);
+} else if (check && !existsSync(baselinePath)) {
+  console.log(`No baseline at ${baselinePath}; skipping the regression check (record one with \`pnpm bench:baseline\`)`);
+} else if (check) {
+  const baseline = benchmarks(readJson(baselinePath));
+  const regressions = [];
+  for (const [key, hz] of results) {
+    const before = baseline.get(key);
+    if (before !== undefined && hz < before * (1 - tolerance)) {
+      regressions.push(`${key}: ${Math.round(before)} -> ${Math.round(hz)} ops/s (${((hz / before - 1) * 100).toFixed(1)}%)`);
+    }
+  }
+
+  if (regressions.length > 0) {
+    console.error(`Regressions beyond ${tolerance * 100}% of ${baselinePath}:`);
+    for (const line of regressions) console.error(`  ${line}`);
+    process.exit(1);
+  }
+  console.log(`No regressions beyond ${tolerance * 100}% of ${baselinePath}`);
+}
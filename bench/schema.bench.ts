@@ -0,0 +1,50 @@
+/**
+ * Compiled schema benchmarks. Run with `pnpm bench`.
+ *
+ * Compares a schema compiled for a fixed record shape against the generic
+ * encode() and decode() on the same records.
+ */
+
+import { bench, describe } from 'vitest';
+import { encode, decode, compileSchema } from '../src/index';
+
+const records = Array.from({ length: 1000 }, (_, i) => ({
+  id: i,
+  name: `record ${i}`,
+  active: i % 2 === 0,
+  score: i / 7,
+  tags: ['alpha', 'beta'],
+  owner: { id: i * 31, email: `user${i}@example.com` },
+}));
+
+const schema = compileSchema({
+  id: 'integer',
+  name: 'string',
+  active: 'boolean',
+  score: 'number',
+  tags: ['string'],
+  owner: { id: 'integer', email: 'string' },
+});
+
+const generic = records.map((record) => encode(record));
+const compiled = records.map((record) => schema.encode(record));
+
+describe('encode 1000 fixed-shape records', () => {
+  bench('encode()', () => {
+    for (const record of records) encode(record);
+  });
+
+  bench('schema.encode()', () => {
+    for (const record of records) schema.encode(record);
+  });
+});
+
+describe('decode 1000 fixed-shape records', () => {
+  bench('decode()', () => {
+    for (const buffer of generic) decode(buffer);
+  });
+
+  bench('schema.decode()', () => {
+    for (const buffer of compiled) schema.decode(buffer);
+  });
+});
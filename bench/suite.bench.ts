@@ -0,0 +1,117 @@
+/**
+ * Benchmark matrix across document shapes and sizes. Run with `pnpm bench`;
+ * record a baseline with `pnpm bench:baseline` and check against it with
+ * `pnpm bench:compare`.
+ *
+ * Every fixture in fixtures.ts is encoded, decoded and read through lazy
+ * proxies, next to JSON, structuredClone and, when it is installed,
+ * @msgpack/msgpack. vitest reports ops/s; the numbers it can't measure
+ * (fields and bytes per document, native allocations per encode, cursors
+ * and native memory per traversal) are written to
+ * bench/results/fixtures.json, from which bench/report.mjs derives ns/field
+ * and bytes/s.
+ */
+
+import { bench, describe } from 'vitest';
+import { mkdirSync, writeFileSync } from 'node:fs';
+import { encode, decode, getPath, getEncodeAllocations, Lite3Buffer } from '../src/index';
+import { fixtures, countFields } from './fixtures';
+
+interface MsgPack {
+  encode(value: unknown): Uint8Array;
+  decode(data: Uint8Array): unknown;
+}
+
+// Optional: compared against only if installed. The specifier is a variable
+// so bundlers don't try to resolve it.
+const msgpackModule = '@msgpack/msgpack';
+const msgpack: MsgPack | undefined = await import(/* @vite-ignore */ msgpackModule).catch(() => undefined);
+
+// Encodes per fixture used to average native allocations:
+const ALLOCATION_SAMPLES = 10;
+
+const metrics = fixtures.map((fixture) => {
+  const before = getEncodeAllocations();
+  for (let i = 0; i < ALLOCATION_SAMPLES; i++) encode(fixture.value);
+  const encodeAllocations = (getEncodeAllocations() - before) / ALLOCATION_SAMPLES;
+
+  const buffer = encode(fixture.value);
+  const proxy = Lite3Buffer.from(buffer);
+  countFields(proxy);
+  const stats = Lite3Buffer.getCursor(proxy)!.stats;
+
+  return {
+    name: fixture.name,
+    fields: fixture.fields,
+    lite3Bytes: buffer.length,
+    jsonBytes: Buffer.byteLength(JSON.stringify(fixture.value)),
+    msgpackBytes: msgpack ? msgpack.encode(fixture.value).length : undefined,
+    encodeAllocations,
+    cursorsPerTraversal: stats.misses + 1,
+    proxyNativeBytes: stats.nativeBytes,
+  };
+});
+
+const resultsDir = new URL('./results/', import.meta.url);
+mkdirSync(resultsDir, { recursive: true });
+writeFileSync(new URL('fixtures.json', resultsDir), JSON.stringify(metrics, null, 2) + '\n');
+
+for (const fixture of fixtures) {
+  const buffer = encode(fixture.value);
+  const json = JSON.stringify(fixture.value);
+  const packed = msgpack?.encode(fixture.value);
+
+  describe(`${fixture.name} | encode`, () => {
+    bench('lite3 encode', () => {
+      encode(fixture.value);
+    });
+
+    bench('JSON.stringify', () => {
+      JSON.stringify(fixture.value);
+    });
+
+    bench('structuredClone', () => {
+      structuredClone(fixture.value);
+    });
+
+    if (msgpack) {
+      bench('msgpack encode', () => {
+        msgpack.encode(fixture.value);
+      });
+    }
+  });
+
+  describe(`${fixture.name} | decode`, () => {
+    bench('lite3 decode', () => {
+      decode(buffer);
+    });
+
+    bench('JSON.parse', () => {
+      JSON.parse(json);
+    });
+
+    if (packed) {
+      bench('msgpack decode', () => {
+        msgpack!.decode(packed);
+      });
+    }
+  });
+
+  describe(`${fixture.name} | access`, () => {
+    bench('lite3 proxy traversal', () => {
+      countFields(Lite3Buffer.from(buffer));
+    });
+
+    bench('lite3 proxy field', () => {
+      fixture.read(Lite3Buffer.from(buffer));
+    });
+
+    bench('lite3 getPath field', () => {
+      getPath(buffer, fixture.path);
+    });
+
+    bench('JSON.parse field', () => {
+      fixture.read(JSON.parse(json));
+    });
+  });
+}
@@ -10,8 +10,22 @@
         "src/addon_encode.c",
         "src/addon_decode.c",
         "src/addon_proxy.c",
+        "src/addon_options.c",
+        "src/addon_encoder.c",
+        "src/addon_batch.c",
+        "src/addon_keycache.c",
+        "src/addon_cursor.c",
+        "src/addon_path.c",
+        "src/addon_async.c",
+        "src/addon_verify.c",
+        "src/addon_json.c",
+        "src/addon_mutate.c",
+        "src/addon_stats.c",
+        "src/addon_schema.c",
+        "src/addon_file.c",
         "deps/lite3/src/lite3.c",
         "deps/lite3/src/json_enc.c",
+        "deps/lite3/src/json_dec.c",
         "deps/lite3/src/ctx_api.c",
         "deps/lite3/lib/yyjson/yyjson.c",
         "deps/lite3/lib/nibble_base64/base64.c"
@@ -33,6 +47,7 @@
       },
       "defines": [
         "NAPI_VERSION=9",
+        "LITE3_JSON",
         "LITE3_LIB_VERSION=\"1.0.0-<!@(cd deps/lite3 && git rev-parse --short HEAD)<!@(cd deps/lite3 && git diff --quiet || echo -dirty)\""
       ],
       "configurations": {
@@ -45,8 +60,7 @@
           "defines": [
             "DEBUG",
             "LITE3_ERROR_MESSAGES",
-            "LITE3_DEBUG",
-            "LITE3_JSON"
+            "LITE3_DEBUG"
           ]
         },
         "Release": {
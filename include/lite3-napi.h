@@ -1,12 +1,13 @@
 #ifndef LITE3_NAPI_H
 # define LITE3_NAPI_H
 # include <node_api.h>
+# include <lite3_context_api.h>
 
 // Helper macro - check status and throw on error
 # define NAPI_CALL(_env, _ctx, call, failure)                     \
   do {                                                            \
-    napi_status status = (call);                                  \
-    if (status != napi_ok) {                                      \
+    napi_status _status = (call);                                 \
+    if (_status != napi_ok) {                                     \
       const napi_extended_error_info* error_info = NULL;          \
       napi_get_last_error_info((_env), &error_info);              \
       const char* msg = error_info->error_message;                \
@@ -32,15 +33,245 @@
 
 # define a_count(x)  (sizeof(x) / sizeof(*x))
 
+typedef struct lite3_napi_key_cache lite3_napi_key_cache;
+typedef struct lite3_napi_cursor lite3_napi_cursor;
+
+// Work timed by the instrumentation counters (addon_stats.c):
+typedef enum {
+  LITE3_NAPI_PHASE_ENCODE,  // encode walks, bytes = message bytes written
+  LITE3_NAPI_PHASE_DECODE,  // decode calls, bytes = message bytes read
+  LITE3_NAPI_PHASE_PROXY,   // proxy and cursor reads
+  LITE3_NAPI_PHASE_COUNT
+} lite3_napi_phase;
+
+typedef struct {
+  uint64_t calls;
+  uint64_t bytes;
+  uint64_t ns;
+} lite3_napi_phase_stats;
+
+// Instrumentation counters, only updated while `enabled`:
+typedef struct {
+  bool enabled;
+  lite3_napi_phase_stats phases[LITE3_NAPI_PHASE_COUNT];
+  uint64_t contexts;     // lite3 contexts created
+  uint64_t reallocs;     // encode contexts, batch arenas and edited messages that grew
+  uint64_t copies;       // encoded messages copied out of their context, not handed over
+  uint64_t napi_values;  // JS values created by decode and proxy reads
+} lite3_napi_stats;
+
+// Per-environment addon state (one per main thread / worker):
+typedef struct {
+  uint64_t encode_allocations;  // heap allocations made by encode walks
+  lite3_napi_stats stats;
+  lite3_napi_key_cache *key_cache;  // created on first use
+  napi_ref json_replacer;           // encodeAsync() JSON.stringify replacer, once needed
+  napi_ref cursor_constructor;      // Cursor class
+  lite3_napi_cursor *pending_cursor;  // child cursor being constructed
+  napi_ref schema_constructor;        // Schema class
+} lite3_napi_instance;
+
+extern lite3_napi_instance *lite3_napi_get_instance(napi_env);
+
+// Instrumentation (addon_stats.c). `_instance` may be NULL; when stats are
+// disabled each of these costs a single branch on a thread-local flag, and
+// `_instance` is not evaluated.
+# ifdef _MSC_VER
+#  define LITE3_NAPI_THREAD_LOCAL __declspec(thread)
+# else
+#  define LITE3_NAPI_THREAD_LOCAL _Thread_local
+# endif
+
+// Set while an environment on this thread collects stats:
+extern LITE3_NAPI_THREAD_LOCAL bool lite3_napi_stats_thread_on;
+
+# define LITE3_NAPI_STATS_ON(_instance) \
+  (lite3_napi_stats_thread_on && (_instance) && (_instance)->stats.enabled)
+
+# define LITE3_NAPI_STATS_INC(_instance, _field)                 \
+  do {                                                           \
+    if (lite3_napi_stats_thread_on) {                            \
+      lite3_napi_instance *stats_instance = (_instance);         \
+      if (LITE3_NAPI_STATS_ON(stats_instance)) {                 \
+        stats_instance->stats._field++;                          \
+      }                                                          \
+    }                                                            \
+  } while (0)
+
+// Define `_name` as a callback that runs `_callback`, timed as `_phase`:
+# define LITE3_NAPI_TIMED(_name, _callback, _phase)              \
+  napi_value _name(napi_env env, napi_callback_info info) {      \
+    return lite3_napi_timed(env, info, _callback, _phase);       \
+  }
+
+extern uint64_t lite3_napi_stats_clock(void);
+extern void lite3_napi_stats_record(lite3_napi_instance*, lite3_napi_phase, uint64_t, size_t);
+extern napi_value lite3_napi_timed(napi_env, napi_callback_info, napi_callback, lite3_napi_phase);
+extern napi_value get_stats(napi_env, napi_callback_info);
+extern napi_value reset_stats(napi_env, napi_callback_info);
+extern napi_value set_stats_enabled(napi_env, napi_callback_info);
+
+// Look up an optional N-API function exported by the running Node binary:
+extern void *lite3_napi_find_runtime_symbol(const char*);
+
+// Key-name interning cache (addon_keycache.c):
+extern napi_status lite3_napi_key_string(napi_env, lite3_napi_instance*, const char*, size_t, napi_value*);
+extern void lite3_napi_key_cache_free(lite3_napi_key_cache*);
+extern napi_value get_key_cache_stats(napi_env, napi_callback_info);
+
+// Option helpers (addon_options.c):
+extern napi_status lite3_napi_get_option(napi_env, napi_value, const char*, napi_value*, bool*);
+extern napi_status lite3_napi_get_bool_option(napi_env, napi_value, const char*, bool, bool*);
+extern napi_status lite3_napi_get_uint32_option(napi_env, napi_value, const char*, uint32_t, uint32_t*);
+
+// A list of strings read from an option, as null-terminated UTF-8:
+typedef struct {
+  uint32_t count;
+  char **items;
+  char *storage;
+} lite3_napi_string_list;
+
+extern napi_status lite3_napi_get_string_list_option(napi_env, napi_value, const char*, lite3_napi_string_list*, bool*);
+extern void lite3_napi_string_list_free(lite3_napi_string_list*);
+
 // Declarations for project functions:
 extern napi_value encode(napi_env, napi_callback_info);
 extern napi_value decode(napi_env, napi_callback_info);
+extern napi_value encode_into(napi_env, napi_callback_info);
+extern napi_value get_encode_allocations(napi_env, napi_callback_info);
+
+// Decoder state shared by one decode call (addon_decode.c):
+typedef struct {
+  const unsigned char *buf;
+  size_t buflen;
+  lite3_napi_instance *instance;
+  bool typed_arrays;  // homogeneous f64/i64 arrays -> Float64Array/BigInt64Array
+  bool copy_bytes;    // bytes values -> Buffer copies instead of views
+  bool verified;      // source passed verify(): skip per-value bounds checks
+  napi_value source;  // ArrayBuffer backing `buf` for zero-copy bytes views; NULL if shared
+  size_t source_offset;  // offset of `buf` within `source`
+} lite3_napi_decoder;
+
+extern napi_status lite3_napi_decode_value(napi_env, const lite3_napi_decoder*, size_t, napi_value*);
+extern napi_status lite3_napi_create_i64(napi_env, int64_t, napi_value*);
+extern napi_status lite3_napi_decode_bytes(napi_env, const lite3_napi_decoder*, const unsigned char*, size_t, napi_value*);
+extern napi_status lite3_napi_get_message(napi_env, napi_value, const char*, void**, size_t*);
+extern napi_status lite3_napi_decoder_set_source(napi_env, lite3_napi_decoder*, napi_value);
+extern napi_status lite3_napi_create_view(napi_env, napi_value, size_t, size_t, napi_value*);
+extern napi_status lite3_napi_decode_buffer(napi_env, napi_value, napi_value, napi_value*);
+extern void lite3_napi_decode_init(void);
+
+// Encoder internals shared between entry points (addon_encode.c):
+typedef struct {
+  bool integers;  // integral numbers in the safe range -> i64 instead of f64
+} lite3_napi_encode_options;
+
+extern napi_status lite3_napi_get_encode_options(napi_env, napi_value, lite3_napi_encode_options*);
+extern napi_status lite3_napi_encode_root(napi_env, napi_value, lite3_ctx*, const lite3_napi_encode_options*);
+extern napi_status lite3_napi_ctx_to_buffer(napi_env, lite3_ctx*, bool, napi_value*);
+extern napi_status lite3_napi_encode_root_into(napi_env, napi_value, unsigned char*, size_t,
+                                               const lite3_napi_encode_options*, size_t*, bool*);
+extern napi_status lite3_napi_encode_value_at(napi_env, napi_value, unsigned char*, size_t*, size_t,
+                                              size_t, const char*, const lite3_napi_encode_options*, bool*);
+extern napi_status lite3_napi_measure_value(napi_env, napi_value, const lite3_napi_encode_options*, size_t*);
+
+// Compiled record shapes (addon_schema.c). A shape lists the fields of an
+// object and the type each is expected to hold:
+typedef enum {
+  LITE3_NAPI_TYPE_ANY,      // whatever the value is, as encode() would store it
+  LITE3_NAPI_TYPE_STRING,
+  LITE3_NAPI_TYPE_NUMBER,   // f64
+  LITE3_NAPI_TYPE_INTEGER,  // i64 when integral and safe, else f64
+  LITE3_NAPI_TYPE_BIGINT,   // i64
+  LITE3_NAPI_TYPE_BOOLEAN,
+  LITE3_NAPI_TYPE_BYTES,
+  LITE3_NAPI_TYPE_OBJECT,   // nested shape
+  LITE3_NAPI_TYPE_ARRAY,    // elements of one type
+} lite3_napi_type;
+
+typedef struct lite3_napi_shape lite3_napi_shape;
+
+typedef struct lite3_napi_type_spec {
+  lite3_napi_type type;
+  lite3_napi_shape *shape;                // LITE3_NAPI_TYPE_OBJECT
+  struct lite3_napi_type_spec *element;   // LITE3_NAPI_TYPE_ARRAY
+} lite3_napi_type_spec;
+
+typedef struct {
+  char *key;          // UTF-8, null-terminated
+  lite3_napi_type_spec spec;
+} lite3_napi_shape_field;
+
+struct lite3_napi_shape {
+  uint32_t count;
+  lite3_napi_shape_field *fields;
+  napi_ref names;     // JS array of the keys as strings, for property reads and decoded objects
+};
+
+extern napi_status lite3_napi_encode_shape(napi_env, napi_value, const lite3_napi_shape*, lite3_ctx*,
+                                           const lite3_napi_encode_options*);
+extern napi_status lite3_napi_decode_shape(napi_env, napi_value, const lite3_napi_shape*, napi_value*);
+extern napi_status schema_define_class(napi_env, napi_value*);
+extern napi_value compile_schema(napi_env, napi_callback_info);
+
+// In-place edits (addon_mutate.c):
+extern napi_status lite3_napi_edit(napi_env, napi_value, size_t, napi_value, napi_value, napi_value, napi_value*);
+extern napi_value set(napi_env, napi_callback_info);
+extern napi_value arr_append(napi_env, napi_callback_info);
+
+// Asynchronous encode/decode (addon_async.c):
+# define LITE3_NAPI_ASYNC_THRESHOLD (64 * 1024)  // default asyncThreshold, in bytes
+
+extern napi_value encode_async(napi_env, napi_callback_info);
+extern napi_value decode_async(napi_env, napi_callback_info);
+extern void lite3_napi_reject_pending(napi_env, napi_deferred);
+extern void lite3_napi_reject_with_message(napi_env, napi_deferred, const char*);
+extern napi_status lite3_napi_queue_work(napi_env, const char*, napi_async_execute_callback,
+                                         napi_async_complete_callback, void*, napi_async_work*);
+
+// JSON text conversion (addon_json.c):
+extern napi_status lite3_napi_from_json_promise(napi_env, napi_value, napi_value, const char*, napi_value*);
+extern napi_value from_json(napi_env, napi_callback_info);
+extern napi_value to_json(napi_env, napi_callback_info);
+extern napi_value from_json_async(napi_env, napi_callback_info);
+extern napi_value to_json_async(napi_env, napi_callback_info);
+
+// Reusable encoder class (addon_encoder.c):
+extern napi_status encoder_define_class(napi_env, napi_value*);
+
+// Length-prefixed batch encoder class (addon_batch.c):
+# define LITE3_NAPI_FRAME_HEADER_SIZE 4  // u32 little-endian message length
+
+extern napi_status batch_encoder_define_class(napi_env, napi_value*);
+
+// Path-based extraction (addon_path.c):
+extern napi_value compile_path(napi_env, napi_callback_info);
+extern napi_value get_path(napi_env, napi_callback_info);
+extern napi_value project(napi_env, napi_callback_info);
+
+// Structural validation (addon_verify.c):
+extern bool lite3_napi_check_value(const unsigned char*, size_t, size_t);
+extern bool lite3_napi_check_key(const unsigned char*, size_t, const char*);
+extern bool lite3_napi_check_node(const unsigned char*, size_t, size_t, bool);
+extern bool lite3_napi_verify_node(const unsigned char*, size_t, size_t);
+extern napi_status lite3_napi_is_verified(napi_env, napi_value, bool*);
+extern napi_value verify(napi_env, napi_callback_info);
+extern napi_value is_verified(napi_env, napi_callback_info);
+
+// Memory-mapped files (addon_file.c):
+extern const napi_type_tag lite3_napi_mapped_type_tag;
+extern napi_value map_file(napi_env, napi_callback_info);
+
+// Lazy-access cursor class (addon_cursor.c):
+extern napi_status cursor_define_class(napi_env, napi_value*);
 
 // Proxy support functions (addon_proxy.c):
 extern napi_value proxy_get_type(napi_env, napi_callback_info);
 extern napi_value proxy_get_array_type(napi_env, napi_callback_info);
 extern napi_value proxy_get_value(napi_env, napi_callback_info);
 extern napi_value proxy_get_array_element(napi_env, napi_callback_info);
+extern napi_value proxy_get_entry(napi_env, napi_callback_info);
+extern napi_value proxy_get_array_entry(napi_env, napi_callback_info);
 extern napi_value proxy_get_child_offset(napi_env, napi_callback_info);
 extern napi_value proxy_get_array_child_offset(napi_env, napi_callback_info);
 extern napi_value proxy_get_keys(napi_env, napi_callback_info);
@@ -1,6 +1,12 @@
 #include<node_api.h>
 #include<lite3-napi.h>
 #include<lite3_context_api.h>
+#include<stdlib.h>
+#ifdef _WIN32
+#include<windows.h>
+#else
+#include<dlfcn.h>
+#endif
 
 static napi_value Lite3Version(napi_env env, napi_callback_info info) {
   (void)info;  // unused
@@ -10,18 +16,96 @@ static napi_value Lite3Version(napi_env env, napi_callback_info info) {
   return result;
 }
 
+static void FinalizeInstance(napi_env env, void *data, void *hint) {
+  (void)env;   // unused
+  (void)hint;  // unused
+
+  lite3_napi_instance *instance = data;
+  if (instance->stats.enabled) lite3_napi_stats_thread_on = false;
+  lite3_napi_key_cache_free(instance->key_cache);
+  free(instance);
+}
+
+// Returns this environment's addon state, or NULL if it was never set up.
+lite3_napi_instance *lite3_napi_get_instance(napi_env env) {
+  void *data = NULL;
+  if (napi_get_instance_data(env, &data) != napi_ok) return NULL;
+  return data;
+}
+
+// Resolve an N-API function that only newer runtimes provide, so the addon
+// can use it when present without failing to load on older Node versions.
+void *lite3_napi_find_runtime_symbol(const char *name) {
+#ifdef _WIN32
+  return (void *)GetProcAddress(GetModuleHandle(NULL), name);
+#else
+  return dlsym(RTLD_DEFAULT, name);
+#endif
+}
+
 // Module initialization
 static napi_value Init(napi_env env, napi_value exports) {
+  // Per-environment state:
+  lite3_napi_instance *instance = calloc(1, sizeof(*instance));
+  if (!instance) {
+    napi_throw_error(env, NULL, "Memory allocation failure");
+    return NULL;
+  }
+  if (napi_set_instance_data(env, instance, FinalizeInstance, NULL) != napi_ok) {
+    free(instance);
+    napi_throw_error(env, NULL, "Failed to set instance data");
+    return NULL;
+  }
+
+  // Optional runtime features:
+  lite3_napi_decode_init();
+
+  // Classes:
+  napi_value encoder_class;
+  NAPI_CALL(env, NULL, encoder_define_class(env, &encoder_class), NULL);
+  napi_value batch_encoder_class;
+  NAPI_CALL(env, NULL, batch_encoder_define_class(env, &batch_encoder_class), NULL);
+  napi_value cursor_class;
+  NAPI_CALL(env, NULL, cursor_define_class(env, &cursor_class), NULL);
+  napi_value schema_class;
+  NAPI_CALL(env, NULL, schema_define_class(env, &schema_class), NULL);
+
   // Register exported functions here
   napi_property_descriptor props[] = {
     { "lite3Version", NULL, Lite3Version, NULL, NULL, NULL, napi_enumerable, NULL },
     { "encode", NULL, encode, NULL, NULL, NULL, napi_enumerable, NULL },
     { "decode", NULL, decode, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "encodeAsync", NULL, encode_async, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "decodeAsync", NULL, decode_async, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "verify", NULL, verify, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "isVerified", NULL, is_verified, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "fromJSON", NULL, from_json, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "toJSON", NULL, to_json, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "fromJSONAsync", NULL, from_json_async, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "toJSONAsync", NULL, to_json_async, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "encodeInto", NULL, encode_into, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "set", NULL, set, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "arrAppend", NULL, arr_append, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "getEncodeAllocations", NULL, get_encode_allocations, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "getKeyCacheStats", NULL, get_key_cache_stats, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "stats", NULL, get_stats, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "resetStats", NULL, reset_stats, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "setStatsEnabled", NULL, set_stats_enabled, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "Encoder", NULL, NULL, NULL, NULL, encoder_class, napi_enumerable, NULL },
+    { "BatchEncoder", NULL, NULL, NULL, NULL, batch_encoder_class, napi_enumerable, NULL },
+    { "Cursor", NULL, NULL, NULL, NULL, cursor_class, napi_enumerable, NULL },
+    { "compilePath", NULL, compile_path, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "getPath", NULL, get_path, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "project", NULL, project, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "compileSchema", NULL, compile_schema, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "mapFile", NULL, map_file, NULL, NULL, NULL, napi_enumerable, NULL },
     // Proxy support functions:
     { "getType", NULL, proxy_get_type, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getArrayType", NULL, proxy_get_array_type, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getValue", NULL, proxy_get_value, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getArrayElement", NULL, proxy_get_array_element, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "getEntry", NULL, proxy_get_entry, NULL, NULL, NULL, napi_enumerable, NULL },
+    { "getArrayEntry", NULL, proxy_get_array_entry, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getChildOffset", NULL, proxy_get_child_offset, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getArrayChildOffset", NULL, proxy_get_array_child_offset, NULL, NULL, NULL, napi_enumerable, NULL },
     { "getKeys", NULL, proxy_get_keys, NULL, NULL, NULL, napi_enumerable, NULL },
@@ -0,0 +1,368 @@
+/**
+ * Asynchronous encode/decode
+ *
+ * encodeAsync() and decodeAsync() move the lite3 side of a conversion onto
+ * the libuv threadpool. JS values can only be touched on the JS thread, so
+ * JSON text is the bridge:
+ *
+ *   encodeAsync: the value is serialized with JSON.stringify, refusing
+ *                anything but JSON types in the same pass (or passed as
+ *                JSON text already), and parsed into a lite3 message
+ *                off-thread, as by fromJSONAsync() (see addon_json.c).
+ *   decodeAsync: unless the Buffer passed verify(), the message is verified
+ *                off-thread; it is then converted to JSON text there and
+ *                materialized with JSON.parse, which is much cheaper than
+ *                creating the same values one N-API call at a time.
+ *
+ * Inputs smaller than the threshold are converted on the calling thread, as
+ * the threadpool round trip would cost more than it saves.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <lite3_context_api.h>
+#include <math.h>
+#include <stdlib.h>
+
+// Largest integer a double (and so JSON.parse) represents exactly.
+#define MAX_SAFE_INTEGER 9007199254740991LL
+
+typedef struct {
+    napi_async_work work;
+    napi_deferred deferred;
+    napi_ref buffer;        // keeps the message alive while the job runs
+    napi_ref options;       // decode() options, for the fallback path
+    const unsigned char *buf;
+    size_t buflen;
+    size_t offset;
+    bool verified;          // Buffer passed verify(); skip the off-thread walk
+    char *json;             // result; NULL if the message can't go via JSON
+    size_t json_len;
+} decode_job;
+
+// Call JSON.stringify or JSON.parse.
+static napi_status
+call_json(napi_env env, const char *method, size_t argc, const napi_value *argv, napi_value *result) {
+    napi_value global, json, fn;
+    napi_status status = napi_get_global(env, &global);
+    if (status == napi_ok) status = napi_get_named_property(env, global, "JSON", &json);
+    if (status == napi_ok) status = napi_get_named_property(env, json, method, &fn);
+    if (status == napi_ok) status = napi_call_function(env, json, fn, argc, argv, result);
+    return status;
+}
+
+// JSON.stringify() replacer for encodeAsync(): lets through only values that
+// survive JSON.stringify and parsing back the way encode() would store them,
+// i.e. strings, finite numbers, booleans, null, arrays and plain objects.
+// Binary data, BigInts, undefined, functions and symbols would be turned into
+// something else or dropped, and so would anything with a toJSON() method
+// (a Date becomes a string, where encode() stores {}). Written in JS so the
+// check costs no N-API calls; JSON.stringify itself refuses cycles.
+static const char json_replacer_source[] =
+    "(function (key, value) {\n"
+    "  const raw = this[key];\n"
+    "  let what;\n"
+    "  switch (typeof raw) {\n"
+    "    case 'string': case 'boolean': return value;\n"
+    "    case 'number': if (Number.isFinite(raw)) return value; what = 'NaN or Infinity'; break;\n"
+    "    case 'bigint': what = 'BigInts'; break;\n"
+    "    case 'object':\n"
+    "      if (raw === null) return value;\n"
+    "      if (ArrayBuffer.isView(raw) || raw instanceof ArrayBuffer || raw instanceof SharedArrayBuffer) what = 'binary data';\n"
+    "      else if (typeof raw.toJSON === 'function') what = 'objects with a toJSON() method';\n"
+    "      else return value;\n"
+    "      break;\n"
+    "    default: what = 'undefined, functions or symbols';\n"
+    "  }\n"
+    "  throw new TypeError('encodeAsync() only accepts JSON values, not ' + what + '; use encode() instead');\n"
+    "})";
+
+// The replacer above, compiled once per environment.
+static napi_status
+get_json_replacer(napi_env env, lite3_napi_instance *instance, napi_value *result) {
+    napi_status status;
+
+    if (instance && instance->json_replacer) {
+        status = napi_get_reference_value(env, instance->json_replacer, result);
+        if (status == napi_ok && *result) return napi_ok;
+    }
+
+    napi_value source;
+    status = napi_create_string_utf8(env, json_replacer_source, sizeof(json_replacer_source) - 1, &source);
+    if (status != napi_ok) return status;
+    status = napi_run_script(env, source, result);
+    if (status != napi_ok) return status;
+
+    if (instance && !instance->json_replacer) {
+        napi_create_reference(env, *result, 1, &instance->json_replacer);
+    }
+    return napi_ok;
+}
+
+// Reject with the pending exception, or a generic error if there is none.
+void
+lite3_napi_reject_pending(napi_env env, napi_deferred deferred) {
+    napi_value error;
+    bool pending = false;
+    napi_is_exception_pending(env, &pending);
+    if (!pending) napi_throw_error(env, NULL, "N-API error");
+    if (napi_get_and_clear_last_exception(env, &error) == napi_ok) {
+        napi_reject_deferred(env, deferred, error);
+    }
+}
+
+void
+lite3_napi_reject_with_message(napi_env env, napi_deferred deferred, const char *message) {
+    napi_throw_error(env, NULL, message);
+    lite3_napi_reject_pending(env, deferred);
+}
+
+// Return a new promise rejected with the pending exception.
+static napi_value
+rejected_promise(napi_env env) {
+    bool pending = false;
+    napi_is_exception_pending(env, &pending);
+    if (!pending) napi_throw_error(env, NULL, "N-API error");
+
+    napi_value error, promise;
+    napi_deferred deferred;
+    NAPI_CALL(env, NULL, napi_get_and_clear_last_exception(env, &error), NULL);
+    NAPI_CALL(env, NULL, napi_create_promise(env, &deferred, &promise), NULL);
+    NAPI_CALL(env, NULL, napi_reject_deferred(env, deferred, error), NULL);
+    return promise;
+}
+
+// Create and queue async work named `resource`.
+napi_status
+lite3_napi_queue_work(napi_env env, const char *resource, napi_async_execute_callback execute,
+                      napi_async_complete_callback complete, void *data, napi_async_work *work) {
+    napi_value resource_name;
+    napi_status status = napi_create_string_utf8(env, resource, NAPI_AUTO_LENGTH, &resource_name);
+    if (status != napi_ok) return status;
+    status = napi_create_async_work(env, NULL, resource_name, execute, complete, data, work);
+    if (status != napi_ok) return status;
+    status = napi_queue_async_work(env, *work);
+    if (status != napi_ok) napi_delete_async_work(env, *work);
+    return status;
+}
+
+// encodeAsync() proper. Errors are thrown, for the caller to turn into a
+// rejected promise.
+static napi_status
+encode_async_promise(napi_env env, size_t argc, napi_value *argv, napi_value *promise) {
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return napi_invalid_arg;
+    }
+    napi_value options = argc > 1 ? argv[1] : NULL;
+
+    // Get the JSON text, serializing objects on this thread:
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, argv[0], &type);
+    if (status != napi_ok) return status;
+    napi_value text = argv[0];
+    if (type == napi_object) {
+        napi_value args[2] = { argv[0] };
+        status = get_json_replacer(env, lite3_napi_get_instance(env), &args[1]);
+        if (status == napi_ok) status = call_json(env, "stringify", 2, args, &text);
+        if (status == napi_ok) status = napi_typeof(env, text, &type);
+        if (status != napi_ok) return status;
+    } else if (type != napi_string) {
+        napi_throw_type_error(env, NULL, "Argument must be an array, object or JSON string");
+        return napi_invalid_arg;
+    }
+    if (type != napi_string) {
+        napi_throw_type_error(env, NULL, "Argument cannot be serialized as JSON");
+        return napi_invalid_arg;
+    }
+
+    return lite3_napi_from_json_promise(env, text, options, "lite3.encodeAsync", promise);
+}
+
+/**
+ * encodeAsync(value, options?) -> Promise<Buffer>
+ *   value                  - an object or array, serialized with JSON.stringify,
+ *                            or a string of JSON text
+ *   options.zeroCopy       - as for encode() (default: true)
+ *   options.asyncThreshold - JSON text shorter than this many bytes is
+ *                            converted on the calling thread (default: 65536)
+ * Numbers written as integers in the JSON are stored as i64. Values JSON
+ * would change (binary data, BigInts, undefined, NaN, objects with a toJSON()
+ * method) and cyclic values reject the promise with a TypeError, as does any
+ * other invalid argument.
+ */
+napi_value
+encode_async(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+
+    napi_value promise;
+    if (encode_async_promise(env, argc, argv, &promise) != napi_ok) return rejected_promise(env);
+    return promise;
+}
+
+// True if the node at `offset` survives conversion to JSON and back exactly:
+// no bytes, no non-finite floats and no integers JSON.parse would round.
+// Safe to run off-thread.
+static bool
+json_safe(const unsigned char *buf, size_t buflen, size_t offset) {
+    lite3_iter iter;
+    if (lite3_iter_create(buf, buflen, offset, &iter) != 0) return false;
+
+    size_t val_offset;
+    while (lite3_iter_next(buf, buflen, &iter, NULL, &val_offset) == LITE3_ITER_ITEM) {
+        lite3_val *val = (lite3_val *)(buf + val_offset);
+        switch (lite3_val_type(val)) {
+            case LITE3_TYPE_NULL:
+            case LITE3_TYPE_BOOL:
+            case LITE3_TYPE_STRING:
+                break;
+            case LITE3_TYPE_I64: {
+                int64_t v = lite3_val_i64(val);
+                if (v > MAX_SAFE_INTEGER || v < -MAX_SAFE_INTEGER) return false;
+                break;
+            }
+            case LITE3_TYPE_F64:
+                if (!isfinite(lite3_val_f64(val))) return false;
+                break;
+            case LITE3_TYPE_OBJECT:
+            case LITE3_TYPE_ARRAY:
+                if (!json_safe(buf, buflen, val_offset)) return false;
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+static void
+decode_execute(napi_env env, void *data) {
+    (void)env;
+
+    decode_job *job = data;
+    if ((job->verified || lite3_napi_verify_node(job->buf, job->buflen, job->offset))
+        && json_safe(job->buf, job->buflen, job->offset)) {
+        job->json = lite3_json_enc(job->buf, job->buflen, job->offset, &job->json_len);
+    }
+}
+
+static void
+decode_complete(napi_env env, napi_status status, void *data) {
+    decode_job *job = data;
+    napi_value result;
+
+    if (status != napi_ok) {
+        lite3_napi_reject_with_message(env, job->deferred, "Operation cancelled");
+    } else {
+        if (job->json) {
+            napi_value text;
+            status = napi_create_string_utf8(env, job->json, job->json_len, &text);
+            if (status == napi_ok) status = call_json(env, "parse", 1, &text, &result);
+        } else {
+            // Not representable as JSON (or not a valid message): decode on
+            // this thread, which also reports any error.
+            napi_value buffer, options = NULL;
+            status = napi_get_reference_value(env, job->buffer, &buffer);
+            if (status == napi_ok && job->options) status = napi_get_reference_value(env, job->options, &options);
+            if (status == napi_ok) status = lite3_napi_decode_buffer(env, buffer, options, &result);
+        }
+
+        if (status == napi_ok) {
+            napi_resolve_deferred(env, job->deferred, result);
+        } else {
+            lite3_napi_reject_pending(env, job->deferred);
+        }
+    }
+
+    napi_delete_reference(env, job->buffer);
+    if (job->options) napi_delete_reference(env, job->options);
+    napi_delete_async_work(env, job->work);
+    free(job->json);
+    free(job);
+}
+
+/**
+ * decodeAsync(buffer, options?) -> Promise<any>
+ *   options.asyncThreshold - messages smaller than this many bytes are
+ *                            decoded on the calling thread (default: 65536)
+ *   other options          - as for decode()
+ * The buffer must not be modified until the promise settles. Messages with
+ * values JSON cannot represent exactly (bytes, integers beyond
+ * Number.MAX_SAFE_INTEGER, NaN/Infinity), and the typedArrays, pick and omit
+ * options, use the decode() path on the calling thread.
+ */
+napi_value
+decode_async(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return NULL;
+    }
+    napi_value options = argc > 1 ? argv[1] : NULL;
+
+    void *buffer;
+    size_t buffer_length;
+    NAPI_CALL(env, NULL, lite3_napi_get_message(env, argv[0], "Argument must be a Buffer or Uint8Array",
+                                                &buffer, &buffer_length), NULL);
+
+    uint32_t threshold, offset;
+    bool verified, typed_arrays, has_pick, has_omit;
+    napi_value unused;
+    NAPI_CALL(env, NULL, lite3_napi_get_uint32_option(env, options, "asyncThreshold", LITE3_NAPI_ASYNC_THRESHOLD, &threshold), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_get_uint32_option(env, options, "offset", 0, &offset), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_get_bool_option(env, options, "typedArrays", false, &typed_arrays), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_get_option(env, options, "pick", &unused, &has_pick), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_get_option(env, options, "omit", &unused, &has_omit), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_is_verified(env, argv[0], &verified), NULL);
+
+    napi_value promise;
+    napi_deferred deferred;
+    NAPI_CALL(env, NULL, napi_create_promise(env, &deferred, &promise), NULL);
+
+    // Small messages, invalid offsets and options JSON can't honour: decode
+    // right here.
+    if (buffer_length < threshold || typed_arrays || has_pick || has_omit
+        || (offset != 0 && !lite3_napi_check_node(buffer, buffer_length, offset, verified))) {
+        napi_value result;
+        if (lite3_napi_decode_buffer(env, argv[0], options, &result) == napi_ok) {
+            napi_resolve_deferred(env, deferred, result);
+        } else {
+            lite3_napi_reject_pending(env, deferred);
+        }
+        return promise;
+    }
+
+    decode_job *job = calloc(1, sizeof(*job));
+    if (!job) {
+        lite3_napi_reject_with_message(env, deferred, "Memory allocation failure");
+        return promise;
+    }
+    job->deferred = deferred;
+    job->buf = buffer;
+    job->buflen = buffer_length;
+    job->offset = offset;
+    job->verified = verified;
+
+    // Options are only needed again if the message turns out not to be
+    // representable as JSON (null/undefined options need no reference):
+    napi_valuetype options_type = napi_undefined;
+    if (options) NAPI_CALL(env, NULL, napi_typeof(env, options, &options_type), NULL);
+
+    napi_status status = napi_create_reference(env, argv[0], 1, &job->buffer);
+    if (status == napi_ok && options_type == napi_object) status = napi_create_reference(env, options, 1, &job->options);
+    if (status == napi_ok) {
+        status = lite3_napi_queue_work(env, "lite3.decodeAsync", decode_execute, decode_complete, job, &job->work);
+    }
+    if (status != napi_ok) {
+        if (job->buffer) napi_delete_reference(env, job->buffer);
+        if (job->options) napi_delete_reference(env, job->options);
+        free(job);
+        lite3_napi_reject_pending(env, deferred);
+    }
+    return promise;
+}
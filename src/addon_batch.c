@@ -0,0 +1,306 @@
+/**
+ * Batch Encoder
+ *
+ * A native class that encodes many messages back to back into one arena, so
+ * a batch of small records becomes a single Buffer without a Buffer per
+ * record and a Buffer.concat(). Each message is written straight into the
+ * arena through lite3's buffer API, behind a frame header holding its length
+ * as a u32 little-endian:
+ *
+ *   [len][message][len][message]...
+ *
+ * finish() hands the arena to the returned Buffer when that avoids a copy,
+ * and the encoder starts a new arena for the next batch. BatchDecoder (in
+ * batch.ts) reads the frames back as zero-copy slices.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Default arena size when none is configured.
+#define BATCH_DEFAULT_CAPACITY (64 * 1024)
+
+// Smallest arena we will allocate, regardless of configuration.
+#define BATCH_MIN_CAPACITY 1024
+
+// Below this size a copy is cheaper than registering an external Buffer.
+#define BATCH_ZERO_COPY_MIN_LENGTH 4096
+
+typedef struct {
+    unsigned char *arena;   // NULL once handed to a Buffer, until the next add()
+    size_t length;          // bytes of complete frames
+    size_t capacity;
+    uint32_t count;         // frames in the current batch
+    size_t initial_capacity;
+    lite3_napi_encode_options options;
+    bool busy;              // add() is walking a value, whose getters may call back in
+} lite3_napi_batch_encoder;
+
+static void
+batch_encoder_finalize(napi_env env, void *data, void *hint) {
+    (void)env;
+    (void)hint;
+
+    lite3_napi_batch_encoder *enc = data;
+    free(enc->arena);
+    free(enc);
+}
+
+// Finalizer for Buffers that took over an arena; `hint` is its capacity.
+static void
+finalize_arena(napi_env env, void *data, void *hint) {
+    int64_t adjusted;
+    napi_adjust_external_memory(env, -(int64_t)(uintptr_t)hint, &adjusted);
+    free(data);
+}
+
+// Make sure at least `needed` bytes are free past the complete frames.
+static bool
+batch_reserve(lite3_napi_batch_encoder *enc, size_t needed) {
+    if (enc->arena && enc->capacity - enc->length >= needed) return true;
+
+    size_t capacity = enc->arena ? enc->capacity * 2 : enc->initial_capacity;
+    while (capacity - enc->length < needed) capacity *= 2;
+
+    unsigned char *arena = realloc(enc->arena, capacity);
+    if (!arena) return false;
+    enc->arena = arena;
+    enc->capacity = capacity;
+    return true;
+}
+
+static lite3_napi_batch_encoder *
+unwrap_batch_encoder(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv) {
+    napi_value this_arg;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, argc, argv, &this_arg, NULL), NULL);
+
+    lite3_napi_batch_encoder *enc;
+    NAPI_CALL(env, NULL, napi_unwrap(env, this_arg, (void **)&enc), NULL);
+    return enc;
+}
+
+// Throw if the encoder is in the middle of add(). A getter on the value being
+// added could otherwise move or free the arena under the walk.
+static bool
+batch_encoder_check_idle(napi_env env, const lite3_napi_batch_encoder *enc) {
+    if (!enc->busy) return true;
+    napi_throw_error(env, NULL, "BatchEncoder cannot be used while it is encoding");
+    return false;
+}
+
+/**
+ * new BatchEncoder(options?)
+ *   options.initialCapacity - arena bytes to allocate per batch (default: 65536)
+ *   options.integers        - as for encode() (default: false)
+ */
+static napi_value
+batch_encoder_constructor(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_value this_arg;
+    napi_value new_target;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, &this_arg, NULL), NULL);
+    NAPI_CALL(env, NULL, napi_get_new_target(env, info, &new_target), NULL);
+    if (new_target == NULL) {
+        napi_throw_type_error(env, NULL, "BatchEncoder must be called with new");
+        return NULL;
+    }
+
+    uint32_t initial_capacity;
+    NAPI_CALL(env, NULL, lite3_napi_get_uint32_option(env, argc > 0 ? argv[0] : NULL, "initialCapacity",
+                                                      BATCH_DEFAULT_CAPACITY, &initial_capacity), NULL);
+
+    lite3_napi_encode_options options;
+    NAPI_CALL(env, NULL, lite3_napi_get_encode_options(env, argc > 0 ? argv[0] : NULL, &options), NULL);
+
+    lite3_napi_batch_encoder *enc = calloc(1, sizeof(*enc));
+    if (!enc) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return NULL;
+    }
+    enc->options = options;
+    enc->initial_capacity = initial_capacity < BATCH_MIN_CAPACITY ? BATCH_MIN_CAPACITY : initial_capacity;
+
+    napi_status status = napi_wrap(env, this_arg, enc, batch_encoder_finalize, NULL, NULL);
+    if (status != napi_ok) {
+        batch_encoder_finalize(env, enc, NULL);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    return this_arg;
+}
+
+/**
+ * batchEncoder.add(value) -> number
+ * Encodes an object or array as the next frame of the batch. Returns the
+ * number of frames in the batch.
+ */
+static napi_value
+batch_encoder_add(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_batch_encoder *enc = unwrap_batch_encoder(env, info, &argc, argv);
+    if (!enc || !batch_encoder_check_idle(env, enc)) return NULL;
+
+    if (argc != 1) {
+        napi_throw_type_error(env, NULL, "Expected one argument");
+        return NULL;
+    }
+
+    napi_valuetype type;
+    NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    if (type != napi_object) {
+        napi_throw_type_error(env, NULL, "Argument must be an array or object");
+        return NULL;
+    }
+
+    // Encode behind the frame header, doubling the arena until it fits. A
+    // message that doesn't fit is simply encoded again; nothing before it is
+    // touched.
+    size_t needed = LITE3_NAPI_FRAME_HEADER_SIZE + BATCH_MIN_CAPACITY;
+    size_t written;
+    for (;;) {
+        size_t capacity = enc->arena ? enc->capacity : 0;
+        if (!batch_reserve(enc, needed)) {
+            napi_throw_error(env, NULL, "Memory allocation failure");
+            return NULL;
+        }
+        if (capacity && enc->capacity != capacity) {
+            LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), reallocs);
+        }
+
+        unsigned char *frame = enc->arena + enc->length;
+        size_t available = enc->capacity - enc->length;
+        bool overflow;
+        enc->busy = true;
+        napi_status status = lite3_napi_encode_root_into(env, argv[0], frame + LITE3_NAPI_FRAME_HEADER_SIZE,
+                                                         available - LITE3_NAPI_FRAME_HEADER_SIZE,
+                                                         &enc->options, &written, &overflow);
+        enc->busy = false;
+        if (status == napi_ok) break;
+        if (!overflow) {
+            NAPI_CALL(env, NULL, status, NULL);
+        }
+        needed = available * 2;
+    }
+
+    if (written > UINT32_MAX) {
+        napi_throw_range_error(env, NULL, "Message is too large for a frame");
+        return NULL;
+    }
+
+    unsigned char *header = enc->arena + enc->length;
+    header[0] = (unsigned char)written;
+    header[1] = (unsigned char)(written >> 8);
+    header[2] = (unsigned char)(written >> 16);
+    header[3] = (unsigned char)(written >> 24);
+    enc->length += LITE3_NAPI_FRAME_HEADER_SIZE + written;
+    enc->count++;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_uint32(env, enc->count, &result), NULL);
+    return result;
+}
+
+/**
+ * batchEncoder.finish() -> Buffer
+ * Returns the frames added since the last finish() as one Buffer and starts
+ * a new batch.
+ */
+static napi_value
+batch_encoder_finish(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_batch_encoder *enc = unwrap_batch_encoder(env, info, &argc, NULL);
+    if (!enc || !batch_encoder_check_idle(env, enc)) return NULL;
+
+    napi_value result;
+    napi_status status = napi_generic_failure;
+
+    // Hand over the arena when it is large and mostly used:
+    if (enc->length >= BATCH_ZERO_COPY_MIN_LENGTH && enc->capacity - enc->length <= enc->length) {
+        status = napi_create_external_buffer(env, enc->length, enc->arena, finalize_arena,
+                                             (void *)(uintptr_t)enc->capacity, &result);
+        if (status == napi_ok) {
+            int64_t adjusted;
+            napi_adjust_external_memory(env, (int64_t)enc->capacity, &adjusted);
+            enc->arena = NULL;
+            enc->capacity = 0;
+        }
+        // Runtimes may refuse external buffers (napi_no_external_buffers_allowed);
+        // fall through and copy instead.
+    }
+    if (status != napi_ok) {
+        NAPI_CALL(env, NULL, napi_create_buffer_copy(env, enc->length, enc->arena, NULL, &result), NULL);
+    }
+
+    enc->length = 0;
+    enc->count = 0;
+    return result;
+}
+
+/**
+ * batchEncoder.reset() -> undefined
+ * Discards the frames added since the last finish(), and releases an arena
+ * that has grown past the initial capacity.
+ */
+static napi_value
+batch_encoder_reset(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_batch_encoder *enc = unwrap_batch_encoder(env, info, &argc, NULL);
+    if (!enc || !batch_encoder_check_idle(env, enc)) return NULL;
+
+    enc->length = 0;
+    enc->count = 0;
+    if (enc->capacity > enc->initial_capacity) {
+        free(enc->arena);
+        enc->arena = NULL;
+        enc->capacity = 0;
+    }
+    return NULL;
+}
+
+/**
+ * batchEncoder.count -> number
+ * Frames added since the last finish().
+ */
+static napi_value
+batch_encoder_get_count(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_batch_encoder *enc = unwrap_batch_encoder(env, info, &argc, NULL);
+    if (!enc) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_uint32(env, enc->count, &result), NULL);
+    return result;
+}
+
+/**
+ * batchEncoder.length -> number
+ * Bytes the next finish() will return, frame headers included.
+ */
+static napi_value
+batch_encoder_get_length(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_batch_encoder *enc = unwrap_batch_encoder(env, info, &argc, NULL);
+    if (!enc) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_double(env, (double)enc->length, &result), NULL);
+    return result;
+}
+
+napi_status
+batch_encoder_define_class(napi_env env, napi_value *result) {
+    napi_property_descriptor props[] = {
+        { "add", NULL, batch_encoder_add, NULL, NULL, NULL, napi_default_method, NULL },
+        { "finish", NULL, batch_encoder_finish, NULL, NULL, NULL, napi_default_method, NULL },
+        { "reset", NULL, batch_encoder_reset, NULL, NULL, NULL, napi_default_method, NULL },
+        { "count", NULL, NULL, batch_encoder_get_count, NULL, NULL, napi_default, NULL },
+        { "length", NULL, NULL, batch_encoder_get_length, NULL, NULL, napi_default, NULL }
+    };
+
+    return napi_define_class(env, "BatchEncoder", NAPI_AUTO_LENGTH, batch_encoder_constructor, NULL,
+                             a_count(props), props, result);
+}
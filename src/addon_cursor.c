@@ -0,0 +1,729 @@
+/**
+ * Cursor
+ *
+ * A native class pointing at one object or array inside a Lite3 Buffer. The
+ * lazy Lite3Buffer proxies keep their position in a cursor instead of in JS
+ * closures, and read through it.
+ *
+ * All cursors into the same Buffer share one document: a strong reference to
+ * the Buffer, plus a table from offset to cursor so each nested node has at
+ * most one live cursor. Table entries are weak references, so they never keep
+ * a cursor alive. A cursor removes its own entry when it is collected, and
+ * the document is freed along with its last cursor. Native overhead is one
+ * small struct per live cursor plus the table, and is reported by `stats`.
+ *
+ * Edits through a cursor go through lite3_napi_edit(). When an edit returns
+ * a new Buffer, the document switches to it, so every cursor sees the edit.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initial number of table slots; must be a power of two.
+#define CURSOR_TABLE_INITIAL_SIZE 16
+
+typedef struct {
+    size_t offset;
+    napi_ref cursor;        // weak; NULL for an empty slot
+} cursor_slot;
+
+typedef struct {
+    napi_ref buffer;        // strong reference to the Buffer
+    bool verified;          // Buffer passed verify(); skip per-value checks
+    uint32_t cursors;       // live cursors sharing this document
+    uint64_t hits;
+    uint64_t misses;
+
+    // Open-addressed (linear probing) table of cursors by offset:
+    cursor_slot *slots;
+    size_t capacity;
+    size_t entries;
+} cursor_document;
+
+struct lite3_napi_cursor {
+    cursor_document *doc;
+    size_t offset;
+    enum lite3_type type;   // LITE3_TYPE_OBJECT or LITE3_TYPE_ARRAY
+    uint32_t count;         // number of properties or elements
+    napi_ref self;          // weak reference from napi_wrap
+};
+
+static size_t
+table_home(const cursor_document *doc, size_t offset) {
+    return (size_t)(((uint64_t)offset * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (doc->capacity - 1);
+}
+
+// Index of the slot holding `offset`, or of the empty slot it would go in.
+static size_t
+table_find(const cursor_document *doc, size_t offset) {
+    size_t i = table_home(doc, offset);
+    while (doc->slots[i].cursor && doc->slots[i].offset != offset) {
+        i = (i + 1) & (doc->capacity - 1);
+    }
+    return i;
+}
+
+static bool
+table_grow(cursor_document *doc) {
+    size_t old_capacity = doc->capacity;
+    cursor_slot *old_slots = doc->slots;
+
+    size_t capacity = old_capacity ? old_capacity * 2 : CURSOR_TABLE_INITIAL_SIZE;
+    cursor_slot *slots = calloc(capacity, sizeof(*slots));
+    if (!slots) return false;
+
+    doc->slots = slots;
+    doc->capacity = capacity;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_slots[i].cursor) {
+            doc->slots[table_find(doc, old_slots[i].offset)] = old_slots[i];
+        }
+    }
+    free(old_slots);
+    return true;
+}
+
+// Point the slot for `offset` at `cursor`. Replacing an existing entry is
+// fine: every cursor owns (and later deletes) its own reference.
+static bool
+table_put(cursor_document *doc, size_t offset, napi_ref cursor) {
+    if ((doc->entries + 1) * 2 > doc->capacity && !table_grow(doc)) return false;
+
+    size_t i = table_find(doc, offset);
+    if (!doc->slots[i].cursor) doc->entries++;
+    doc->slots[i].offset = offset;
+    doc->slots[i].cursor = cursor;
+    return true;
+}
+
+// Empty slot `i`, shifting later entries of the probe run back so lookups
+// never stop early at the hole.
+static void
+table_remove(cursor_document *doc, size_t i) {
+    size_t mask = doc->capacity - 1;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!doc->slots[j].cursor) break;
+
+        size_t home = table_home(doc, doc->slots[j].offset);
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+
+        doc->slots[i] = doc->slots[j];
+        i = j;
+    }
+    doc->slots[i].cursor = NULL;
+    doc->entries--;
+}
+
+static void
+document_release(napi_env env, cursor_document *doc) {
+    if (--doc->cursors > 0) return;
+    napi_delete_reference(env, doc->buffer);
+    free(doc->slots);
+    free(doc);
+}
+
+static void
+cursor_finalize(napi_env env, void *data, void *hint) {
+    (void)hint;
+
+    lite3_napi_cursor *cursor = data;
+    cursor_document *doc = cursor->doc;
+
+    if (doc->capacity) {
+        size_t i = table_find(doc, cursor->offset);
+        if (doc->slots[i].cursor == cursor->self) table_remove(doc, i);
+    }
+    if (cursor->self) napi_delete_reference(env, cursor->self);
+
+    document_release(env, doc);
+    free(cursor);
+}
+
+// Fill in the type and count of the node at `cursor->offset`.
+static bool
+cursor_inspect(lite3_napi_cursor *cursor, const unsigned char *buf, size_t buflen) {
+    if (cursor->offset >= buflen) return false;
+
+    cursor->type = lite3_val_type((lite3_val *)(buf + cursor->offset));
+    if (cursor->type != LITE3_TYPE_OBJECT && cursor->type != LITE3_TYPE_ARRAY) return false;
+
+    return lite3_count(buf, buflen, cursor->offset, &cursor->count) >= 0;
+}
+
+// Wrap `cursor` in the JS object being constructed and register it with its
+// document. On failure the cursor is freed.
+static napi_status
+cursor_attach(napi_env env, napi_value this_arg, lite3_napi_cursor *cursor) {
+    cursor->doc->cursors++;
+
+    napi_status status = napi_wrap(env, this_arg, cursor, cursor_finalize, NULL, &cursor->self);
+    if (status != napi_ok) {
+        cursor->self = NULL;
+        cursor_finalize(env, cursor, NULL);
+        return status;
+    }
+
+    if (!table_put(cursor->doc, cursor->offset, cursor->self)) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+    return napi_ok;
+}
+
+static lite3_napi_cursor *
+unwrap_cursor(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv) {
+    napi_value this_arg;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, argc, argv, &this_arg, NULL), NULL);
+
+    lite3_napi_cursor *cursor;
+    NAPI_CALL(env, NULL, napi_unwrap(env, this_arg, (void **)&cursor), NULL);
+    return cursor;
+}
+
+// Resolve the document's Buffer and its memory.
+static napi_status
+cursor_buffer(napi_env env, const lite3_napi_cursor *cursor, napi_value *buffer, void **buf, size_t *buflen) {
+    napi_status status = napi_get_reference_value(env, cursor->doc->buffer, buffer);
+    if (status != napi_ok) return status;
+    return napi_get_typedarray_info(env, *buffer, NULL, buflen, buf, NULL, NULL);
+}
+
+/**
+ * new Cursor(buffer, offset?)
+ * Creates a cursor at the root of a Lite3 Buffer or Uint8Array, or at the
+ * object or array `offset` bytes into it (a cursor's `offset`, e.g. one read
+ * in another thread). Cursors for nested nodes are otherwise only created by
+ * get(), at() and values().
+ */
+static napi_value
+cursor_constructor(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_value this_arg;
+    napi_value new_target;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, &this_arg, NULL), NULL);
+    NAPI_CALL(env, NULL, napi_get_new_target(env, info, &new_target), NULL);
+    if (new_target == NULL) {
+        napi_throw_type_error(env, NULL, "Cursor must be called with new");
+        return NULL;
+    }
+
+    // A child cursor handed over by cursor_child():
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    if (argc == 0 && instance && instance->pending_cursor) {
+        lite3_napi_cursor *cursor = instance->pending_cursor;
+        instance->pending_cursor = NULL;
+        NAPI_CALL(env, NULL, cursor_attach(env, this_arg, cursor), NULL);
+        return this_arg;
+    }
+
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Argument must be a Buffer or Uint8Array");
+        return NULL;
+    }
+
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, lite3_napi_get_message(env, argv[0], "Argument must be a Buffer or Uint8Array",
+                                                &buf, &buflen), NULL);
+
+    int64_t offset = 0;
+    napi_valuetype offset_type = napi_undefined;
+    if (argc > 1) NAPI_CALL(env, NULL, napi_typeof(env, argv[1], &offset_type), NULL);
+    if (offset_type != napi_undefined) {
+        NAPI_CALL(env, NULL, napi_get_value_int64(env, argv[1], &offset), NULL);
+        if (offset < 0) {
+            napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+            return NULL;
+        }
+    }
+
+    cursor_document *doc = calloc(1, sizeof(*doc));
+    lite3_napi_cursor *cursor = calloc(1, sizeof(*cursor));
+    if (!doc || !cursor) {
+        free(doc);
+        free(cursor);
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return NULL;
+    }
+    cursor->doc = doc;
+    cursor->offset = (size_t)offset;
+
+    napi_status status = lite3_napi_is_verified(env, argv[0], &doc->verified);
+    if (status != napi_ok) {
+        free(doc);
+        free(cursor);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    // An offset handed in from outside must be a real node of a verified
+    // message, whose reads skip their bounds checks:
+    if (!cursor_inspect(cursor, buf, buflen)
+        || (offset != 0 && !lite3_napi_check_node(buf, buflen, cursor->offset, doc->verified))) {
+        free(doc);
+        free(cursor);
+        napi_throw_type_error(env, NULL, "Buffer does not hold a Lite3 object or array");
+        return NULL;
+    }
+
+    status = napi_create_reference(env, argv[0], 1, &doc->buffer);
+    if (status != napi_ok) {
+        free(doc);
+        free(cursor);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    NAPI_CALL(env, NULL, cursor_attach(env, this_arg, cursor), NULL);
+    return this_arg;
+}
+
+// Return the cursor for the node at `offset` in `parent`'s document, reusing
+// the live one if there is one.
+static napi_status
+cursor_child(napi_env env, const lite3_napi_cursor *parent, const unsigned char *buf, size_t buflen,
+             size_t offset, napi_value *result) {
+    cursor_document *doc = parent->doc;
+
+    if (doc->capacity) {
+        size_t i = table_find(doc, offset);
+        if (doc->slots[i].cursor) {
+            napi_status status = napi_get_reference_value(env, doc->slots[i].cursor, result);
+            if (status != napi_ok) return status;
+            if (*result) {
+                doc->hits++;
+                return napi_ok;
+            }
+            // Collected but not yet finalized; replaced below.
+        }
+    }
+    doc->misses++;
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    napi_value constructor;
+    napi_status status = napi_get_reference_value(env, instance->cursor_constructor, &constructor);
+    if (status != napi_ok) return status;
+
+    lite3_napi_cursor *cursor = calloc(1, sizeof(*cursor));
+    if (!cursor) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+    cursor->doc = doc;
+    cursor->offset = offset;
+    if (!cursor_inspect(cursor, buf, buflen)) {
+        free(cursor);
+        napi_throw_error(env, NULL, "Invalid nested value in Lite3 buffer");
+        return napi_generic_failure;
+    }
+
+    instance->pending_cursor = cursor;
+    status = napi_new_instance(env, constructor, 0, NULL, result);
+    if (instance->pending_cursor) {
+        // The constructor never ran
+        instance->pending_cursor = NULL;
+        free(cursor);
+    }
+    return status;
+}
+
+// Convert the value at `val_offset` to JS: primitives decoded, bytes as a
+// view into the Buffer, objects and arrays as cursors. Values in unverified
+// Buffers are bounds-checked first.
+static napi_status
+cursor_value(napi_env env, const lite3_napi_cursor *cursor, napi_value buffer, const unsigned char *buf,
+             size_t buflen, size_t val_offset, napi_value *result) {
+    switch (lite3_val_type((lite3_val *)(buf + val_offset))) {
+        case LITE3_TYPE_OBJECT:
+        case LITE3_TYPE_ARRAY:
+            return cursor_child(env, cursor, buf, buflen, val_offset, result);
+
+        default: {
+            if (!cursor->doc->verified && !lite3_napi_check_value(buf, buflen, val_offset)) {
+                napi_throw_error(env, NULL, "Malformed Lite3 buffer");
+                return napi_invalid_arg;
+            }
+            lite3_napi_decoder dec = {
+                .buf = buf,
+                .buflen = buflen,
+                .instance = lite3_napi_get_instance(env),
+                .verified = cursor->doc->verified,
+            };
+            napi_status status = lite3_napi_decoder_set_source(env, &dec, buffer);
+            if (status != napi_ok) return status;
+            return lite3_napi_decode_value(env, &dec, val_offset, result);
+        }
+    }
+}
+
+/**
+ * cursor.get(key) -> any
+ * Returns the property's value, a Cursor for a nested object or array, or
+ * undefined if absent (or if the cursor is on an array).
+ */
+static napi_value
+cursor_get(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, argv);
+    if (!cursor) return NULL;
+
+    char key[256];
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1 argument: key");
+        return NULL;
+    }
+    NAPI_CALL(env, NULL, napi_get_value_string_utf8(env, argv[0], key, sizeof(key), NULL), NULL);
+
+    napi_value buffer, result;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, cursor_buffer(env, cursor, &buffer, &buf, &buflen), NULL);
+
+    lite3_val *val;
+    if (cursor->type != LITE3_TYPE_OBJECT || lite3_get(buf, buflen, cursor->offset, key, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
+    }
+
+    size_t val_offset = (size_t)((unsigned char *)val - (unsigned char *)buf);
+    NAPI_CALL(env, NULL, cursor_value(env, cursor, buffer, buf, buflen, val_offset, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.at(index) -> any
+ * Array counterpart of get().
+ */
+static napi_value
+cursor_at(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, argv);
+    if (!cursor) return NULL;
+
+    uint32_t index;
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1 argument: index");
+        return NULL;
+    }
+    NAPI_CALL(env, NULL, napi_get_value_uint32(env, argv[0], &index), NULL);
+
+    napi_value buffer, result;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, cursor_buffer(env, cursor, &buffer, &buf, &buflen), NULL);
+
+    lite3_val *val;
+    if (cursor->type != LITE3_TYPE_ARRAY || index >= cursor->count
+        || lite3_arr_get(buf, buflen, cursor->offset, index, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
+    }
+
+    size_t val_offset = (size_t)((unsigned char *)val - (unsigned char *)buf);
+    NAPI_CALL(env, NULL, cursor_value(env, cursor, buffer, buf, buflen, val_offset, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.has(key) -> boolean
+ */
+static napi_value
+cursor_has(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, argv);
+    if (!cursor) return NULL;
+
+    char key[256];
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1 argument: key");
+        return NULL;
+    }
+    NAPI_CALL(env, NULL, napi_get_value_string_utf8(env, argv[0], key, sizeof(key), NULL), NULL);
+
+    napi_value buffer, result;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, cursor_buffer(env, cursor, &buffer, &buf, &buflen), NULL);
+
+    bool exists = cursor->type == LITE3_TYPE_OBJECT
+        && lite3_get_type(buf, buflen, cursor->offset, key) != LITE3_TYPE_INVALID;
+    NAPI_CALL(env, NULL, napi_get_boolean(env, exists, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.keys() -> string[]
+ * Property names of an object cursor (empty for arrays).
+ */
+static napi_value
+cursor_keys(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value buffer, result;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, cursor_buffer(env, cursor, &buffer, &buf, &buflen), NULL);
+
+    uint32_t count = cursor->type == LITE3_TYPE_OBJECT ? cursor->count : 0;
+    NAPI_CALL(env, NULL, napi_create_array_with_length(env, count, &result), NULL);
+    if (count == 0) return result;
+
+    lite3_iter iter;
+    if (lite3_iter_create(buf, buflen, cursor->offset, &iter) != 0) {
+        napi_throw_error(env, NULL, "Failed to create iterator");
+        return NULL;
+    }
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    uint32_t i = 0;
+    lite3_str key;
+    size_t val_ofs;
+    while (i < count && lite3_iter_next(buf, buflen, &iter, &key, &val_ofs) == LITE3_ITER_ITEM) {
+        if (!cursor->doc->verified && !lite3_napi_check_key(buf, buflen, key.ptr)) {
+            napi_throw_error(env, NULL, "Malformed Lite3 buffer");
+            return NULL;
+        }
+        napi_value key_str;
+        // Use strlen() as lite3_str.len may include extra data beyond the null terminator
+        NAPI_CALL(env, NULL, lite3_napi_key_string(env, instance, key.ptr, strlen(key.ptr), &key_str), NULL);
+        NAPI_CALL(env, NULL, napi_set_element(env, result, i++, key_str), NULL);
+    }
+    return result;
+}
+
+/**
+ * cursor.values() -> any[]
+ * All elements (or property values) in one call, nested nodes as cursors.
+ * Lets array methods on the proxy avoid a native call per element.
+ */
+static napi_value
+cursor_values(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value buffer, result;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, cursor_buffer(env, cursor, &buffer, &buf, &buflen), NULL);
+    NAPI_CALL(env, NULL, napi_create_array_with_length(env, cursor->count, &result), NULL);
+    if (cursor->count == 0) return result;
+
+    lite3_iter iter;
+    if (lite3_iter_create(buf, buflen, cursor->offset, &iter) != 0) {
+        napi_throw_error(env, NULL, "Failed to create iterator");
+        return NULL;
+    }
+
+    uint32_t i = 0;
+    lite3_str key;
+    size_t val_ofs;
+    while (i < cursor->count && lite3_iter_next(buf, buflen, &iter, &key, &val_ofs) == LITE3_ITER_ITEM) {
+        napi_value value;
+        NAPI_CALL(env, NULL, cursor_value(env, cursor, buffer, buf, buflen, val_ofs, &value), NULL);
+        NAPI_CALL(env, NULL, napi_set_element(env, result, i++, value), NULL);
+    }
+    return result;
+}
+
+// Apply an edit to the cursor's node and move the document to the Buffer the
+// edit returns. Returns that Buffer.
+static napi_value
+cursor_edit(napi_env env, lite3_napi_cursor *cursor, napi_value key, napi_value value, napi_value options) {
+    napi_value buffer, edited;
+    NAPI_CALL(env, NULL, napi_get_reference_value(env, cursor->doc->buffer, &buffer), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_edit(env, buffer, cursor->offset, key, value, options, &edited), NULL);
+
+    bool same;
+    NAPI_CALL(env, NULL, napi_strict_equals(env, buffer, edited, &same), NULL);
+    if (!same) {
+        napi_ref ref;
+        NAPI_CALL(env, NULL, napi_create_reference(env, edited, 1, &ref), NULL);
+        napi_delete_reference(env, cursor->doc->buffer);
+        cursor->doc->buffer = ref;
+    }
+
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, napi_get_typedarray_info(env, edited, NULL, &buflen, &buf, NULL, NULL), NULL);
+    if (lite3_count(buf, buflen, cursor->offset, &cursor->count) < 0) {
+        napi_throw_error(env, NULL, "Lite3 error");
+        return NULL;
+    }
+    return edited;
+}
+
+/**
+ * cursor.set(key, value, options?) -> Buffer
+ * Writes a property of an object cursor in place (see set()). Returns the
+ * document's Buffer after the edit.
+ */
+static napi_value
+cursor_set(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value argv[3];
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, argv);
+    if (!cursor) return NULL;
+
+    if (argc < 2) {
+        napi_throw_type_error(env, NULL, "Expected 2-3 arguments: key, value, options");
+        return NULL;
+    }
+    return cursor_edit(env, cursor, argv[0], argv[1], argc > 2 ? argv[2] : NULL);
+}
+
+/**
+ * cursor.append(value, options?) -> Buffer
+ * Appends an element to an array cursor in place (see arrAppend()).
+ */
+static napi_value
+cursor_append(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, argv);
+    if (!cursor) return NULL;
+
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1-2 arguments: value, options");
+        return NULL;
+    }
+    return cursor_edit(env, cursor, NULL, argv[0], argc > 1 ? argv[1] : NULL);
+}
+
+/**
+ * cursor.type -> "object" | "array"
+ */
+static napi_value
+cursor_get_type(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_string_utf8(env, cursor->type == LITE3_TYPE_ARRAY ? "array" : "object",
+                                                 NAPI_AUTO_LENGTH, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.length -> number
+ * Number of elements or properties.
+ */
+static napi_value
+cursor_get_length(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_uint32(env, cursor->count, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.offset -> number
+ * Position of the node in the Buffer, as used by the proxy functions.
+ */
+static napi_value
+cursor_get_offset(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_double(env, (double)cursor->offset, &result), NULL);
+    return result;
+}
+
+/**
+ * cursor.buffer -> Buffer
+ * The message this cursor reads: what it was created over, or the Buffer
+ * returned by the last edit.
+ */
+static napi_value
+cursor_get_buffer(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_get_reference_value(env, cursor->doc->buffer, &result), NULL);
+    return result;
+}
+
+static napi_status
+set_stat(napi_env env, napi_value obj, const char *name, double value) {
+    napi_value num;
+    napi_status status = napi_create_double(env, value, &num);
+    if (status != napi_ok) return status;
+    return napi_set_named_property(env, obj, name, num);
+}
+
+/**
+ * cursor.stats -> { cursors, cachedCursors, hits, misses, nativeBytes }
+ * Counters for the document this cursor belongs to. `nativeBytes` is the
+ * native memory held for the lazy view (excluding the Buffer itself).
+ */
+static napi_value
+cursor_get_stats(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_cursor *cursor = unwrap_cursor(env, info, &argc, NULL);
+    if (!cursor) return NULL;
+
+    const cursor_document *doc = cursor->doc;
+    size_t native_bytes = sizeof(*doc)
+        + doc->capacity * sizeof(cursor_slot)
+        + doc->cursors * sizeof(lite3_napi_cursor);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_object(env, &result), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "cursors", doc->cursors), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "cachedCursors", (double)doc->entries), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "hits", (double)doc->hits), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "misses", (double)doc->misses), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "nativeBytes", (double)native_bytes), NULL);
+    return result;
+}
+
+// Reads, timed as proxy reads while stats are enabled:
+static LITE3_NAPI_TIMED(cursor_get_timed, cursor_get, LITE3_NAPI_PHASE_PROXY)
+static LITE3_NAPI_TIMED(cursor_at_timed, cursor_at, LITE3_NAPI_PHASE_PROXY)
+static LITE3_NAPI_TIMED(cursor_has_timed, cursor_has, LITE3_NAPI_PHASE_PROXY)
+static LITE3_NAPI_TIMED(cursor_keys_timed, cursor_keys, LITE3_NAPI_PHASE_PROXY)
+static LITE3_NAPI_TIMED(cursor_values_timed, cursor_values, LITE3_NAPI_PHASE_PROXY)
+
+napi_status
+cursor_define_class(napi_env env, napi_value *result) {
+    napi_property_descriptor props[] = {
+        { "get", NULL, cursor_get_timed, NULL, NULL, NULL, napi_default_method, NULL },
+        { "at", NULL, cursor_at_timed, NULL, NULL, NULL, napi_default_method, NULL },
+        { "has", NULL, cursor_has_timed, NULL, NULL, NULL, napi_default_method, NULL },
+        { "keys", NULL, cursor_keys_timed, NULL, NULL, NULL, napi_default_method, NULL },
+        { "values", NULL, cursor_values_timed, NULL, NULL, NULL, napi_default_method, NULL },
+        { "set", NULL, cursor_set, NULL, NULL, NULL, napi_default_method, NULL },
+        { "append", NULL, cursor_append, NULL, NULL, NULL, napi_default_method, NULL },
+        { "type", NULL, NULL, cursor_get_type, NULL, NULL, napi_default, NULL },
+        { "length", NULL, NULL, cursor_get_length, NULL, NULL, napi_default, NULL },
+        { "offset", NULL, NULL, cursor_get_offset, NULL, NULL, napi_default, NULL },
+        { "buffer", NULL, NULL, cursor_get_buffer, NULL, NULL, napi_default, NULL },
+        { "stats", NULL, NULL, cursor_get_stats, NULL, NULL, napi_default, NULL }
+    };
+
+    napi_status status = napi_define_class(env, "Cursor", NAPI_AUTO_LENGTH, cursor_constructor, NULL,
+                                           a_count(props), props, result);
+    if (status != napi_ok) return status;
+
+    // Kept so nested cursors can be constructed from native code:
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    return napi_create_reference(env, *result, 1, &instance->cursor_constructor);
+}
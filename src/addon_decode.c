@@ -1,167 +1,313 @@
 #include <node_api.h>
 #include <lite3-napi.h>
 #include <lite3_context_api.h>
+#include <string.h>
 
+// Number.MAX_SAFE_INTEGER
+#define MAX_SAFE_INTEGER INT64_C(9007199254740991)
+
+// node_api_create_buffer_from_arraybuffer() creates a Buffer (rather than a
+// plain Uint8Array) over existing memory. It only exists in newer runtimes,
+// so it is looked up at load time rather than linked against.
+typedef napi_status (*create_buffer_from_arraybuffer_fn)(
+    napi_env env, napi_value arraybuffer, size_t byte_offset, size_t byte_length,
+    napi_value *result);
+
+static create_buffer_from_arraybuffer_fn create_buffer_from_arraybuffer;
+
+void
+lite3_napi_decode_init(void) {
+    create_buffer_from_arraybuffer = (create_buffer_from_arraybuffer_fn)
+        lite3_napi_find_runtime_symbol("node_api_create_buffer_from_arraybuffer");
+}
+
+// Create the JS value for an i64. Values JS numbers can hold exactly become
+// numbers; anything beyond Number.MAX_SAFE_INTEGER becomes a BigInt so it
+// is not silently rounded.
 napi_status
-lite3_napi_decode_value(napi_env env, lite3_ctx *ctx, size_t offset, enum lite3_type type, lite3_str *key, int index, napi_value *result) {
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Invalid Lite3 context");
-        return napi_generic_failure;
+lite3_napi_create_i64(napi_env env, int64_t value, napi_value *result) {
+    if (value >= -MAX_SAFE_INTEGER && value <= MAX_SAFE_INTEGER) {
+        return napi_create_int64(env, value, result);
     }
+    return napi_create_bigint_int64(env, value, result);
+}
 
-    const char *key_ptr = key ? key->ptr : NULL;
-
-    switch (type) {
-        case LITE3_TYPE_OBJECT: {
-            // If needed, adjust offset to point to the array object, not the parent:
-            if (index >= 0 && lite3_ctx_arr_get_obj(ctx, offset, index, &offset)) {
-                napi_throw_error(env, NULL, "Failed to get object from array");
-                return napi_generic_failure;
-            }
-
-            // Create result object:
-            napi_value dest_value;
-            napi_status status = napi_create_object(env, &dest_value);
-            if (status != napi_ok) {
-                return status;
-            }
-
-            // Create an iterator over the lite3 object's properties:
-            lite3_iter source_iter;
-            LITE3_CALL(env, NULL, lite3_ctx_iter_create(ctx, offset, &source_iter), napi_generic_failure);
-
-            // Walk through each property:
-            size_t prop_offset;
-            lite3_str prop_key;
-            while (lite3_ctx_iter_next(ctx, &source_iter, &prop_key, &prop_offset) == LITE3_ITER_ITEM) {
-                // Setup to decode the property value:
-                enum lite3_type prop_type = lite3_ctx_get_type(ctx, offset, prop_key.ptr);
-                size_t child_offset = prop_type == LITE3_TYPE_OBJECT || prop_type == LITE3_TYPE_ARRAY ? prop_offset : offset;
-                lite3_str *child_prop_key = prop_type == LITE3_TYPE_OBJECT ? NULL : &prop_key;
-
-                // Call the decoder recursively:
-                napi_value prop_value;
-                NAPI_CALL(env, NULL, lite3_napi_decode_value(env, ctx, child_offset, prop_type, child_prop_key, -1, &prop_value), napi_generic_failure);
-
-                // Set the property on the destination object:
-                napi_value key_str;
-                NAPI_CALL(env, NULL, napi_create_string_utf8(env, prop_key.ptr, strlen(prop_key.ptr), &key_str), napi_generic_failure);
-                NAPI_CALL(env, NULL, napi_set_property(env, dest_value, key_str, prop_value), napi_generic_failure);
-            }
-            *result = dest_value;
-            break;
-        }
+// Resolve a message argument to its memory. A message is a Buffer or any
+// other Uint8Array, including one over a SharedArrayBuffer; anything else is
+// a TypeError with `error` as its message.
+napi_status
+lite3_napi_get_message(napi_env env, napi_value value, const char *error, void **data, size_t *length) {
+    bool is_typedarray;
+    napi_status status = napi_is_typedarray(env, value, &is_typedarray);
+    if (status != napi_ok) return status;
+
+    napi_typedarray_type type = napi_int8_array;
+    if (is_typedarray) {
+        status = napi_get_typedarray_info(env, value, &type, length, data, NULL, NULL);
+        if (status != napi_ok) return status;
+    }
+    if (type != napi_uint8_array) {
+        napi_throw_type_error(env, NULL, error);
+        return napi_invalid_arg;
+    }
+    return napi_ok;
+}
 
-        case LITE3_TYPE_ARRAY: {
-            // Adjust offset to point to the array object, not the parent:
-            if (index >= 0 && lite3_ctx_arr_get_arr(ctx, offset, index, &offset)) {
-                napi_throw_error(env, NULL, "Failed to get object from array");
-                return napi_generic_failure;
-            }
-
-            napi_value arr;
-            napi_status status = napi_create_array(env, &arr);
-            if (status != napi_ok) {
-                return status;
-            }
-
-            lite3_iter arr_iter;
-            LITE3_CALL(env, NULL, lite3_ctx_iter_create(ctx, offset, &arr_iter), napi_generic_failure);
-
-            uint32_t i = 0;
-            size_t elem_offset;
-            for (
-                int rc = lite3_ctx_iter_next(ctx, &arr_iter, NULL, &elem_offset);
-                rc == LITE3_ITER_ITEM;
-                rc = lite3_ctx_iter_next(ctx, &arr_iter, NULL, &elem_offset)
-            ) {
-                napi_value elem_value;
-                enum lite3_type elem_type = lite3_ctx_arr_get_type(ctx, offset, i);
-                NAPI_CALL(env, NULL, lite3_napi_decode_value(env, ctx, offset, elem_type, NULL, i, &elem_value), napi_generic_failure);
-                NAPI_CALL(env, NULL, napi_set_element(env, arr, i, elem_value), napi_generic_failure);
-                i++;
-            }
-
-            *result = arr;
-            break;
+// Record the ArrayBuffer behind the Buffer being decoded so bytes values can
+// be returned as views into it. Node-API can't create views over a
+// SharedArrayBuffer, so bytes from shared memory are copied instead.
+napi_status
+lite3_napi_decoder_set_source(napi_env env, lite3_napi_decoder *dec, napi_value buffer) {
+    napi_status status = napi_get_typedarray_info(env, buffer, NULL, NULL, NULL, &dec->source, &dec->source_offset);
+    if (status != napi_ok) return status;
+
+    bool is_arraybuffer;
+    status = napi_is_arraybuffer(env, dec->source, &is_arraybuffer);
+    if (status != napi_ok) return status;
+    if (!is_arraybuffer) dec->source = NULL;
+    return napi_ok;
+}
+
+// Create the JS value for a bytes payload located inside `dec->buf`. By
+// default this is a view sharing memory with the source Buffer (a Buffer if
+// the runtime can create one over an ArrayBuffer, otherwise a Uint8Array);
+// with `copy_bytes` it is an independent Buffer.
+napi_status
+lite3_napi_decode_bytes(napi_env env, const lite3_napi_decoder *dec, const unsigned char *data, size_t len, napi_value *result) {
+    if (dec->copy_bytes || !dec->source) {
+        return napi_create_buffer_copy(env, len, data, NULL, result);
+    }
+
+    size_t byte_offset = dec->source_offset + (size_t)(data - dec->buf);
+    return lite3_napi_create_view(env, dec->source, byte_offset, len, result);
+}
+
+// Create a view of `len` bytes of `arraybuffer`: a Buffer if the runtime can
+// create one over an ArrayBuffer, otherwise a Uint8Array.
+napi_status
+lite3_napi_create_view(napi_env env, napi_value arraybuffer, size_t byte_offset, size_t len, napi_value *result) {
+    if (create_buffer_from_arraybuffer) {
+        return create_buffer_from_arraybuffer(env, arraybuffer, byte_offset, len, result);
+    }
+    return napi_create_typedarray(env, napi_uint8_array, len, arraybuffer, byte_offset, result);
+}
+
+static napi_status
+throw_malformed(napi_env env) {
+    napi_throw_error(env, NULL, "Malformed Lite3 buffer");
+    return napi_generic_failure;
+}
+
+// Unless the source passed verify(), check a property or element yielded by
+// the iterator over the node at `parent`: its key (if any) must end within
+// the buffer, and a nested object or array must come after its parent, as
+// lite3 writes them, so a hostile message can't make decoding loop. The
+// value's payload is checked by lite3_napi_decode_value().
+static bool
+child_ok(const lite3_napi_decoder *dec, size_t parent, const char *key, size_t offset) {
+    if (dec->verified) return true;
+    if (key && !lite3_napi_check_key(dec->buf, dec->buflen, key)) return false;
+    if (offset >= dec->buflen) return false;
+
+    enum lite3_type type = lite3_val_type((lite3_val *)(dec->buf + offset));
+    return (type != LITE3_TYPE_OBJECT && type != LITE3_TYPE_ARRAY) || offset > parent;
+}
+
+static bool
+key_listed(const lite3_napi_string_list *list, const char *key) {
+    for (uint32_t i = 0; i < list->count; i++) {
+        if (strcmp(list->items[i], key) == 0) return true;
+    }
+    return false;
+}
+
+// Decode an object, skipping the properties named in `omit` (if any).
+static napi_status
+decode_object(napi_env env, const lite3_napi_decoder *dec, size_t offset,
+              const lite3_napi_string_list *omit, napi_value *result) {
+    // Create result object:
+    napi_value dest_value;
+    napi_status status = napi_create_object(env, &dest_value);
+    if (status != napi_ok) {
+        return status;
+    }
+
+    // Create an iterator over the lite3 object's properties:
+    lite3_iter source_iter;
+    LITE3_CALL(env, NULL, lite3_iter_create(dec->buf, dec->buflen, offset, &source_iter), napi_generic_failure);
+
+    // Walk through each property. The iterator yields the offset of each
+    // value, so no key is ever looked up again:
+    size_t prop_offset;
+    lite3_str prop_key;
+    int rc;
+    while ((rc = lite3_iter_next(dec->buf, dec->buflen, &source_iter, &prop_key, &prop_offset)) == LITE3_ITER_ITEM) {
+        if (!child_ok(dec, offset, prop_key.ptr, prop_offset)) return throw_malformed(env);
+        if (omit && key_listed(omit, prop_key.ptr)) continue;
+
+        // Call the decoder recursively:
+        napi_value prop_value;
+        status = lite3_napi_decode_value(env, dec, prop_offset, &prop_value);
+        if (status != napi_ok) return status;
+
+        // Set the property on the destination object:
+        napi_value key_str;
+        NAPI_CALL(env, NULL, lite3_napi_key_string(env, dec->instance, prop_key.ptr, strlen(prop_key.ptr), &key_str), napi_generic_failure);
+        NAPI_CALL(env, NULL, napi_set_property(env, dest_value, key_str, prop_value), napi_generic_failure);
+    }
+    if (rc != LITE3_ITER_DONE) return throw_malformed(env);
+
+    *result = dest_value;
+    return napi_ok;
+}
+
+// Try to decode a non-empty array whose elements are all f64 (or all i64)
+// into a Float64Array (or BigInt64Array). Sets *result to NULL, without
+// error, when the array turns out to be mixed.
+//
+// lite3 stores each element as its own tagged value, so the elements are
+// copied into a fresh ArrayBuffer; a view over the source is not possible.
+static napi_status
+decode_typed_array(napi_env env, const lite3_napi_decoder *dec, size_t offset, uint32_t count, napi_value *result) {
+    *result = NULL;
+
+    lite3_iter arr_iter;
+    LITE3_CALL(env, NULL, lite3_iter_create(dec->buf, dec->buflen, offset, &arr_iter), napi_generic_failure);
+
+    size_t elem_offset;
+    if (lite3_iter_next(dec->buf, dec->buflen, &arr_iter, NULL, &elem_offset) != LITE3_ITER_ITEM) {
+        return napi_ok;
+    }
+
+    if (!child_ok(dec, offset, NULL, elem_offset)) return throw_malformed(env);
+    enum lite3_type elem_type = lite3_val_type((lite3_val *)(dec->buf + elem_offset));
+    if (elem_type != LITE3_TYPE_F64 && elem_type != LITE3_TYPE_I64) {
+        return napi_ok;
+    }
+
+    // Each element takes a type byte and 8 bytes of payload, so a count the
+    // buffer can't hold is malformed; don't allocate for it.
+    if (count > dec->buflen / 9) return throw_malformed(env);
+
+    void *data;
+    napi_value array_buffer;
+    napi_status status = napi_create_arraybuffer(env, (size_t)count * 8, &data, &array_buffer);
+    if (status != napi_ok) return status;
+
+    uint32_t i = 0;
+    int rc;
+    do {
+        if (!child_ok(dec, offset, NULL, elem_offset)) return throw_malformed(env);
+        lite3_val *val = (lite3_val *)(dec->buf + elem_offset);
+        if (i >= count || lite3_val_type(val) != elem_type) {
+            return napi_ok;  // mixed; the caller falls back to a plain array
         }
+        if (!dec->verified && !lite3_napi_check_value(dec->buf, dec->buflen, elem_offset)) {
+            return throw_malformed(env);
+        }
+        if (elem_type == LITE3_TYPE_F64) ((double *)data)[i] = lite3_val_f64(val);
+        else ((int64_t *)data)[i] = lite3_val_i64(val);
+        i++;
+    } while ((rc = lite3_iter_next(dec->buf, dec->buflen, &arr_iter, NULL, &elem_offset)) == LITE3_ITER_ITEM);
+    if (rc != LITE3_ITER_DONE || i != count) return throw_malformed(env);
+
+    napi_typedarray_type array_type = elem_type == LITE3_TYPE_F64 ? napi_float64_array : napi_bigint64_array;
+    return napi_create_typedarray(env, array_type, i, array_buffer, 0, result);
+}
+
+static napi_status
+decode_array(napi_env env, const lite3_napi_decoder *dec, size_t offset, napi_value *result) {
+    // Create the array at its final length so elements never trigger growth:
+    uint32_t count;
+    LITE3_CALL(env, NULL, lite3_count(dec->buf, dec->buflen, offset, &count), napi_generic_failure);
+
+    if (dec->typed_arrays && count > 0) {
+        napi_status status = decode_typed_array(env, dec, offset, count, result);
+        if (status != napi_ok || *result != NULL) return status;
+    }
+
+    napi_value arr;
+    napi_status status = napi_create_array_with_length(env, count, &arr);
+    if (status != napi_ok) {
+        return status;
+    }
+
+    lite3_iter arr_iter;
+    LITE3_CALL(env, NULL, lite3_iter_create(dec->buf, dec->buflen, offset, &arr_iter), napi_generic_failure);
+
+    uint32_t i = 0;
+    size_t elem_offset;
+    int rc;
+    while ((rc = lite3_iter_next(dec->buf, dec->buflen, &arr_iter, NULL, &elem_offset)) == LITE3_ITER_ITEM) {
+        if (i >= count || !child_ok(dec, offset, NULL, elem_offset)) return throw_malformed(env);
+        napi_value elem_value;
+        status = lite3_napi_decode_value(env, dec, elem_offset, &elem_value);
+        if (status != napi_ok) return status;
+        NAPI_CALL(env, NULL, napi_set_element(env, arr, i, elem_value), napi_generic_failure);
+        i++;
+    }
+    // The array was created at the stored count; an iterator that disagrees
+    // would leave holes or grow it.
+    if (rc != LITE3_ITER_DONE || i != count) return throw_malformed(env);
+
+    *result = arr;
+    return napi_ok;
+}
 
-        case LITE3_TYPE_BOOL: {
-            bool bool_value;
-            int rc = index >= 0
-                ? lite3_ctx_arr_get_bool(ctx, offset, index, &bool_value)
-                : lite3_ctx_get_bool(ctx, offset, key_ptr, &bool_value);
-            if (rc) {
-                napi_throw_error(env, NULL, "Failed to get boolean value");
-                return napi_generic_failure;
-            }
-
-            napi_value napi_boolean;
-            NAPI_CALL(env, NULL, napi_get_boolean(env, bool_value, &napi_boolean), napi_generic_failure);
-            *result = napi_boolean;
+// Decode the value stored at `offset` (as yielded by a lite3 iterator, or 0
+// for the root). Type and payload are read straight from the buffer, so a
+// full decode is a single linear pass with no key lookups. Unless the source
+// passed verify(), each payload is bounds-checked before it is read.
+napi_status
+lite3_napi_decode_value(napi_env env, const lite3_napi_decoder *dec, size_t offset, napi_value *result) {
+    if (offset >= dec->buflen) {
+        napi_throw_error(env, NULL, "Value offset is outside the Lite3 buffer");
+        return napi_generic_failure;
+    }
+    if (!dec->verified && !lite3_napi_check_value(dec->buf, dec->buflen, offset)) {
+        return throw_malformed(env);
+    }
+
+    lite3_val *val = (lite3_val *)(dec->buf + offset);
+    LITE3_NAPI_STATS_INC(dec->instance, napi_values);
+
+    switch (lite3_val_type(val)) {
+        case LITE3_TYPE_OBJECT:
+            return decode_object(env, dec, offset, NULL, result);
+
+        case LITE3_TYPE_ARRAY:
+            return decode_array(env, dec, offset, result);
+
+        case LITE3_TYPE_BOOL:
+            NAPI_CALL(env, NULL, napi_get_boolean(env, lite3_val_bool(val), result), napi_generic_failure);
             break;
-        }
 
-        case LITE3_TYPE_F64: {
-            double num_value;
-
-            // Gather the number value:
-            int rc = index >= 0
-                ? lite3_ctx_arr_get_f64(ctx, offset, index, &num_value)
-                : lite3_ctx_get_f64(ctx, offset, key_ptr, &num_value);
-            if (rc) {
-                napi_throw_error(env, NULL, "Failed to get double value");
-                return napi_generic_failure;
-            }
-
-            napi_value napi_number;
-            NAPI_CALL(env, NULL, napi_create_double(env, num_value, &napi_number), napi_generic_failure);
-            *result = napi_number;
+        case LITE3_TYPE_F64:
+            NAPI_CALL(env, NULL, napi_create_double(env, lite3_val_f64(val), result), napi_generic_failure);
             break;
-        }
 
-        case LITE3_TYPE_I64: {
-            int64_t int_value;
-
-            // Gather the integer value:
-            int rc = index >= 0
-                ? lite3_ctx_arr_get_i64(ctx, offset, index, &int_value)
-                : lite3_ctx_get_i64(ctx, offset, key_ptr, &int_value);
-            if (rc) {
-                napi_throw_error(env, NULL, "Failed to get integer value");
-                return napi_generic_failure;
-            }
-
-            lite3_ctx_get_i64(ctx, offset, key_ptr, &int_value);
-            napi_value napi_number;
-            NAPI_CALL(env, NULL, napi_create_int64(env, int_value, &napi_number), napi_generic_failure);
-            *result = napi_number;
+        case LITE3_TYPE_I64:
+            NAPI_CALL(env, NULL, lite3_napi_create_i64(env, lite3_val_i64(val), result), napi_generic_failure);
             break;
-        }
 
-        case LITE3_TYPE_NULL: {
+        case LITE3_TYPE_NULL:
             NAPI_CALL(env, NULL, napi_get_null(env, result), napi_generic_failure);
             break;
-        }
 
         case LITE3_TYPE_STRING: {
-            lite3_str str_value;
-
-            int rc =  index >= 0
-                ? lite3_ctx_arr_get_str(ctx, offset, index, &str_value)
-                : lite3_ctx_get_str(ctx, offset, key_ptr, &str_value);
-            if (rc) {
-                napi_throw_error(env, NULL, "Failed to get string value");
-                return napi_generic_failure;
-            }
-
-            napi_value napi_string;
-            NAPI_CALL(env, NULL, napi_create_string_utf8(env, str_value.ptr, str_value.len, &napi_string), napi_generic_failure);
-            *result = napi_string;
+            size_t len;
+            const char *str = lite3_val_str_n(val, &len);
+            NAPI_CALL(env, NULL, napi_create_string_utf8(env, str, len, result), napi_generic_failure);
+            break;
+        }
+
+        case LITE3_TYPE_BYTES: {
+            size_t len;
+            const unsigned char *bytes = lite3_val_bytes(val, &len);
+            NAPI_CALL(env, NULL, lite3_napi_decode_bytes(env, dec, bytes, len, result), napi_generic_failure);
             break;
         }
 
-        case LITE3_TYPE_BYTES:
         case LITE3_TYPE_COUNT:
         case LITE3_TYPE_INVALID:
         default:
@@ -173,58 +319,236 @@ lite3_napi_decode_value(napi_env env, lite3_ctx *ctx, size_t offset, enum lite3_
     return napi_ok;
 }
 
-// Given a buffer, decode it into an object/array.
-napi_value
-decode(napi_env env, napi_callback_info info) {
-    // Retrieve callback arguments into argv
-    size_t argc = 1;
-    napi_value argv[1];
-    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
-    if (argc != 1) {
-        napi_throw_type_error(env, NULL, "Expected one argument");
-        return NULL;
+static napi_status decode_shape(napi_env, const lite3_napi_decoder*, size_t, const lite3_napi_shape*, napi_value*);
+
+// Decode the value at `offset` expecting the type `spec`. Nested shapes and
+// arrays follow the spec; anything else, including values of an unexpected
+// type, decodes as it would without a schema.
+static napi_status
+decode_typed(napi_env env, const lite3_napi_decoder *dec, size_t offset, const lite3_napi_type_spec *spec,
+             napi_value *result) {
+    enum lite3_type type = lite3_val_type((lite3_val *)(dec->buf + offset));
+
+    if (spec->type == LITE3_NAPI_TYPE_OBJECT && type == LITE3_TYPE_OBJECT) {
+        LITE3_NAPI_STATS_INC(dec->instance, napi_values);
+        return decode_shape(env, dec, offset, spec->shape, result);
+    }
+
+    if (spec->type == LITE3_NAPI_TYPE_ARRAY && type == LITE3_TYPE_ARRAY
+        && spec->element->type >= LITE3_NAPI_TYPE_OBJECT) {
+        LITE3_NAPI_STATS_INC(dec->instance, napi_values);
+
+        uint32_t count;
+        LITE3_CALL(env, NULL, lite3_count(dec->buf, dec->buflen, offset, &count), napi_generic_failure);
+        napi_status status = napi_create_array_with_length(env, count, result);
+        if (status != napi_ok) return status;
+
+        lite3_iter arr_iter;
+        LITE3_CALL(env, NULL, lite3_iter_create(dec->buf, dec->buflen, offset, &arr_iter), napi_generic_failure);
+
+        uint32_t i = 0;
+        size_t elem_offset;
+        int rc;
+        while ((rc = lite3_iter_next(dec->buf, dec->buflen, &arr_iter, NULL, &elem_offset)) == LITE3_ITER_ITEM) {
+            if (i >= count || !child_ok(dec, offset, NULL, elem_offset)) return throw_malformed(env);
+            napi_value elem_value;
+            status = decode_typed(env, dec, elem_offset, spec->element, &elem_value);
+            if (status != napi_ok) return status;
+            status = napi_set_element(env, *result, i++, elem_value);
+            if (status != napi_ok) return status;
+        }
+        return rc == LITE3_ITER_DONE && i == count ? napi_ok : throw_malformed(env);
+    }
+
+    return lite3_napi_decode_value(env, dec, offset, result);
+}
+
+// Decode the object at `offset` as `shape`: each field is looked up by key
+// and the object is built with the fields in shape order, so every object
+// of a shape gets the same hidden class. Fields absent from the message are
+// left out; keys not in the shape are skipped.
+static napi_status
+decode_shape(napi_env env, const lite3_napi_decoder *dec, size_t offset, const lite3_napi_shape *shape,
+             napi_value *result) {
+    napi_value shape_names;
+    napi_status status = napi_get_reference_value(env, shape->names, &shape_names);
+    if (status == napi_ok) status = napi_create_object(env, result);
+
+    for (uint32_t i = 0; i < shape->count && status == napi_ok; i++) {
+        const lite3_napi_shape_field *field = &shape->fields[i];
+        lite3_val *val;
+        if (lite3_get(dec->buf, dec->buflen, offset, field->key, &val) != 0) continue;
+
+        size_t val_offset = (size_t)((const unsigned char *)val - dec->buf);
+        if (!child_ok(dec, offset, NULL, val_offset)) return throw_malformed(env);
+
+        napi_value name, value;
+        status = decode_typed(env, dec, val_offset, &field->spec, &value);
+        if (status == napi_ok) status = napi_get_element(env, shape_names, i, &name);
+        if (status == napi_ok) status = napi_set_property(env, *result, name, value);
     }
+    return status;
+}
 
-    // Check type of argv[0]:
-    bool is_buffer;
-    if (napi_is_buffer(env, argv[0], &is_buffer) != napi_ok || !is_buffer) {
-         napi_throw_type_error(env, NULL, "Argument must be a Buffer");
-         return NULL;
+// Decode a Buffer whose root is an object of `shape`.
+napi_status
+lite3_napi_decode_shape(napi_env env, napi_value buffer_value, const lite3_napi_shape *shape, napi_value *result) {
+    void *buffer;
+    size_t buffer_length;
+    napi_status status = lite3_napi_get_message(env, buffer_value, "Argument must be a Buffer or Uint8Array",
+                                                &buffer, &buffer_length);
+    if (status != napi_ok) return status;
+    if (buffer_length == 0 || lite3_val_type((lite3_val *)buffer) != LITE3_TYPE_OBJECT) {
+        napi_throw_type_error(env, NULL, "Buffer does not hold an object");
+        return napi_invalid_arg;
     }
 
-    // argv[0] is a Buffer to be decoded.
+    lite3_napi_decoder dec = {
+        .buf = buffer,
+        .buflen = buffer_length,
+        .instance = lite3_napi_get_instance(env),
+    };
+    status = lite3_napi_decoder_set_source(env, &dec, buffer_value);
+    if (status != napi_ok) return status;
+    status = lite3_napi_is_verified(env, buffer_value, &dec.verified);
+    if (status != napi_ok) return status;
+
+    bool timed = LITE3_NAPI_STATS_ON(dec.instance);
+    uint64_t start = timed ? lite3_napi_stats_clock() : 0;
+    LITE3_NAPI_STATS_INC(dec.instance, napi_values);
+    status = decode_shape(env, &dec, 0, shape, result);
+    if (timed) lite3_napi_stats_record(dec.instance, LITE3_NAPI_PHASE_DECODE, start, buffer_length);
+    return status;
+}
+
+// Decode only the properties named in `pick`, in that order. Each is found
+// with a key lookup, so unrelated properties are never visited.
+static napi_status
+decode_picked(napi_env env, const lite3_napi_decoder *dec, size_t offset,
+              const lite3_napi_string_list *pick, napi_value *result) {
+    napi_status status = napi_create_object(env, result);
+    if (status != napi_ok) return status;
+
+    for (uint32_t i = 0; i < pick->count; i++) {
+        lite3_val *val;
+        if (lite3_get(dec->buf, dec->buflen, offset, pick->items[i], &val) != 0) continue;
+
+        napi_value value;
+        status = lite3_napi_decode_value(env, dec, (size_t)((const unsigned char *)val - dec->buf), &value);
+        if (status != napi_ok) return status;
+        status = napi_set_named_property(env, *result, pick->items[i], value);
+        if (status != napi_ok) return status;
+    }
+    return napi_ok;
+}
+
+// Decode a Buffer argument according to decode()'s options. On failure an
+// exception is pending, or the returned status says what went wrong.
+napi_status
+lite3_napi_decode_buffer(napi_env env, napi_value buffer_value, napi_value options, napi_value *result) {
+    // buffer_value is a Buffer (or other Uint8Array) to be decoded.
     void *buffer;
     size_t buffer_length;
-    NAPI_CALL(env, NULL, napi_get_buffer_info(env, argv[0], &buffer, &buffer_length), NULL);
+    napi_status status = lite3_napi_get_message(env, buffer_value, "Argument must be a Buffer or Uint8Array",
+                                                &buffer, &buffer_length);
+    if (status != napi_ok) return status;
+
+    // Decode straight from the Buffer's memory; no context (or copy) needed:
+    lite3_napi_decoder dec = {
+        .buf = buffer,
+        .buflen = buffer_length,
+        .instance = lite3_napi_get_instance(env),
+    };
+    status = lite3_napi_get_bool_option(env, options, "typedArrays", false, &dec.typed_arrays);
+    if (status != napi_ok) return status;
+    status = lite3_napi_get_bool_option(env, options, "copyBytes", false, &dec.copy_bytes);
+    if (status != napi_ok) return status;
+    if (!dec.copy_bytes) {
+        status = lite3_napi_decoder_set_source(env, &dec, buffer_value);
+        if (status != napi_ok) return status;
+    }
+    status = lite3_napi_is_verified(env, buffer_value, &dec.verified);
+    if (status != napi_ok) return status;
+
+    uint32_t offset;
+    status = lite3_napi_get_uint32_option(env, options, "offset", 0, &offset);
+    if (status != napi_ok) return status;
+    if (offset >= buffer_length) {
+        napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+        return napi_invalid_arg;
+    }
+    if (offset != 0 && !lite3_napi_check_node(dec.buf, dec.buflen, offset, dec.verified)) {
+        napi_throw_type_error(env, NULL, "Offset does not point to an object or array");
+        return napi_invalid_arg;
+    }
 
-    // Create lite3 context from buffer:
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_length);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
-        return NULL;
+    lite3_napi_string_list pick, omit;
+    bool has_pick, has_omit;
+    status = lite3_napi_get_string_list_option(env, options, "pick", &pick, &has_pick);
+    if (status != napi_ok) return status;
+    status = lite3_napi_get_string_list_option(env, options, "omit", &omit, &has_omit);
+    if (status != napi_ok) {
+        lite3_napi_string_list_free(&pick);
+        return status;
     }
 
-    // Decode the buffer into a napi_value:
-    napi_value result;
-    NAPI_CALL(
-        env,
-        ctx,
-        lite3_napi_decode_value(
-            env, // napi_env
-            ctx, // lite3_ctx*
-            0,   // offset (0 == root)
-            lite3_ctx_get_root_type(ctx), // type
-            NULL, // key (NULL == root, or not an object)
-            -1, // index (-1 == not an array index)
-            &result // [out] result
-        ),
-        NULL);
+    bool timed = LITE3_NAPI_STATS_ON(dec.instance);
+    uint64_t start = timed ? lite3_napi_stats_clock() : 0;
+
+    // Decode the buffer (or the requested part of it) into a napi_value:
+    if (has_pick || has_omit) {
+        if (has_pick && has_omit) {
+            napi_throw_type_error(env, NULL, "Options pick and omit cannot be combined");
+            status = napi_invalid_arg;
+        } else if (lite3_val_type((lite3_val *)(dec.buf + offset)) != LITE3_TYPE_OBJECT) {
+            napi_throw_type_error(env, NULL, "Options pick and omit require an object");
+            status = napi_invalid_arg;
+        } else if (has_pick) {
+            status = decode_picked(env, &dec, offset, &pick, result);
+        } else {
+            status = decode_object(env, &dec, offset, &omit, result);
+        }
+    } else {
+        status = lite3_napi_decode_value(
+            env,    // napi_env
+            &dec,   // decoder state
+            offset, // offset (0 == root)
+            result  // [out] result
+        );
+    }
+    lite3_napi_string_list_free(&pick);
+    lite3_napi_string_list_free(&omit);
+    if (timed) lite3_napi_stats_record(dec.instance, LITE3_NAPI_PHASE_DECODE, start, buffer_length - offset);
 
 #ifdef LITE3_DEBUG && LITE3_JSON
-    lite3_ctx_json_print(ctx, 0); // For debugging
+    lite3_json_print(dec.buf, dec.buflen, 0); // For debugging
 #endif
 
-    lite3_ctx_destroy(ctx);
+    return status;
+}
+
+// Given a buffer, decode it into an object/array.
+//   decode(buffer, options?)
+//     options.typedArrays - return arrays whose elements are all f64 or all
+//                           i64 as Float64Array / BigInt64Array (default: false)
+//     options.copyBytes   - return bytes values as Buffer copies rather than
+//                           views into `buffer` (default: false)
+//     options.offset      - decode only the node at this offset, as returned
+//                           by the proxy functions (default: 0, the root)
+//     options.pick        - decode only these properties of the object
+//     options.omit        - decode all but these properties of the object
+napi_value
+decode(napi_env env, napi_callback_info info) {
+    // Retrieve callback arguments into argv
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return NULL;
+    }
 
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_decode_buffer(env, argv[0], argc > 1 ? argv[1] : NULL, &result), NULL);
     return result;
 }
@@ -2,14 +2,354 @@
 #include <lite3-napi.h>
 #include <lite3_context_api.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
 
-static napi_status encode_enumerable(napi_env, napi_value, bool, lite3_ctx*, size_t);
-static napi_status encode_element(napi_env, char*, napi_value, bool, lite3_ctx*, size_t);
+// Below this size a copy is cheaper than registering an external Buffer.
+#define ZERO_COPY_MIN_LENGTH 4096
 
+// Largest integer a JS number represents exactly (Number.MAX_SAFE_INTEGER).
+#define MAX_SAFE_INTEGER 9007199254740991.0
+
+// Inline scratch space per string slot; sized for typical keys and values.
+#define SCRATCH_INLINE_SIZE 512
+
+// Scratch space for transcoding JS strings to UTF-8. Strings that don't fit
+// inline spill to a heap buffer that is kept for the rest of the call.
+typedef struct {
+    char *ptr;              // inline_buf, or a heap buffer for outliers
+    size_t cap;
+    char inline_buf[SCRATCH_INLINE_SIZE];
+} scratch_buf;
+
+// Destination of an encode walk: either a growable lite3 context, or a
+// fixed region of caller memory written through lite3's buffer API.
+typedef struct {
+    lite3_ctx *ctx;         // growable context, or NULL for fixed memory
+    unsigned char *buf;     // fixed memory (ctx == NULL)
+    size_t buflen;
+    size_t bufsz;
+    bool overflow;          // fixed memory ran out of space
+    lite3_napi_encode_options options;
+
+    // A key is only needed until its value is written, and a string value
+    // only until it is written, so one slot of each suffices at any depth.
+    scratch_buf key;
+    scratch_buf str;
+    uint32_t allocations;   // heap allocations made by this walk
+} encode_target;
+
+static void
+scratch_init(scratch_buf *sb) {
+    sb->ptr = sb->inline_buf;
+    sb->cap = sizeof(sb->inline_buf);
+}
+
+static void
+scratch_free(scratch_buf *sb) {
+    if (sb->ptr != sb->inline_buf) free(sb->ptr);
+    scratch_init(sb);
+}
+
+static void
+target_init(encode_target *out) {
+    scratch_init(&out->key);
+    scratch_init(&out->str);
+}
+
+// Release scratch memory and account for the walk's allocations.
+static void
+target_release(napi_env env, encode_target *out) {
+    scratch_free(&out->key);
+    scratch_free(&out->str);
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    if (instance) instance->encode_allocations += out->allocations;
+}
+
+// Transcode a JS string into `sb` and point `*result` at it. Only strings
+// that don't fit the current scratch space cause a heap allocation.
+static napi_status
+scratch_utf8(napi_env env, encode_target *out, scratch_buf *sb, napi_value value, const char **result) {
+    size_t len;
+    napi_status status = napi_get_value_string_utf8(env, value, sb->ptr, sb->cap, &len);
+    if (status != napi_ok) return status;
+
+    // N-API never splits a character, so if there was room left for the
+    // largest UTF-8 sequence the string is complete:
+    if (len + 4 < sb->cap) {
+        *result = sb->ptr;
+        return napi_ok;
+    }
+
+    status = napi_get_value_string_utf8(env, value, NULL, 0, &len);
+    if (status != napi_ok) return status;
+
+    if (len + 1 > sb->cap) {
+        size_t cap = sb->cap;
+        while (cap < len + 1) cap *= 2;
+
+        char *heap = malloc(cap);
+        if (!heap) {
+            napi_throw_error(env, NULL, "Memory allocation failure");
+            return napi_generic_failure;
+        }
+        out->allocations++;
+        scratch_free(sb);
+        sb->ptr = heap;
+        sb->cap = cap;
+    }
+
+    status = napi_get_value_string_utf8(env, value, sb->ptr, sb->cap, &len);
+    if (status != napi_ok) return status;
+
+    *result = sb->ptr;
+    return napi_ok;
+}
+
+// Write helpers: a NULL key appends to the array at `ofs`, otherwise the
+// value is set under `key` in the object at `ofs`.
+static int
+out_null(encode_target *out, size_t ofs, const char *key) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_null(out->ctx, ofs, key) : lite3_ctx_arr_append_null(out->ctx, ofs);
+    }
+    return key ? lite3_set_null(out->buf, &out->buflen, ofs, out->bufsz, key)
+               : lite3_arr_append_null(out->buf, &out->buflen, ofs, out->bufsz);
+}
+
+static int
+out_bool(encode_target *out, size_t ofs, const char *key, bool value) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_bool(out->ctx, ofs, key, value) : lite3_ctx_arr_append_bool(out->ctx, ofs, value);
+    }
+    return key ? lite3_set_bool(out->buf, &out->buflen, ofs, out->bufsz, key, value)
+               : lite3_arr_append_bool(out->buf, &out->buflen, ofs, out->bufsz, value);
+}
+
+static int
+out_f64(encode_target *out, size_t ofs, const char *key, double value) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_f64(out->ctx, ofs, key, value) : lite3_ctx_arr_append_f64(out->ctx, ofs, value);
+    }
+    return key ? lite3_set_f64(out->buf, &out->buflen, ofs, out->bufsz, key, value)
+               : lite3_arr_append_f64(out->buf, &out->buflen, ofs, out->bufsz, value);
+}
+
+static int
+out_i64(encode_target *out, size_t ofs, const char *key, int64_t value) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_i64(out->ctx, ofs, key, value) : lite3_ctx_arr_append_i64(out->ctx, ofs, value);
+    }
+    return key ? lite3_set_i64(out->buf, &out->buflen, ofs, out->bufsz, key, value)
+               : lite3_arr_append_i64(out->buf, &out->buflen, ofs, out->bufsz, value);
+}
+
+static int
+out_bytes(encode_target *out, size_t ofs, const char *key, const unsigned char *bytes, size_t len) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_bytes(out->ctx, ofs, key, bytes, len) : lite3_ctx_arr_append_bytes(out->ctx, ofs, bytes, len);
+    }
+    return key ? lite3_set_bytes(out->buf, &out->buflen, ofs, out->bufsz, key, bytes, len)
+               : lite3_arr_append_bytes(out->buf, &out->buflen, ofs, out->bufsz, bytes, len);
+}
+
+static int
+out_str(encode_target *out, size_t ofs, const char *key, const char *value) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_str(out->ctx, ofs, key, value) : lite3_ctx_arr_append_str(out->ctx, ofs, value);
+    }
+    return key ? lite3_set_str(out->buf, &out->buflen, ofs, out->bufsz, key, value)
+               : lite3_arr_append_str(out->buf, &out->buflen, ofs, out->bufsz, value);
+}
+
+static int
+out_obj(encode_target *out, size_t ofs, const char *key, size_t *out_ofs) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_obj(out->ctx, ofs, key, out_ofs) : lite3_ctx_arr_append_obj(out->ctx, ofs, out_ofs);
+    }
+    return key ? lite3_set_obj(out->buf, &out->buflen, ofs, out->bufsz, key, out_ofs)
+               : lite3_arr_append_obj(out->buf, &out->buflen, ofs, out->bufsz, out_ofs);
+}
+
+static int
+out_arr(encode_target *out, size_t ofs, const char *key, size_t *out_ofs) {
+    if (out->ctx) {
+        return key ? lite3_ctx_set_arr(out->ctx, ofs, key, out_ofs) : lite3_ctx_arr_append_arr(out->ctx, ofs, out_ofs);
+    }
+    return key ? lite3_set_arr(out->buf, &out->buflen, ofs, out->bufsz, key, out_ofs)
+               : lite3_arr_append_arr(out->buf, &out->buflen, ofs, out->bufsz, out_ofs);
+}
+
+// Initialise the root of the message as an object or array.
+static int
+out_init(encode_target *out, bool is_array) {
+    if (out->ctx) {
+        return is_array ? lite3_ctx_init_arr(out->ctx) : lite3_ctx_init_obj(out->ctx);
+    }
+    return is_array ? lite3_init_arr(out->buf, &out->buflen, out->bufsz)
+                    : lite3_init_obj(out->buf, &out->buflen, out->bufsz);
+}
+
+// Report a failed write. Running out of fixed memory is not an error the
+// caller sees as an exception; it is flagged so the entry point can report
+// the size it needs instead.
+static napi_status
+out_failure(napi_env env, encode_target *out) {
+    if (!out->ctx && errno == ENOBUFS) {
+        out->overflow = true;
+        return napi_generic_failure;
+    }
+    napi_throw_error(env, NULL, "Lite3 error");
+    return napi_generic_failure;
+}
+
+// How an object-typed JS value is laid out in lite3.
+typedef enum {
+    CONTAINER_OBJECT,
+    CONTAINER_ARRAY,
+    CONTAINER_TYPED_ARRAY,  // encoded as a lite3 array of numbers
+    CONTAINER_BYTES,        // not a container: a single lite3 bytes value
+} container_kind;
+
+static napi_status encode_enumerable(napi_env, napi_value, bool, encode_target*, size_t);
+static napi_status encode_element(napi_env, const char*, napi_value, bool, encode_target*, size_t);
+
+// Byte-oriented views (Buffer, Uint8Array, Uint8ClampedArray, DataView) and
+// ArrayBuffers are binary data; wider TypedArrays are arrays of numbers.
+static napi_status
+classify_container(napi_env env, napi_value value, container_kind *kind) {
+    bool is_type;
+    napi_status status = napi_is_array(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        *kind = CONTAINER_ARRAY;
+        return napi_ok;
+    }
+
+    status = napi_is_typedarray(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        napi_typedarray_type type;
+        status = napi_get_typedarray_info(env, value, &type, NULL, NULL, NULL, NULL);
+        if (status != napi_ok) return status;
+        *kind = type == napi_uint8_array || type == napi_uint8_clamped_array
+            ? CONTAINER_BYTES
+            : CONTAINER_TYPED_ARRAY;
+        return napi_ok;
+    }
+
+    status = napi_is_dataview(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (!is_type) {
+        status = napi_is_arraybuffer(env, value, &is_type);
+        if (status != napi_ok) return status;
+    }
+    *kind = is_type ? CONTAINER_BYTES : CONTAINER_OBJECT;
+    return napi_ok;
+}
+
+// Resolve a byte-oriented view or ArrayBuffer to its memory.
+static napi_status
+get_byte_view(napi_env env, napi_value value, const unsigned char **data, size_t *length) {
+    bool is_type;
+    napi_status status = napi_is_typedarray(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        return napi_get_typedarray_info(env, value, NULL, length, (void **)data, NULL, NULL);
+    }
+
+    status = napi_is_dataview(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        return napi_get_dataview_info(env, value, length, (void **)data, NULL, NULL);
+    }
+
+    return napi_get_arraybuffer_info(env, value, (void **)data, length);
+}
+
+// Append every element of a TypedArray to the array at `offset`, reading
+// straight from its backing store. Float arrays become f64 values, integer
+// arrays become i64 values.
 static napi_status
-encode_enumerable(napi_env env, napi_value value, bool is_array, lite3_ctx *ctx, size_t offset) {
+encode_typed_array(napi_env env, napi_value value, encode_target *out, size_t offset) {
+    napi_typedarray_type type;
+    size_t length;
+    void *data;
+    napi_status status = napi_get_typedarray_info(env, value, &type, &length, &data, NULL, NULL);
+    if (status != napi_ok) return status;
+
+#define APPEND_EACH(ctype, append, cast)                                     \
+    for (size_t i = 0; i < length; i++) {                                   \
+        if (append(out, offset, NULL, (cast)((const ctype *)data)[i]) != 0) \
+            return out_failure(env, out);                                   \
+    }                                                                       \
+    break
+
+    switch (type) {
+        case napi_int8_array:          APPEND_EACH(int8_t, out_i64, int64_t);
+        case napi_uint8_array:         APPEND_EACH(uint8_t, out_i64, int64_t);
+        case napi_uint8_clamped_array: APPEND_EACH(uint8_t, out_i64, int64_t);
+        case napi_int16_array:         APPEND_EACH(int16_t, out_i64, int64_t);
+        case napi_uint16_array:        APPEND_EACH(uint16_t, out_i64, int64_t);
+        case napi_int32_array:         APPEND_EACH(int32_t, out_i64, int64_t);
+        case napi_uint32_array:        APPEND_EACH(uint32_t, out_i64, int64_t);
+        case napi_bigint64_array:      APPEND_EACH(int64_t, out_i64, int64_t);
+        case napi_float32_array:       APPEND_EACH(float, out_f64, double);
+        case napi_float64_array:       APPEND_EACH(double, out_f64, double);
+
+        case napi_biguint64_array: {
+            const uint64_t *values = data;
+            for (size_t i = 0; i < length; i++) {
+                if (values[i] > INT64_MAX) {
+                    napi_throw_range_error(env, NULL, "BigUint64Array value does not fit in a signed 64-bit integer");
+                    return napi_generic_failure;
+                }
+                if (out_i64(out, offset, NULL, (int64_t)values[i]) != 0) return out_failure(env, out);
+            }
+            break;
+        }
+
+        default:
+            napi_throw_type_error(env, NULL, "Unsupported TypedArray type");
+            return napi_generic_failure;
+    }
+#undef APPEND_EACH
+
+    return napi_ok;
+}
+
+// Fill the container at `offset` with the contents of `value`.
+static napi_status
+encode_container(napi_env env, napi_value value, container_kind kind, encode_target *out, size_t offset) {
+    if (kind == CONTAINER_TYPED_ARRAY) {
+        return encode_typed_array(env, value, out, offset);
+    }
+    return encode_enumerable(env, value, kind == CONTAINER_ARRAY, out, offset);
+}
+
+static napi_status
+encode_enumerable(napi_env env, napi_value value, bool is_array, encode_target *out, size_t offset) {
     napi_status status;
 
+    if (is_array) {
+        // Arrays are walked by index; their keys never need transcoding.
+        uint32_t length;
+        status = napi_get_array_length(env, value, &length);
+        if (status != napi_ok) return status;
+
+        for (uint32_t i = 0; i < length; i++) {
+            napi_value element;
+            status = napi_get_element(env, value, i, &element);
+            if (status != napi_ok) return status;
+
+            status = encode_element(env, NULL, element, true, out, offset);
+            if (status != napi_ok) return status;
+        }
+        return napi_ok;
+    }
+
     // Get property names and walk through each value
     napi_value prop_names;
     status = napi_get_property_names(env, value, &prop_names);
@@ -24,94 +364,83 @@ encode_enumerable(napi_env env, napi_value value, bool is_array, lite3_ctx *ctx,
         status = napi_get_element(env, prop_names, i, &key);
         if (status != napi_ok) return status;
 
-        size_t key_len;
-        status = napi_get_value_string_utf8(env, key, NULL, 0, &key_len);
+        const char *key_str;
+        status = scratch_utf8(env, out, &out->key, key, &key_str);
         if (status != napi_ok) return status;
-        char *key_str = malloc(key_len + 1);
-        if (!key_str) {
-            napi_throw_error(env, NULL, "Memory allocation failure");
-            return napi_generic_failure;
-        }
-        status = napi_get_value_string_utf8(env, key, key_str, key_len + 1, &key_len);
-        if (status != napi_ok) {
-            free(key_str);
-            return status;
-        }
+
         napi_value property_value;
         status = napi_get_property(env, value, key, &property_value);
-        if (status != napi_ok) {
-            free(key_str);
-            return status;
-        }
-        status = encode_element(env, key_str, property_value, is_array, ctx, offset);
-        if (status != napi_ok) {
-            free(key_str);
-            return status;
-        }
-        free(key_str);
+        if (status != napi_ok) return status;
+
+        status = encode_element(env, key_str, property_value, false, out, offset);
+        if (status != napi_ok) return status;
     }
 
     return napi_ok;
 }
 
 static napi_status
-encode_element(napi_env env, char *key_name, napi_value value, bool parent_is_array, lite3_ctx *ctx, size_t offset) {
-    // Walk through each element in the array and encode it into ctx based on type.
+encode_element(napi_env env, const char *key_name, napi_value value, bool parent_is_array, encode_target *out, size_t offset) {
+    // Walk through each element in the array and encode it into out based on type.
     napi_valuetype type;
     napi_status status = napi_typeof(env, value, &type);
     if (status != napi_ok) return status;
 
+    // Array elements are appended rather than keyed.
+    const char *key = parent_is_array ? NULL : key_name;
+#ifdef LITE3_DEBUG
+    if (!key_name) key_name = "[]";
+#endif // LITE3_DEBUG
+
     switch (type) {
         case napi_string: {
-            size_t len;
-            status = napi_get_value_string_utf8(env, value, NULL, 0, &len);
+            const char *str;
+            status = scratch_utf8(env, out, &out->str, value, &str);
             if (status != napi_ok) return status;
-            char *str = malloc(len + 1);
-            if (!str) {
-                napi_throw_error(env, NULL, "Memory allocation failure");
-                return napi_generic_failure;
-            }
-            status = napi_get_value_string_utf8(env, value, str, len + 1, &len);
-            if (status != napi_ok) {
-                // free(str);
-                return status;
-            }
 #ifdef LITE3_DEBUG
             printf("Encoding string key='%s' value='%s'\n", key_name, str);
 #endif // LITE3_DEBUG
-            if (parent_is_array) {
-                int lite3_arr_append_str_result = lite3_ctx_arr_append_str(ctx, offset, str);
-                if (lite3_arr_append_str_result != 0) {
-                    free(str);
-                    return napi_generic_failure;
-                }
-            } else {
-                int lite3_set_str_result = lite3_ctx_set_str(ctx, offset, key_name, str);
-                if (lite3_set_str_result != 0) {
-                    free(str);
-                    return napi_generic_failure;
-                }
-            }
-            free(str);
+            if (out_str(out, offset, key, str) != 0) return out_failure(env, out);
             return napi_ok;
         }
 
-        // TODO: What is a bigint in lite3?
-        // case napi_bigint: {
-        // }
+        case napi_bigint: {
+            int64_t num;
+            bool lossless;
+            status = napi_get_value_bigint_int64(env, value, &num, &lossless);
+            if (status != napi_ok) return status;
+            if (!lossless) {
+                napi_throw_range_error(env, NULL, "BigInt value does not fit in a signed 64-bit integer");
+                return napi_invalid_arg;
+            }
+#ifdef LITE3_DEBUG
+            printf("Encoding bigint key='%s' value=%" PRId64 "\n", key_name, num);
+#endif // LITE3_DEBUG
+            if (out_i64(out, offset, key, num) != 0) return out_failure(env, out);
+            return napi_ok;
+        }
 
         case napi_number: {
             double num;
             status = napi_get_value_double(env, value, &num);
             if (status != napi_ok) return status;
+
+            // Integral values JS can represent exactly are stored as i64 on
+            // request; -0 stays f64 so its sign survives the round trip.
+            if (out->options.integers
+                && num >= -MAX_SAFE_INTEGER && num <= MAX_SAFE_INTEGER
+                && num == (double)(int64_t)num
+                && !(num == 0 && signbit(num))) {
 #ifdef LITE3_DEBUG
-            printf("Encoding number key='%s' value=%f\n", key_name, num);
+                printf("Encoding integer key='%s' value=%" PRId64 "\n", key_name, (int64_t)num);
 #endif // LITE3_DEBUG
-            if (parent_is_array) {
-                LITE3_CALL(env, NULL, lite3_ctx_arr_append_f64(ctx, offset, num), napi_generic_failure);
-            } else {
-                LITE3_CALL(env, NULL, lite3_ctx_set_f64(ctx, offset, key_name, num), napi_generic_failure);
+                if (out_i64(out, offset, key, (int64_t)num) != 0) return out_failure(env, out);
+                return napi_ok;
             }
+#ifdef LITE3_DEBUG
+            printf("Encoding number key='%s' value=%f\n", key_name, num);
+#endif // LITE3_DEBUG
+            if (out_f64(out, offset, key, num) != 0) return out_failure(env, out);
             return napi_ok;
         }
 
@@ -123,11 +452,7 @@ encode_element(napi_env env, char *key_name, napi_value value, bool parent_is_ar
             printf("Encoding boolean key='%s' value=%s\n", key_name, b ?
                      "true" : "false");
 #endif // LITE3_DEBUG
-            if (parent_is_array) {
-                LITE3_CALL(env, NULL, lite3_ctx_arr_append_bool(ctx, offset, b), napi_generic_failure);
-            } else {
-                LITE3_CALL(env, NULL, lite3_ctx_set_bool(ctx, offset, key_name, b), napi_generic_failure);
-            }
+            if (out_bool(out, offset, key, b) != 0) return out_failure(env, out);
             return napi_ok;
         }
 
@@ -135,34 +460,35 @@ encode_element(napi_env env, char *key_name, napi_value value, bool parent_is_ar
 #ifdef LITE3_DEBUG
             printf("Encoding null key='%s'\n", key_name);
 #endif // LITE3_DEBUG
-            if (parent_is_array) {
-                LITE3_CALL(env, NULL, lite3_ctx_arr_append_null(ctx, offset), napi_generic_failure);
-            } else {
-                LITE3_CALL(env, NULL, lite3_ctx_set_null(ctx, offset, key_name), napi_generic_failure);
-            }
+            if (out_null(out, offset, key) != 0) return out_failure(env, out);
             return napi_ok;
         }
 
-        // handles arrays and objects:
+        // handles arrays, typed arrays and objects:
         case napi_object: {
-            bool is_array;
-            status = napi_is_array(env, value, &is_array);
+            container_kind kind;
+            status = classify_container(env, value, &kind);
             if (status != napi_ok) return status;
 
-            size_t new_offset;
-            if (parent_is_array) {
-                if (is_array) {
-                    LITE3_CALL(env, NULL, lite3_ctx_arr_append_arr(ctx, offset, &new_offset), napi_generic_failure);
-                } else {
-                    LITE3_CALL(env, NULL, lite3_ctx_arr_append_obj(ctx, offset, &new_offset), napi_generic_failure);
-                }
-            } else {
-                if (is_array) {
-                    LITE3_CALL(env, NULL, lite3_ctx_set_arr(ctx, offset, key_name, &new_offset), napi_generic_failure);
-                } else {
-                    LITE3_CALL(env, NULL, lite3_ctx_set_obj(ctx, offset, key_name, &new_offset), napi_generic_failure);
-                }
+            if (kind == CONTAINER_BYTES) {
+                // Binary data is written with a single bulk copy:
+                const unsigned char *bytes;
+                size_t len;
+                status = get_byte_view(env, value, &bytes, &len);
+                if (status != napi_ok) return status;
+#ifdef LITE3_DEBUG
+                printf("Encoding bytes key='%s' length=%zu\n", key_name, len);
+#endif // LITE3_DEBUG
+                if (out_bytes(out, offset, key, bytes, len) != 0) return out_failure(env, out);
+                return napi_ok;
             }
+            bool is_array = kind != CONTAINER_OBJECT;
+
+            size_t new_offset;
+            int rc = is_array
+                ? out_arr(out, offset, key, &new_offset)
+                : out_obj(out, offset, key, &new_offset);
+            if (rc != 0) return out_failure(env, out);
 
 #ifdef LITE3_DEBUG
             printf("Encoding %s key='%s' at offset=%zu\n", is_array ? "array" : "object", key_name, new_offset);
@@ -170,7 +496,7 @@ encode_element(napi_env env, char *key_name, napi_value value, bool parent_is_ar
 
             // Pass new_offset as the base for the next level down.
             // We then return status directly, no need to check it:
-            return encode_enumerable(env, value, is_array, ctx, new_offset);
+            return encode_container(env, value, kind, out, new_offset);
         }
 
         default: {
@@ -187,15 +513,317 @@ encode_element(napi_env env, char *key_name, napi_value value, bool parent_is_ar
     }
 }
 
+static napi_status encode_shape(napi_env, napi_value, const lite3_napi_shape*, encode_target*, size_t);
+
+// Encode `value` as the type `spec` says it holds, reading it with the
+// matching N-API getter instead of asking for its type first. A value of any
+// other type (including null or a missing property) is encoded as it is, the
+// way encode_element() would.
+static napi_status
+encode_typed(napi_env env, const char *key, napi_value value, const lite3_napi_type_spec *spec,
+             encode_target *out, size_t offset) {
+    napi_status status;
+
+    switch (spec->type) {
+        case LITE3_NAPI_TYPE_STRING: {
+            const char *str;
+            status = scratch_utf8(env, out, &out->str, value, &str);
+            if (status == napi_string_expected) break;
+            if (status != napi_ok) return status;
+            if (out_str(out, offset, key, str) != 0) return out_failure(env, out);
+            return napi_ok;
+        }
+
+        case LITE3_NAPI_TYPE_NUMBER:
+        case LITE3_NAPI_TYPE_INTEGER: {
+            double num;
+            status = napi_get_value_double(env, value, &num);
+            if (status == napi_number_expected) break;
+            if (status != napi_ok) return status;
+
+            int rc = spec->type == LITE3_NAPI_TYPE_INTEGER
+                    && num >= -MAX_SAFE_INTEGER && num <= MAX_SAFE_INTEGER
+                    && num == (double)(int64_t)num
+                    && !(num == 0 && signbit(num))
+                ? out_i64(out, offset, key, (int64_t)num)
+                : out_f64(out, offset, key, num);
+            if (rc != 0) return out_failure(env, out);
+            return napi_ok;
+        }
+
+        case LITE3_NAPI_TYPE_BIGINT: {
+            int64_t num;
+            bool lossless;
+            status = napi_get_value_bigint_int64(env, value, &num, &lossless);
+            if (status == napi_bigint_expected) break;
+            if (status != napi_ok) return status;
+            if (!lossless) {
+                napi_throw_range_error(env, NULL, "BigInt value does not fit in a signed 64-bit integer");
+                return napi_invalid_arg;
+            }
+            if (out_i64(out, offset, key, num) != 0) return out_failure(env, out);
+            return napi_ok;
+        }
+
+        case LITE3_NAPI_TYPE_BOOLEAN: {
+            bool b;
+            status = napi_get_value_bool(env, value, &b);
+            if (status == napi_boolean_expected) break;
+            if (status != napi_ok) return status;
+            if (out_bool(out, offset, key, b) != 0) return out_failure(env, out);
+            return napi_ok;
+        }
+
+        case LITE3_NAPI_TYPE_OBJECT: {
+            napi_valuetype type;
+            status = napi_typeof(env, value, &type);
+            if (status != napi_ok) return status;
+            if (type != napi_object) break;
+
+            container_kind kind;
+            status = classify_container(env, value, &kind);
+            if (status != napi_ok) return status;
+            if (kind != CONTAINER_OBJECT) break;
+
+            size_t new_offset;
+            if (out_obj(out, offset, key, &new_offset) != 0) return out_failure(env, out);
+            return encode_shape(env, value, spec->shape, out, new_offset);
+        }
+
+        case LITE3_NAPI_TYPE_ARRAY: {
+            bool is_array;
+            status = napi_is_array(env, value, &is_array);
+            if (status != napi_ok) return status;
+            if (!is_array) break;
+
+            size_t new_offset;
+            if (out_arr(out, offset, key, &new_offset) != 0) return out_failure(env, out);
+
+            uint32_t length;
+            status = napi_get_array_length(env, value, &length);
+            if (status != napi_ok) return status;
+            for (uint32_t i = 0; i < length; i++) {
+                napi_value element;
+                status = napi_get_element(env, value, i, &element);
+                if (status != napi_ok) return status;
+                status = encode_typed(env, NULL, element, spec->element, out, new_offset);
+                if (status != napi_ok) return status;
+            }
+            return napi_ok;
+        }
+
+        case LITE3_NAPI_TYPE_BYTES:
+        case LITE3_NAPI_TYPE_ANY:
+        default:
+            break;
+    }
+
+    return encode_element(env, key, value, key == NULL, out, offset);
+}
+
+// Fill the object at `offset` with the fields of `shape`, read from `value`
+// by their precreated names. Properties not in the shape are ignored.
+static napi_status
+encode_shape(napi_env env, napi_value value, const lite3_napi_shape *shape, encode_target *out, size_t offset) {
+    napi_value names;
+    napi_status status = napi_get_reference_value(env, shape->names, &names);
+    if (status != napi_ok) return status;
+
+    for (uint32_t i = 0; i < shape->count; i++) {
+        const lite3_napi_shape_field *field = &shape->fields[i];
+
+        napi_value name, property_value;
+        status = napi_get_element(env, names, i, &name);
+        if (status != napi_ok) return status;
+        status = napi_get_property(env, value, name, &property_value);
+        if (status != napi_ok) return status;
+
+        status = encode_typed(env, field->key, property_value, &field->spec, out, offset);
+        if (status != napi_ok) return status;
+    }
+    return napi_ok;
+}
+
+// Initialise the root of `out` to match `value` and fill it with element
+// data, or with the fields of `shape` if one is given.
+static napi_status
+encode_root(napi_env env, napi_value value, const lite3_napi_shape *shape, encode_target *out) {
+    container_kind kind;
+    napi_status status = classify_container(env, value, &kind);
+    if (status != napi_ok) return status;
+    if (kind == CONTAINER_BYTES) {
+        napi_throw_type_error(env, NULL, "Binary data cannot be the root of a message");
+        return napi_invalid_arg;
+    }
+    if (shape && kind != CONTAINER_OBJECT) {
+        napi_throw_type_error(env, NULL, "Argument must be an object");
+        return napi_invalid_arg;
+    }
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    bool timed = LITE3_NAPI_STATS_ON(instance);
+    uint64_t start = timed ? lite3_napi_stats_clock() : 0;
+    size_t initial_bufsz = out->ctx ? out->ctx->bufsz : 0;
+
+    // Prime the target with the appropriate type:
+    if (out_init(out, kind != CONTAINER_OBJECT) != 0) return out_failure(env, out);
+
+    // Fill it with element data:
+    target_init(out);
+    status = shape
+        ? encode_shape(env, value, shape, out, 0)
+        : encode_container(env, value, kind, out, 0);
+    target_release(env, out);
+
+    if (timed) {
+        if (out->ctx && out->ctx->bufsz != initial_bufsz) instance->stats.reallocs++;
+        lite3_napi_stats_record(instance, LITE3_NAPI_PHASE_ENCODE, start, out->ctx ? out->ctx->buflen : out->buflen);
+    }
+    return status;
+}
+
+// Prime `ctx` with the root type of `value` and fill it with element data.
+// Any previous contents of `ctx` are discarded.
+napi_status
+lite3_napi_encode_root(napi_env env, napi_value value, lite3_ctx *ctx, const lite3_napi_encode_options *options) {
+    encode_target out = { .ctx = ctx, .options = *options };
+    return encode_root(env, value, NULL, &out);
+}
+
+// Like lite3_napi_encode_root(), but `value` is written as an object of the
+// fields in `shape`.
+napi_status
+lite3_napi_encode_shape(napi_env env, napi_value value, const lite3_napi_shape *shape, lite3_ctx *ctx,
+                        const lite3_napi_encode_options *options) {
+    encode_target out = { .ctx = ctx, .options = *options };
+    return encode_root(env, value, shape, &out);
+}
+
+// Encode `value` as a whole message into fixed memory. `*written` is the
+// message length; if the memory ran out, `*overflow` is set instead and no
+// exception is pending.
+napi_status
+lite3_napi_encode_root_into(napi_env env, napi_value value, unsigned char *buf, size_t bufsz,
+                            const lite3_napi_encode_options *options, size_t *written, bool *overflow) {
+    encode_target out = {
+        .buf = buf,
+        .bufsz = bufsz,
+        .options = *options,
+    };
+    napi_status status = encode_root(env, value, NULL, &out);
+    *written = out.buflen;
+    *overflow = out.overflow;
+    return status;
+}
+
+// Write `value` into an existing message in fixed memory: under `key` in the
+// object at `ofs`, or appended to the array at `ofs` if `key` is NULL.
+// `*buflen` is updated to the new message length. If the memory ran out,
+// `*overflow` is set and no exception is pending; a single primitive write
+// then leaves the message unchanged, but a nested value may be half written.
+napi_status
+lite3_napi_encode_value_at(napi_env env, napi_value value, unsigned char *buf, size_t *buflen, size_t bufsz,
+                           size_t ofs, const char *key, const lite3_napi_encode_options *options, bool *overflow) {
+    encode_target out = {
+        .buf = buf,
+        .buflen = *buflen,
+        .bufsz = bufsz,
+        .options = *options,
+    };
+    target_init(&out);
+    napi_status status = encode_element(env, key, value, key == NULL, &out, ofs);
+    target_release(env, &out);
+
+    *buflen = out.buflen;
+    *overflow = out.overflow;
+    return status;
+}
+
+// Size `value` takes as a standalone message, or 0 if it is not an object or
+// array (binary data and primitives are written with a single call).
+napi_status
+lite3_napi_measure_value(napi_env env, napi_value value, const lite3_napi_encode_options *options, size_t *result) {
+    *result = 0;
+
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, value, &type);
+    if (status != napi_ok || type != napi_object) return status;
+
+    container_kind kind;
+    status = classify_container(env, value, &kind);
+    if (status != napi_ok || kind == CONTAINER_BYTES) return status;
+
+    lite3_ctx *ctx = lite3_ctx_create();
+    if (!ctx) {
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return napi_generic_failure;
+    }
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), contexts);
+    status = lite3_napi_encode_root(env, value, ctx, options);
+    if (status == napi_ok) *result = ctx->buflen;
+    lite3_ctx_destroy(ctx);
+    return status;
+}
+
+// Read the options shared by every encode entry point from `options`
+// (an object, or NULL/undefined for the defaults).
+napi_status
+lite3_napi_get_encode_options(napi_env env, napi_value options, lite3_napi_encode_options *result) {
+    return lite3_napi_get_bool_option(env, options, "integers", false, &result->integers);
+}
+
+// Finalizer for Buffers that own a lite3 context's memory.
+static void
+finalize_ctx_buffer(napi_env env, void *data, void *hint) {
+    (void)data;  // points into the context, freed along with it
+
+    lite3_ctx *ctx = hint;
+    int64_t adjusted;
+    napi_adjust_external_memory(env, -(int64_t)ctx->bufsz, &adjusted);
+    lite3_ctx_destroy(ctx);
+}
+
+// Turn a finished context into a Buffer. Ownership of `ctx` always passes to
+// this function: either its memory is handed to JS as an external Buffer
+// (freed by the GC), or it is copied out and the context destroyed.
+//
+// Small messages, and contexts where more than half the allocation is unused
+// slack, are copied instead so we don't pin a mostly-empty buffer.
+napi_status
+lite3_napi_ctx_to_buffer(napi_env env, lite3_ctx *ctx, bool zero_copy, napi_value *result) {
+    napi_status status;
+
+    if (zero_copy && ctx->buflen >= ZERO_COPY_MIN_LENGTH && ctx->bufsz - ctx->buflen <= ctx->buflen) {
+        status = napi_create_external_buffer(env, ctx->buflen, ctx->buf, finalize_ctx_buffer, ctx, result);
+        if (status == napi_ok) {
+            int64_t adjusted;
+            napi_adjust_external_memory(env, (int64_t)ctx->bufsz, &adjusted);
+            return napi_ok;
+        }
+        // Runtimes may refuse external buffers (napi_no_external_buffers_allowed);
+        // fall through and copy instead.
+    }
+
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), copies);
+    status = napi_create_buffer_copy(env, ctx->buflen, ctx->buf, NULL, result);
+    lite3_ctx_destroy(ctx);
+    return status;
+}
+
 // Encode the argument into a Buffer and return to caller
+//   encode(value, options?)
+//     options.zeroCopy - hand the encoder's memory to the Buffer instead of
+//                        copying it (default: true)
+//     options.integers - store integral numbers in the safe integer range as
+//                        i64 rather than f64 (default: false)
 napi_value
 encode(napi_env env, napi_callback_info info) {
     // Check type of `info`, must be object or array:
-    size_t argc = 1;
-    napi_value argv[1];
+    size_t argc = 2;
+    napi_value argv[2];
     NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
-    if (argc != 1) {
-        napi_throw_type_error(env, NULL, "Expected one argument");
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
         return NULL;
     }
 
@@ -207,33 +835,173 @@ encode(napi_env env, napi_callback_info info) {
         return NULL;
     }
 
+    bool zero_copy;
+    NAPI_CALL(env, NULL, lite3_napi_get_bool_option(env, argc > 1 ? argv[1] : NULL, "zeroCopy", true, &zero_copy), NULL);
+    lite3_napi_encode_options options;
+    NAPI_CALL(env, NULL, lite3_napi_get_encode_options(env, argc > 1 ? argv[1] : NULL, &options), NULL);
+
     // Create a Lite3 context to receive our encoded data:
     lite3_ctx *ctx = lite3_ctx_create();
     if (!ctx) {
         napi_throw_error(env, NULL, "Failed to create Lite3 context");
         return NULL;
     }
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), contexts);
 
-    bool is_array;
-    NAPI_CALL(env, ctx, napi_is_array(env, argv[0], &is_array), NULL);
-
-    // Prime the Lite3 context with the appropriate type:
-    if (is_array) LITE3_CALL(env, ctx, lite3_ctx_init_arr(ctx), NULL);
-    else LITE3_CALL(env, ctx, lite3_ctx_init_obj(ctx), NULL);
-
-    // Fill that context with element data:
-    NAPI_CALL(env, ctx, encode_enumerable(env, argv[0], is_array, ctx, 0), NULL);
+    NAPI_CALL(env, ctx, lite3_napi_encode_root(env, argv[0], ctx, &options), NULL);
 
 #ifdef LITE3_DEBUG && LITE3_JSON
     lite3_ctx_json_print(ctx, 0); // For debugging
 #endif
 
-    // Convert to a Buffer:
-    // TODO: Can we not copy? Can we make this an external or something?
+    // Convert to a Buffer (this consumes ctx):
     napi_value result;
-    NAPI_CALL(env, ctx, napi_create_buffer_copy(env, ctx->buflen, ctx->buf, NULL, &result), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_ctx_to_buffer(env, ctx, zero_copy, &result), NULL);
+
+    return result;
+}
+
+// Resolve a Buffer, TypedArray, DataView or ArrayBuffer to its memory.
+static napi_status
+get_target_memory(napi_env env, napi_value value, unsigned char **data, size_t *length) {
+    napi_status status;
+    bool is_type;
+
+    status = napi_is_typedarray(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        napi_typedarray_type array_type;
+        size_t element_count;
+        status = napi_get_typedarray_info(env, value, &array_type, &element_count, (void **)data, NULL, NULL);
+        if (status != napi_ok) return status;
+
+        size_t element_size;
+        switch (array_type) {
+            case napi_int16_array: case napi_uint16_array: element_size = 2; break;
+            case napi_int32_array: case napi_uint32_array: case napi_float32_array: element_size = 4; break;
+            case napi_float64_array: case napi_bigint64_array: case napi_biguint64_array: element_size = 8; break;
+            default: element_size = 1; break;
+        }
+        *length = element_count * element_size;
+        return napi_ok;
+    }
+
+    status = napi_is_dataview(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        return napi_get_dataview_info(env, value, length, (void **)data, NULL, NULL);
+    }
+
+    status = napi_is_arraybuffer(env, value, &is_type);
+    if (status != napi_ok) return status;
+    if (is_type) {
+        return napi_get_arraybuffer_info(env, value, (void **)data, length);
+    }
+
+    napi_throw_type_error(env, NULL, "Target must be a Buffer, TypedArray, DataView or ArrayBuffer");
+    return napi_invalid_arg;
+}
+
+// Encode the argument directly into caller-supplied memory
+//   encodeInto(value, target, offset?, options?) -> number
+//     options.integers - as for encode()
+// Returns the number of bytes written at `offset`. If the message does not
+// fit, nothing meaningful is written and the negated number of bytes the
+// message needs is returned instead (the target's contents past `offset` are
+// then unspecified).
+//
+// The walk writes into the target while getters on the value run. A getter
+// that detaches or shrinks the target leaves those writes going to memory it
+// no longer owns; this is detected afterwards and thrown as a TypeError, but
+// can't be undone.
+napi_value
+encode_into(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 2) {
+        napi_throw_type_error(env, NULL, "Expected 2-4 arguments: value, target, offset, options");
+        return NULL;
+    }
+
+    napi_valuetype type;
+    NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    if (type != napi_object) {
+        napi_throw_type_error(env, NULL, "Argument must be an array or object");
+        return NULL;
+    }
+
+    unsigned char *data;
+    size_t length;
+    NAPI_CALL(env, NULL, get_target_memory(env, argv[1], &data, &length), NULL);
+
+    int64_t offset = 0;
+    if (argc > 2) {
+        napi_valuetype offset_type;
+        NAPI_CALL(env, NULL, napi_typeof(env, argv[2], &offset_type), NULL);
+        if (offset_type != napi_undefined) {
+            NAPI_CALL(env, NULL, napi_get_value_int64(env, argv[2], &offset), NULL);
+        }
+    }
+    if (offset < 0 || (uint64_t)offset > length) {
+        napi_throw_range_error(env, NULL, "Offset is outside the target");
+        return NULL;
+    }
+
+    lite3_napi_encode_options options;
+    NAPI_CALL(env, NULL, lite3_napi_get_encode_options(env, argc > 3 ? argv[3] : NULL, &options), NULL);
+
+    size_t written;
+    bool overflow;
+    napi_status status = lite3_napi_encode_root_into(env, argv[0], data + offset, length - (size_t)offset,
+                                                     &options, &written, &overflow);
+
+    // A detached target reads back as NULL and 0 bytes, a shrunk one as
+    // fewer bytes:
+    if (status == napi_ok || overflow) {
+        unsigned char *data_after;
+        size_t length_after;
+        NAPI_CALL(env, NULL, get_target_memory(env, argv[1], &data_after, &length_after), NULL);
+        if (data_after != data || length_after < length) {
+            napi_throw_type_error(env, NULL, "Target was detached or resized while encoding");
+            return NULL;
+        }
+    }
+
+    napi_value result;
+    if (status == napi_ok) {
+        NAPI_CALL(env, NULL, napi_create_double(env, (double)written, &result), NULL);
+        return result;
+    }
+    if (!overflow) {
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    // Out of room: measure the message with a growable context so the caller
+    // can size the next attempt.
+    lite3_ctx *ctx = lite3_ctx_create();
+    if (!ctx) {
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return NULL;
+    }
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), contexts);
+    NAPI_CALL(env, ctx, lite3_napi_encode_root(env, argv[0], ctx, &options), NULL);
+    NAPI_CALL(env, ctx, napi_create_double(env, -(double)ctx->buflen, &result), NULL);
     lite3_ctx_destroy(ctx);
 
     return result;
 }
 
+// Number of heap allocations the encode walk has made since the addon loaded
+//   getEncodeAllocations() -> number
+// Encoding typical records performs none; only strings too long for the
+// inline scratch space allocate.
+napi_value
+get_encode_allocations(napi_env env, napi_callback_info info) {
+    (void)info;  // unused
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_double(env, instance ? (double)instance->encode_allocations : 0, &result), NULL);
+    return result;
+}
@@ -0,0 +1,244 @@
+/**
+ * Reusable Encoder
+ *
+ * A native class wrapping a lite3_ctx that is kept across encode() calls.
+ * The context is re-initialised for every message, so once it has grown to
+ * fit the typical message size, steady-state encoding does no heap growth.
+ *
+ * The encoder also learns a capacity hint from the messages it has produced
+ * (a slowly decaying maximum of recent message sizes). The hint is used to
+ * pre-size the context when it has to be (re)created, and to release memory
+ * after a one-off outlier message inflated the context.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3_context_api.h>
+#include <stdlib.h>
+
+// Smallest context we will create, regardless of configuration.
+#define ENCODER_MIN_CAPACITY 1024
+
+// Default initial capacity when none is configured.
+#define ENCODER_DEFAULT_CAPACITY 4096
+
+// Shrink the context once it is this many times larger than the hint.
+#define ENCODER_SHRINK_FACTOR 4
+
+typedef struct {
+    lite3_ctx *ctx;
+    size_t initial_capacity;
+    size_t capacity_hint;
+    lite3_napi_encode_options options;
+    bool busy;  // encode() is walking a value, whose getters may call back in
+} lite3_napi_encoder;
+
+// Capacity to allocate for a given hint: the hint plus 25% headroom.
+static size_t
+capacity_for_hint(const lite3_napi_encoder *enc) {
+    size_t capacity = enc->capacity_hint + enc->capacity_hint / 4;
+    return capacity > enc->initial_capacity ? capacity : enc->initial_capacity;
+}
+
+// Replace the encoder's context with a fresh one of `capacity` bytes.
+static bool
+encoder_recreate_ctx(napi_env env, lite3_napi_encoder *enc, size_t capacity) {
+    lite3_ctx *ctx = lite3_ctx_create_with_size(capacity);
+    if (!ctx) return false;
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), contexts);
+    if (enc->ctx) lite3_ctx_destroy(enc->ctx);
+    enc->ctx = ctx;
+    return true;
+}
+
+static void
+encoder_finalize(napi_env env, void *data, void *hint) {
+    (void)env;
+    (void)hint;
+
+    lite3_napi_encoder *enc = data;
+    if (enc->ctx) lite3_ctx_destroy(enc->ctx);
+    free(enc);
+}
+
+static lite3_napi_encoder *
+unwrap_encoder(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv) {
+    napi_value this_arg;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, argc, argv, &this_arg, NULL), NULL);
+
+    lite3_napi_encoder *enc;
+    NAPI_CALL(env, NULL, napi_unwrap(env, this_arg, (void **)&enc), NULL);
+    return enc;
+}
+
+// Throw if the encoder is in the middle of encode(). A getter on the value
+// being encoded could otherwise replace the context under the walk.
+static bool
+encoder_check_idle(napi_env env, const lite3_napi_encoder *enc) {
+    if (!enc->busy) return true;
+    napi_throw_error(env, NULL, "Encoder cannot be used while it is encoding");
+    return false;
+}
+
+/**
+ * new Encoder(options?)
+ *   options.initialCapacity - bytes to allocate up front (default: 4096)
+ *   options.integers        - as for encode() (default: false)
+ */
+static napi_value
+encoder_constructor(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    napi_value this_arg;
+    napi_value new_target;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, &this_arg, NULL), NULL);
+    NAPI_CALL(env, NULL, napi_get_new_target(env, info, &new_target), NULL);
+    if (new_target == NULL) {
+        napi_throw_type_error(env, NULL, "Encoder must be called with new");
+        return NULL;
+    }
+
+    uint32_t initial_capacity;
+    NAPI_CALL(env, NULL, lite3_napi_get_uint32_option(env, argc > 0 ? argv[0] : NULL, "initialCapacity",
+                                                      ENCODER_DEFAULT_CAPACITY, &initial_capacity), NULL);
+
+    lite3_napi_encode_options options;
+    NAPI_CALL(env, NULL, lite3_napi_get_encode_options(env, argc > 0 ? argv[0] : NULL, &options), NULL);
+
+    lite3_napi_encoder *enc = calloc(1, sizeof(*enc));
+    if (!enc) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return NULL;
+    }
+    enc->options = options;
+    enc->initial_capacity = initial_capacity < ENCODER_MIN_CAPACITY ? ENCODER_MIN_CAPACITY : initial_capacity;
+
+    if (!encoder_recreate_ctx(env, enc, enc->initial_capacity)) {
+        free(enc);
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return NULL;
+    }
+
+    napi_status status = napi_wrap(env, this_arg, enc, encoder_finalize, NULL, NULL);
+    if (status != napi_ok) {
+        encoder_finalize(env, enc, NULL);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    return this_arg;
+}
+
+/**
+ * encoder.encode(value) -> Buffer
+ * Encodes an object or array, reusing the encoder's context.
+ */
+static napi_value
+encoder_encode(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_encoder *enc = unwrap_encoder(env, info, &argc, argv);
+    if (!enc || !encoder_check_idle(env, enc)) return NULL;
+
+    if (argc != 1) {
+        napi_throw_type_error(env, NULL, "Expected one argument");
+        return NULL;
+    }
+
+    napi_valuetype type;
+    NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    if (type != napi_object) {
+        napi_throw_type_error(env, NULL, "Argument must be an array or object");
+        return NULL;
+    }
+
+    // Pre-size from the hint if the context is smaller than what we expect:
+    if (enc->ctx->bufsz < enc->capacity_hint && !encoder_recreate_ctx(env, enc, capacity_for_hint(enc))) {
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return NULL;
+    }
+
+    enc->busy = true;
+    napi_status status = lite3_napi_encode_root(env, argv[0], enc->ctx, &enc->options);
+    enc->busy = false;
+    NAPI_CALL(env, NULL, status, NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_buffer_copy(env, enc->ctx->buflen, enc->ctx->buf, NULL, &result), NULL);
+
+    // Learn from this message: a maximum that decays by 1/8 per message, so a
+    // single large message doesn't pin the hint forever.
+    size_t decayed = enc->capacity_hint - enc->capacity_hint / 8;
+    enc->capacity_hint = enc->ctx->buflen > decayed ? enc->ctx->buflen : decayed;
+
+    // Give back memory after an outlier. Failure here is harmless; we simply
+    // keep the larger context.
+    size_t target = capacity_for_hint(enc);
+    if (enc->ctx->bufsz > target * ENCODER_SHRINK_FACTOR) {
+        encoder_recreate_ctx(env, enc, target);
+    }
+
+    return result;
+}
+
+/**
+ * encoder.reset() -> undefined
+ * Forgets the learned capacity hint and shrinks the context back to its
+ * initial capacity.
+ */
+static napi_value
+encoder_reset(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_encoder *enc = unwrap_encoder(env, info, &argc, NULL);
+    if (!enc || !encoder_check_idle(env, enc)) return NULL;
+
+    enc->capacity_hint = 0;
+    if (enc->ctx->bufsz != enc->initial_capacity && !encoder_recreate_ctx(env, enc, enc->initial_capacity)) {
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return NULL;
+    }
+
+    return NULL;
+}
+
+/**
+ * encoder.capacity -> number
+ * Bytes currently allocated by the encoder's context.
+ */
+static napi_value
+encoder_get_capacity(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_encoder *enc = unwrap_encoder(env, info, &argc, NULL);
+    if (!enc) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_double(env, (double)enc->ctx->bufsz, &result), NULL);
+    return result;
+}
+
+/**
+ * encoder.capacityHint -> number
+ * The message size the encoder currently expects.
+ */
+static napi_value
+encoder_get_capacity_hint(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_encoder *enc = unwrap_encoder(env, info, &argc, NULL);
+    if (!enc) return NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_double(env, (double)enc->capacity_hint, &result), NULL);
+    return result;
+}
+
+napi_status
+encoder_define_class(napi_env env, napi_value *result) {
+    napi_property_descriptor props[] = {
+        { "encode", NULL, encoder_encode, NULL, NULL, NULL, napi_default_method, NULL },
+        { "reset", NULL, encoder_reset, NULL, NULL, NULL, napi_default_method, NULL },
+        { "capacity", NULL, NULL, encoder_get_capacity, NULL, NULL, napi_default, NULL },
+        { "capacityHint", NULL, NULL, encoder_get_capacity_hint, NULL, NULL, napi_default, NULL }
+    };
+
+    return napi_define_class(env, "Encoder", NAPI_AUTO_LENGTH, encoder_constructor, NULL,
+                             a_count(props), props, result);
+}
@@ -0,0 +1,242 @@
+/**
+ * Memory-mapped files
+ *
+ * mapFile() maps a lite3 file into memory and returns a Buffer over the
+ * mapping, so Lite3Buffer proxies, getPath() and the proxy functions read a
+ * file of any size without loading it first. Opening costs the same whatever
+ * the file's size; pages are read from disk only when a lookup touches them,
+ * and are shared through the page cache with every other process mapping the
+ * same file.
+ *
+ * The file is opened read-only and mapped copy-on-write, so writes to the
+ * Buffer change only this process's copy of the pages they touch, never the
+ * file. The mapping is released when the
+ * Buffer is garbage collected. As with any mapping, shrinking the file while
+ * it is mapped makes reads past its new end fault.
+ *
+ * Pages this process hasn't written still show later writes to the file, so
+ * the mapping's ArrayBuffer is type-tagged and verify() never marks a Buffer
+ * over it (see addon_verify.c).
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <uv.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Marks the ArrayBuffer behind each mapping:
+const napi_type_tag lite3_napi_mapped_type_tag = {
+    0x6c697465336d6d61ULL, 0x7070656466696c65ULL
+};
+
+#ifdef _WIN32
+
+// Map the file at `path` (UTF-8). Returns 0 or a libuv error code; an empty
+// file maps to NULL.
+static int
+mmap_file(const char *path, void **data, size_t *length) {
+    *data = NULL;
+    *length = 0;
+
+    int wlen = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    if (wlen <= 0) return uv_translate_sys_error(GetLastError());
+    wchar_t *wpath = malloc((size_t)wlen * sizeof(*wpath));
+    if (!wpath) return UV_ENOMEM;
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, wlen);
+
+    // Opening a directory fails with ERROR_ACCESS_DENIED, so report it as
+    // fs does before trying:
+    DWORD attributes = GetFileAttributesW(wpath);
+    if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        free(wpath);
+        return UV_EISDIR;
+    }
+
+    HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    free(wpath);
+    if (file == INVALID_HANDLE_VALUE) return uv_translate_sys_error(GetLastError());
+    if (GetFileType(file) != FILE_TYPE_DISK) {
+        CloseHandle(file);
+        return UV_EINVAL;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        DWORD error = GetLastError();
+        CloseHandle(file);
+        return uv_translate_sys_error(error);
+    }
+    if ((uint64_t)size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return UV_EFBIG;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    DWORD error = mapping ? 0 : GetLastError();
+    CloseHandle(file);
+    if (!mapping) return uv_translate_sys_error(error);
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    error = view ? 0 : GetLastError();
+    CloseHandle(mapping);
+    if (!view) return uv_translate_sys_error(error);
+
+    *data = view;
+    *length = (size_t)size.QuadPart;
+    return 0;
+}
+
+static void
+munmap_file(void *data, size_t length) {
+    (void)length;
+    UnmapViewOfFile(data);
+}
+
+#else
+
+// Map the file at `path`. Returns 0 or a libuv error code; an empty file
+// maps to NULL.
+static int
+mmap_file(const char *path, void **data, size_t *length) {
+    *data = NULL;
+    *length = 0;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return uv_translate_sys_error(errno);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        int error = errno;
+        close(fd);
+        return uv_translate_sys_error(error);
+    }
+    if (S_ISDIR(st.st_mode)) {
+        close(fd);
+        return UV_EISDIR;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        return UV_EINVAL;
+    }
+    if ((uint64_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return UV_EFBIG;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;     // no swap is reserved for pages never written
+#endif
+    void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    int error = mapped == MAP_FAILED ? errno : 0;
+    close(fd);
+    if (mapped == MAP_FAILED) return uv_translate_sys_error(error);
+
+    *data = mapped;
+    *length = (size_t)st.st_size;
+    return 0;
+}
+
+static void
+munmap_file(void *data, size_t length) {
+    munmap(data, length);
+}
+
+#endif
+
+static void
+finalize_mapping(napi_env env, void *data, void *hint) {
+    (void)env;
+    munmap_file(data, (size_t)(uintptr_t)hint);
+}
+
+// Throw an Error like Node's fs errors: "ENOENT: no such file or directory,
+// mmap 'path'", with `code` set.
+static void
+throw_file_error(napi_env env, int error, const char *path) {
+    char message[512];
+    snprintf(message, sizeof(message), "%s: %s, mmap '%s'", uv_err_name(error), uv_strerror(error), path);
+    napi_throw_error(env, uv_err_name(error), message);
+}
+
+/**
+ * mapFile(path) -> Buffer
+ * Maps the lite3 file at `path` read-only and returns a Buffer over it.
+ */
+napi_value
+map_file(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    if (type != napi_string) {
+        napi_throw_type_error(env, NULL, "Path must be a string");
+        return NULL;
+    }
+
+    size_t path_len;
+    NAPI_CALL(env, NULL, napi_get_value_string_utf8(env, argv[0], NULL, 0, &path_len), NULL);
+    char *path = malloc(path_len + 1);
+    if (!path) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return NULL;
+    }
+    napi_status status = napi_get_value_string_utf8(env, argv[0], path, path_len + 1, NULL);
+    if (status != napi_ok) {
+        free(path);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    void *data;
+    size_t length;
+    int error = mmap_file(path, &data, &length);
+    if (error != 0) {
+        throw_file_error(env, error, path);
+        free(path);
+        return NULL;
+    }
+    free(path);
+    if (length == 0) {
+        napi_throw_error(env, NULL, "File is empty");
+        return NULL;
+    }
+
+    napi_value result;
+    status = napi_create_external_buffer(env, length, data, finalize_mapping, (void *)(uintptr_t)length, &result);
+    if (status != napi_ok) {
+        munmap_file(data, length);
+        if (status == napi_no_external_buffers_allowed) {
+            napi_throw_error(env, NULL, "This runtime does not allow Buffers over mapped memory");
+            return NULL;
+        }
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    napi_value arraybuffer;
+    NAPI_CALL(env, NULL, napi_get_typedarray_info(env, result, NULL, NULL, NULL, &arraybuffer, NULL), NULL);
+    NAPI_CALL(env, NULL, napi_type_tag_object(env, arraybuffer, &lite3_napi_mapped_type_tag), NULL);
+    return result;
+}
@@ -0,0 +1,465 @@
+/**
+ * JSON text <-> lite3
+ *
+ * fromJSON() and toJSON() convert between JSON text and lite3 messages
+ * entirely in C (yyjson via lite3's JSON support), without creating any JS
+ * objects. JSON can be given as a string or as a Buffer of UTF-8 bytes, and
+ * toJSON() can return a Buffer so egress never transcodes to a JS string.
+ *
+ * The Async variants do the conversion on the libuv threadpool for inputs of
+ * at least `asyncThreshold` bytes.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <lite3_context_api.h>
+#include <stdlib.h>
+
+// JSON text, either copied out of a JS string or borrowed from a Buffer.
+typedef struct {
+    const char *data;
+    size_t len;
+    char *owned;            // malloc'd copy of a string, or NULL
+    napi_ref source;        // keeps a borrowed Buffer alive, or NULL
+} json_text;
+
+typedef struct {
+    napi_async_work work;
+    napi_deferred deferred;
+    json_text text;
+    bool zero_copy;
+    lite3_ctx *ctx;         // result
+    const char *error;      // static message, if the conversion failed
+} from_json_job;
+
+typedef struct {
+    napi_async_work work;
+    napi_deferred deferred;
+    napi_ref buffer;        // keeps the message alive while the job runs
+    const unsigned char *buf;
+    size_t buflen;
+    size_t offset;
+    bool verified;          // Buffer passed verify(); skip the off-thread walk
+    bool as_buffer;
+    char *json;             // result
+    size_t json_len;
+    const char *error;      // static message, if the conversion failed
+} to_json_job;
+
+// Get JSON text from a string or Buffer. With `keep`, a borrowed Buffer is
+// referenced so the text stays valid off-thread.
+static napi_status
+json_text_get(napi_env env, napi_value value, bool keep, json_text *text) {
+    *text = (json_text){ 0 };
+
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, value, &type);
+    if (status != napi_ok) return status;
+
+    if (type == napi_string) {
+        status = napi_get_value_string_utf8(env, value, NULL, 0, &text->len);
+        if (status != napi_ok) return status;
+        text->owned = malloc(text->len + 1);
+        if (!text->owned) {
+            napi_throw_error(env, NULL, "Memory allocation failure");
+            return napi_generic_failure;
+        }
+        status = napi_get_value_string_utf8(env, value, text->owned, text->len + 1, NULL);
+        if (status != napi_ok) {
+            free(text->owned);
+            text->owned = NULL;
+            return status;
+        }
+        text->data = text->owned;
+        return napi_ok;
+    }
+
+    bool is_buffer = false;
+    if (type == napi_object) {
+        status = napi_is_buffer(env, value, &is_buffer);
+        if (status != napi_ok) return status;
+    }
+    if (!is_buffer) {
+        napi_throw_type_error(env, NULL, "JSON must be a string or a Buffer");
+        return napi_invalid_arg;
+    }
+
+    void *data;
+    status = napi_get_buffer_info(env, value, &data, &text->len);
+    if (status != napi_ok) return status;
+    text->data = data;
+    return keep ? napi_create_reference(env, value, 1, &text->source) : napi_ok;
+}
+
+static void
+json_text_free(napi_env env, json_text *text) {
+    free(text->owned);
+    if (text->source) napi_delete_reference(env, text->source);
+    *text = (json_text){ 0 };
+}
+
+// Parse JSON text into a new context. Safe to run off-thread. Returns NULL
+// on success, or an error message.
+static const char *
+json_to_ctx(const char *json, size_t len, lite3_ctx **result) {
+    *result = lite3_ctx_create();
+    if (!*result) return "Failed to create Lite3 context";
+
+    if (lite3_ctx_json_dec(*result, json, len) != 0) {
+        lite3_ctx_destroy(*result);
+        *result = NULL;
+        return "Invalid JSON, or its root is not an object or array";
+    }
+    return NULL;
+}
+
+// Settle a fromJSON promise with the finished context (which this consumes).
+static void
+settle_from_json(napi_env env, napi_deferred deferred, lite3_ctx *ctx, const char *error, bool zero_copy) {
+    if (error) {
+        lite3_napi_reject_with_message(env, deferred, error);
+        return;
+    }
+
+    napi_value result;
+    if (lite3_napi_ctx_to_buffer(env, ctx, zero_copy, &result) == napi_ok) {
+        napi_resolve_deferred(env, deferred, result);
+    } else {
+        lite3_napi_reject_pending(env, deferred);
+    }
+}
+
+static void
+from_json_execute(napi_env env, void *data) {
+    (void)env;
+
+    from_json_job *job = data;
+    job->error = json_to_ctx(job->text.data, job->text.len, &job->ctx);
+}
+
+static void
+from_json_complete(napi_env env, napi_status status, void *data) {
+    from_json_job *job = data;
+    if (status == napi_ok) {
+        settle_from_json(env, job->deferred, job->ctx, job->error, job->zero_copy);
+    } else {
+        if (job->ctx) lite3_ctx_destroy(job->ctx);
+        lite3_napi_reject_with_message(env, job->deferred, "Operation cancelled");
+    }
+
+    json_text_free(env, &job->text);
+    napi_delete_async_work(env, job->work);
+    free(job);
+}
+
+// Convert JSON text (a string or Buffer) to a lite3 Buffer, returning a
+// promise. Conversion runs on the threadpool if the text is at least
+// `options.asyncThreshold` bytes; `options.zeroCopy` is as for encode().
+napi_status
+lite3_napi_from_json_promise(napi_env env, napi_value value, napi_value options, const char *resource,
+                             napi_value *promise) {
+    bool zero_copy;
+    uint32_t threshold;
+    napi_status status = lite3_napi_get_bool_option(env, options, "zeroCopy", true, &zero_copy);
+    if (status != napi_ok) return status;
+    status = lite3_napi_get_uint32_option(env, options, "asyncThreshold", LITE3_NAPI_ASYNC_THRESHOLD, &threshold);
+    if (status != napi_ok) return status;
+
+    // Borrowed text is kept alive, in case it is converted off-thread:
+    json_text text;
+    status = json_text_get(env, value, true, &text);
+    if (status != napi_ok) return status;
+
+    napi_deferred deferred;
+    status = napi_create_promise(env, &deferred, promise);
+    if (status != napi_ok) {
+        json_text_free(env, &text);
+        return status;
+    }
+
+    // Small inputs: convert right here.
+    if (text.len < threshold) {
+        lite3_ctx *ctx;
+        const char *error = json_to_ctx(text.data, text.len, &ctx);
+        json_text_free(env, &text);
+        settle_from_json(env, deferred, ctx, error, zero_copy);
+        return napi_ok;
+    }
+
+    from_json_job *job = calloc(1, sizeof(*job));
+    if (!job) {
+        json_text_free(env, &text);
+        lite3_napi_reject_with_message(env, deferred, "Memory allocation failure");
+        return napi_ok;
+    }
+    job->deferred = deferred;
+    job->zero_copy = zero_copy;
+    job->text = text;
+
+    status = lite3_napi_queue_work(env, resource, from_json_execute, from_json_complete, job, &job->work);
+    if (status != napi_ok) {
+        json_text_free(env, &job->text);
+        free(job);
+        lite3_napi_reject_pending(env, deferred);
+    }
+    return napi_ok;
+}
+
+/**
+ * fromJSON(json, options?) -> Buffer
+ *   json             - JSON text as a string or a Buffer of UTF-8 bytes
+ *   options.zeroCopy - as for encode() (default: true)
+ * Numbers written as integers in the JSON are stored as i64.
+ */
+napi_value
+from_json(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return NULL;
+    }
+
+    bool zero_copy;
+    NAPI_CALL(env, NULL, lite3_napi_get_bool_option(env, argc > 1 ? argv[1] : NULL, "zeroCopy", true, &zero_copy), NULL);
+
+    json_text text;
+    NAPI_CALL(env, NULL, json_text_get(env, argv[0], false, &text), NULL);
+
+    lite3_ctx *ctx;
+    const char *error = json_to_ctx(text.data, text.len, &ctx);
+    json_text_free(env, &text);
+    if (error) {
+        napi_throw_error(env, NULL, error);
+        return NULL;
+    }
+
+    // Convert to a Buffer (this consumes ctx):
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_ctx_to_buffer(env, ctx, zero_copy, &result), NULL);
+    return result;
+}
+
+/**
+ * fromJSONAsync(json, options?) -> Promise<Buffer>
+ * fromJSON() on the threadpool. A Buffer of JSON must not be modified until
+ * the promise settles.
+ *   options.asyncThreshold - shorter text is converted on the calling thread
+ *                            (default: 65536)
+ */
+napi_value
+from_json_async(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return NULL;
+    }
+
+    napi_value promise;
+    NAPI_CALL(env, NULL, lite3_napi_from_json_promise(env, argv[0], argc > 1 ? argv[1] : NULL,
+                                                      "lite3.fromJSONAsync", &promise), NULL);
+    return promise;
+}
+
+static void
+finalize_json(napi_env env, void *data, void *hint) {
+    (void)env;
+    (void)hint;
+    free(data);
+}
+
+// Turn JSON text from lite3_json_enc() into a string or Buffer. Ownership
+// of `json` passes to this function.
+static napi_status
+json_result(napi_env env, char *json, size_t len, bool as_buffer, napi_value *result) {
+    napi_status status;
+    if (as_buffer) {
+        status = napi_create_external_buffer(env, len, json, finalize_json, NULL, result);
+        if (status == napi_ok) return napi_ok;
+        // Runtimes may refuse external buffers; copy instead.
+        status = napi_create_buffer_copy(env, len, json, NULL, result);
+    } else {
+        status = napi_create_string_utf8(env, json, len, result);
+    }
+    free(json);
+    return status;
+}
+
+// Shared argument handling for toJSON()/toJSONAsync().
+static napi_status
+to_json_args(napi_env env, napi_callback_info info, napi_value *buffer, napi_value *options,
+             const unsigned char **buf, size_t *buflen, uint32_t *offset, bool *verified, bool *as_buffer) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_status status = napi_get_cb_info(env, info, &argc, argv, NULL, NULL);
+    if (status != napi_ok) return status;
+    if (argc < 1 || argc > 2) {
+        napi_throw_type_error(env, NULL, "Expected one argument and optional options");
+        return napi_invalid_arg;
+    }
+    *buffer = argv[0];
+    *options = argc > 1 ? argv[1] : NULL;
+
+    void *data;
+    status = lite3_napi_get_message(env, *buffer, "Argument must be a Buffer or Uint8Array", &data, buflen);
+    if (status != napi_ok) return status;
+    *buf = data;
+
+    status = lite3_napi_get_uint32_option(env, *options, "offset", 0, offset);
+    if (status != napi_ok) return status;
+    if (*offset >= *buflen) {
+        napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+        return napi_invalid_arg;
+    }
+    status = lite3_napi_is_verified(env, *buffer, verified);
+    if (status != napi_ok) return status;
+    if (*offset != 0 && !lite3_napi_check_node(*buf, *buflen, *offset, *verified)) {
+        napi_throw_type_error(env, NULL, "Offset does not point to an object or array");
+        return napi_invalid_arg;
+    }
+    return lite3_napi_get_bool_option(env, *options, "asBuffer", false, as_buffer);
+}
+
+static const char to_json_error[] = "Lite3 buffer cannot be converted to JSON";
+static const char malformed_error[] = "Malformed Lite3 buffer";
+
+// Convert the node at `offset` to JSON text, verifying it first unless the
+// Buffer passed verify(). Returns NULL and sets `error` if either fails.
+// Safe to run off-thread.
+static char *
+to_json_text(const unsigned char *buf, size_t buflen, size_t offset, bool verified,
+             size_t *json_len, const char **error) {
+    if (!verified && !lite3_napi_verify_node(buf, buflen, offset)) {
+        *error = malformed_error;
+        return NULL;
+    }
+    char *json = lite3_json_enc(buf, buflen, offset, json_len);
+    if (!json) *error = to_json_error;
+    return json;
+}
+
+/**
+ * toJSON(buffer, options?) -> string | Buffer
+ *   options.offset   - convert only the node at this offset (default: 0)
+ *   options.asBuffer - return the JSON as a Buffer of UTF-8 bytes instead of
+ *                      a string (default: false)
+ * Bytes values are written as base64 strings. Unless the buffer passed
+ * verify(), the node is verified before it is converted.
+ */
+napi_value
+to_json(napi_env env, napi_callback_info info) {
+    napi_value buffer, options;
+    const unsigned char *buf;
+    size_t buflen;
+    uint32_t offset;
+    bool verified, as_buffer;
+    NAPI_CALL(env, NULL, to_json_args(env, info, &buffer, &options, &buf, &buflen, &offset, &verified, &as_buffer), NULL);
+
+    size_t json_len;
+    const char *error;
+    char *json = to_json_text(buf, buflen, offset, verified, &json_len, &error);
+    if (!json) {
+        napi_throw_error(env, NULL, error);
+        return NULL;
+    }
+
+    napi_value result;
+    NAPI_CALL(env, NULL, json_result(env, json, json_len, as_buffer, &result), NULL);
+    return result;
+}
+
+static void
+to_json_execute(napi_env env, void *data) {
+    (void)env;
+
+    to_json_job *job = data;
+    job->json = to_json_text(job->buf, job->buflen, job->offset, job->verified, &job->json_len, &job->error);
+}
+
+static void
+to_json_complete(napi_env env, napi_status status, void *data) {
+    to_json_job *job = data;
+
+    if (status != napi_ok) {
+        free(job->json);
+        lite3_napi_reject_with_message(env, job->deferred, "Operation cancelled");
+    } else if (!job->json) {
+        lite3_napi_reject_with_message(env, job->deferred, job->error);
+    } else {
+        napi_value result;
+        if (json_result(env, job->json, job->json_len, job->as_buffer, &result) == napi_ok) {
+            napi_resolve_deferred(env, job->deferred, result);
+        } else {
+            lite3_napi_reject_pending(env, job->deferred);
+        }
+    }
+
+    napi_delete_reference(env, job->buffer);
+    napi_delete_async_work(env, job->work);
+    free(job);
+}
+
+/**
+ * toJSONAsync(buffer, options?) -> Promise<string | Buffer>
+ * toJSON() on the threadpool, including the verification walk. The buffer
+ * must not be modified until the promise settles.
+ *   options.asyncThreshold - smaller messages are converted on the calling
+ *                            thread (default: 65536)
+ */
+napi_value
+to_json_async(napi_env env, napi_callback_info info) {
+    napi_value buffer, options;
+    const unsigned char *buf;
+    size_t buflen;
+    uint32_t offset, threshold;
+    bool verified, as_buffer;
+    NAPI_CALL(env, NULL, to_json_args(env, info, &buffer, &options, &buf, &buflen, &offset, &verified, &as_buffer), NULL);
+    NAPI_CALL(env, NULL, lite3_napi_get_uint32_option(env, options, "asyncThreshold", LITE3_NAPI_ASYNC_THRESHOLD, &threshold), NULL);
+
+    napi_value promise;
+    napi_deferred deferred;
+    NAPI_CALL(env, NULL, napi_create_promise(env, &deferred, &promise), NULL);
+
+    // Small messages: convert right here.
+    if (buflen < threshold) {
+        size_t json_len;
+        const char *error;
+        char *json = to_json_text(buf, buflen, offset, verified, &json_len, &error);
+        napi_value result;
+        if (!json) {
+            lite3_napi_reject_with_message(env, deferred, error);
+        } else if (json_result(env, json, json_len, as_buffer, &result) == napi_ok) {
+            napi_resolve_deferred(env, deferred, result);
+        } else {
+            lite3_napi_reject_pending(env, deferred);
+        }
+        return promise;
+    }
+
+    to_json_job *job = calloc(1, sizeof(*job));
+    if (!job) {
+        lite3_napi_reject_with_message(env, deferred, "Memory allocation failure");
+        return promise;
+    }
+    job->deferred = deferred;
+    job->buf = buf;
+    job->buflen = buflen;
+    job->offset = offset;
+    job->verified = verified;
+    job->as_buffer = as_buffer;
+
+    napi_status status = napi_create_reference(env, buffer, 1, &job->buffer);
+    if (status == napi_ok) {
+        status = lite3_napi_queue_work(env, "lite3.toJSONAsync", to_json_execute, to_json_complete, job, &job->work);
+    }
+    if (status != napi_ok) {
+        if (job->buffer) napi_delete_reference(env, job->buffer);
+        free(job);
+        lite3_napi_reject_pending(env, deferred);
+    }
+    return promise;
+}
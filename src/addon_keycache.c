@@ -0,0 +1,151 @@
+/**
+ * Key-name interning cache
+ *
+ * Messages of the same schema repeat the same handful of property names, and
+ * creating a fresh JS string for each one on decode costs a transcode, a heap
+ * allocation and a later internalisation when it is used as a property key.
+ *
+ * This cache maps the UTF-8 bytes of a key to the JS string created for it
+ * the first time, so repeated keys cost a hash, a memcmp and an array read.
+ * It is direct-mapped and bounded: a colliding key simply replaces the
+ * previous entry, and keys longer than KEY_CACHE_MAX_KEY bypass it.
+ *
+ * Node-API 9 can't hold references to strings, so the strings live in one
+ * referenced JS array, at the index of their slot.
+ *
+ * One cache exists per environment (see lite3_napi_instance).
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of entries; must be a power of two.
+#define KEY_CACHE_SIZE 1024
+
+// Longest key (in bytes) that is cached.
+#define KEY_CACHE_MAX_KEY 64
+
+typedef struct {
+    bool used;              // false for an empty slot
+    uint32_t hash;
+    uint32_t len;
+    char bytes[KEY_CACHE_MAX_KEY];
+} key_cache_entry;
+
+struct lite3_napi_key_cache {
+    napi_ref strings;       // JS array holding each slot's string
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint32_t entries;
+    key_cache_entry slots[KEY_CACHE_SIZE];
+};
+
+// FNV-1a
+static uint32_t
+hash_key(const char *ptr, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)ptr[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void
+lite3_napi_key_cache_free(lite3_napi_key_cache *cache) {
+    // The strings array's reference is owned by the environment and released
+    // with it, so only the table itself is freed here.
+    free(cache);
+}
+
+napi_status
+lite3_napi_key_string(napi_env env, lite3_napi_instance *instance, const char *ptr, size_t len, napi_value *result) {
+    if (!instance || len > KEY_CACHE_MAX_KEY) {
+        return napi_create_string_utf8(env, ptr, len, result);
+    }
+
+    napi_value strings;
+    if (!instance->key_cache) {
+        lite3_napi_key_cache *cache = calloc(1, sizeof(*cache));
+        if (!cache) {
+            return napi_create_string_utf8(env, ptr, len, result);
+        }
+        if (napi_create_array_with_length(env, KEY_CACHE_SIZE, &strings) != napi_ok ||
+            napi_create_reference(env, strings, 1, &cache->strings) != napi_ok) {
+            free(cache);
+            return napi_create_string_utf8(env, ptr, len, result);
+        }
+        instance->key_cache = cache;
+    } else {
+        napi_status status = napi_get_reference_value(env, instance->key_cache->strings, &strings);
+        if (status != napi_ok || strings == NULL) {
+            return napi_create_string_utf8(env, ptr, len, result);
+        }
+    }
+
+    lite3_napi_key_cache *cache = instance->key_cache;
+    uint32_t hash = hash_key(ptr, len);
+    uint32_t slot = hash & (KEY_CACHE_SIZE - 1);
+    key_cache_entry *entry = &cache->slots[slot];
+
+    if (entry->used && entry->hash == hash && entry->len == len && memcmp(entry->bytes, ptr, len) == 0) {
+        napi_status status = napi_get_element(env, strings, slot, result);
+        if (status != napi_ok) return status;
+        cache->hits++;
+        return napi_ok;
+    }
+
+    cache->misses++;
+    napi_status status = napi_create_string_utf8(env, ptr, len, result);
+    if (status != napi_ok) return status;
+
+    if (napi_set_element(env, strings, slot, *result) != napi_ok) {
+        // Not caching is always safe.
+        return napi_ok;
+    }
+
+    if (entry->used) {
+        cache->evictions++;
+    } else {
+        cache->entries++;
+    }
+
+    entry->used = true;
+    entry->hash = hash;
+    entry->len = (uint32_t)len;
+    memcpy(entry->bytes, ptr, len);
+
+    return napi_ok;
+}
+
+static napi_status
+set_stat(napi_env env, napi_value obj, const char *name, double value) {
+    napi_value num;
+    napi_status status = napi_create_double(env, value, &num);
+    if (status != napi_ok) return status;
+    return napi_set_named_property(env, obj, name, num);
+}
+
+/**
+ * getKeyCacheStats() -> { hits, misses, evictions, entries, capacity }
+ * Returns counters for this environment's key cache.
+ */
+napi_value
+get_key_cache_stats(napi_env env, napi_callback_info info) {
+    (void)info;  // unused
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    lite3_napi_key_cache *cache = instance ? instance->key_cache : NULL;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_object(env, &result), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "hits", cache ? (double)cache->hits : 0), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "misses", cache ? (double)cache->misses : 0), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "evictions", cache ? (double)cache->evictions : 0), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "entries", cache ? cache->entries : 0), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "capacity", KEY_CACHE_SIZE), NULL);
+    return result;
+}
@@ -0,0 +1,330 @@
+/**
+ * In-place edits
+ *
+ * set() and arrAppend() write one value into an existing message through
+ * lite3's buffer API, so an edit costs the size of the value written rather
+ * than of the whole message. lite3 writes new data after the current end of
+ * the message, so most edits need spare capacity past the end of the Buffer.
+ *
+ * A Buffer from elsewhere has none: the first edit that needs room copies the
+ * message into a new ArrayBuffer with spare capacity and returns a Buffer
+ * over it. Later edits through that Buffer write in place, and when the
+ * message grows they return a longer Buffer over the same memory. An edit in
+ * place can rewrite nodes an older, shorter Buffer over that memory still
+ * covers, so such a Buffer no longer holds a valid message and edits through
+ * it are rejected.
+ *
+ * Other threads may be reading a message in a SharedArrayBuffer while it is
+ * edited in place, so such edits must be asked for with `shared: true`. An
+ * edit that needs more room still moves the message into private memory.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Smallest ArrayBuffer allocated for a growing message.
+#define EDIT_MIN_CAPACITY 1024
+
+// Room reserved for a nested value on top of twice its standalone size: its
+// key, and any nodes the parent splits into.
+#define EDIT_NESTED_RESERVE 4096
+
+// Inline space for keys; longer keys spill to the heap.
+#define EDIT_KEY_INLINE_SIZE 256
+
+// Marks ArrayBuffers allocated here, whose memory past the message is free:
+static const napi_type_tag growable_type_tag = {
+    0x6c69746533677277ULL, 0x6f7761626c656d73ULL
+};
+
+// Attached to a growable ArrayBuffer: where its message currently ends.
+typedef struct {
+    size_t used;
+} growable_info;
+
+// The memory an edit writes into.
+typedef struct {
+    napi_value arraybuffer;
+    unsigned char *buf;
+    size_t buflen;
+    size_t bufsz;
+    growable_info *info;    // NULL if there is no spare capacity
+} edit_memory;
+
+static void
+finalize_growable(napi_env env, void *data, void *hint) {
+    (void)env;
+    (void)hint;
+    free(data);
+}
+
+// Resolve `buffer` to its memory, and its spare capacity if it is the latest
+// Buffer over a growable ArrayBuffer. Views that don't start at the message
+// (such as bytes values) are treated like any other memory.
+static napi_status
+get_memory(napi_env env, napi_value buffer, edit_memory *mem) {
+    size_t byte_offset;
+    napi_status status = napi_get_typedarray_info(env, buffer, NULL, &mem->buflen, (void **)&mem->buf,
+                                                  &mem->arraybuffer, &byte_offset);
+    if (status != napi_ok) return status;
+    mem->bufsz = mem->buflen;
+    mem->info = NULL;
+
+    bool growable;
+    status = napi_check_object_type_tag(env, mem->arraybuffer, &growable_type_tag, &growable);
+    if (status != napi_ok || !growable) return status;
+
+    growable_info *info;
+    status = napi_unwrap(env, mem->arraybuffer, (void **)&info);
+    if (status != napi_ok) return status;
+    if (byte_offset != 0) return napi_ok;
+    if (info->used != mem->buflen) {
+        napi_throw_error(env, NULL, "Buffer is out of date: use the Buffer returned by the last edit");
+        return napi_invalid_arg;
+    }
+
+    mem->info = info;
+    return napi_get_arraybuffer_info(env, mem->arraybuffer, NULL, &mem->bufsz);
+}
+
+// Getters on the value run while an edit holds the Buffer's memory. Check that
+// `buffer` still resolves to `expected`: a getter that detached or shrank its
+// ArrayBuffer, or edited the same Buffer, would leave the edit working on
+// memory the Buffer no longer owns or a message that has moved on.
+static napi_status
+check_memory(napi_env env, napi_value buffer, const edit_memory *expected) {
+    edit_memory mem;
+    napi_status status = get_memory(env, buffer, &mem);
+    if (status != napi_ok) return status;
+    if (mem.buf != expected->buf || mem.buflen != expected->buflen || mem.bufsz < expected->bufsz) {
+        napi_throw_type_error(env, NULL, "Buffer was detached, resized or edited while the value was read");
+        return napi_invalid_arg;
+    }
+    return napi_ok;
+}
+
+// Copy the message, `mem->buflen` bytes at `source`, into a new growable
+// ArrayBuffer of at least twice `needed` bytes.
+static napi_status
+grow(napi_env env, edit_memory *mem, const unsigned char *source, size_t needed) {
+    size_t capacity = needed * 2;
+    if (capacity < EDIT_MIN_CAPACITY) capacity = EDIT_MIN_CAPACITY;
+
+    growable_info *info = malloc(sizeof(*info));
+    if (!info) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+
+    napi_value arraybuffer;
+    void *data;
+    napi_status status = napi_create_arraybuffer(env, capacity, &data, &arraybuffer);
+    if (status == napi_ok) status = napi_type_tag_object(env, arraybuffer, &growable_type_tag);
+    if (status == napi_ok) status = napi_wrap(env, arraybuffer, info, finalize_growable, NULL, NULL);
+    if (status != napi_ok) {
+        free(info);
+        return status;
+    }
+
+    memcpy(data, source, mem->buflen);
+    info->used = mem->buflen;
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), reallocs);
+
+    mem->arraybuffer = arraybuffer;
+    mem->buf = data;
+    mem->bufsz = capacity;
+    mem->info = info;
+    return napi_ok;
+}
+
+// Transcode a key into `inline_buf`, or a heap buffer if it doesn't fit.
+static napi_status
+get_key(napi_env env, napi_value key, char *inline_buf, char **result) {
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, key, &type);
+    if (status != napi_ok) return status;
+    if (type != napi_string) {
+        napi_throw_type_error(env, NULL, "Key must be a string");
+        return napi_invalid_arg;
+    }
+
+    size_t len;
+    status = napi_get_value_string_utf8(env, key, NULL, 0, &len);
+    if (status != napi_ok) return status;
+
+    *result = inline_buf;
+    if (len >= EDIT_KEY_INLINE_SIZE) {
+        *result = malloc(len + 1);
+        if (!*result) {
+            *result = inline_buf;
+            napi_throw_error(env, NULL, "Memory allocation failure");
+            return napi_generic_failure;
+        }
+    }
+    return napi_get_value_string_utf8(env, key, *result, len + 1, NULL);
+}
+
+// Write `value` under `key` in the object at `offset` of `buffer`, or append
+// it to the array there if `key` is NULL. `*result` is `buffer` itself if the
+// message kept its length, otherwise a new Buffer over the edited message.
+napi_status
+lite3_napi_edit(napi_env env, napi_value buffer, size_t offset, napi_value key, napi_value value,
+                napi_value options, napi_value *result) {
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, value, &type);
+    if (status != napi_ok) return status;
+    if (type == napi_undefined || type == napi_function || type == napi_symbol || type == napi_external) {
+        napi_throw_type_error(env, NULL, "Value cannot be stored in a Lite3 message");
+        return napi_invalid_arg;
+    }
+
+    lite3_napi_encode_options encode_options;
+    status = lite3_napi_get_encode_options(env, options, &encode_options);
+    if (status != napi_ok) return status;
+
+    bool shared_ok;
+    status = lite3_napi_get_bool_option(env, options, "shared", false, &shared_ok);
+    if (status != napi_ok) return status;
+
+    edit_memory mem;
+    status = get_memory(env, buffer, &mem);
+    if (status != napi_ok) return status;
+
+    bool is_arraybuffer;
+    status = napi_is_arraybuffer(env, mem.arraybuffer, &is_arraybuffer);
+    if (status != napi_ok) return status;
+    if (!is_arraybuffer && !shared_ok) {
+        napi_throw_type_error(env, NULL, "Buffer is over a SharedArrayBuffer: pass { shared: true } to edit it in place");
+        return napi_invalid_arg;
+    }
+
+    if (offset >= mem.buflen) {
+        napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+        return napi_invalid_arg;
+    }
+    if (lite3_val_type((lite3_val *)(mem.buf + offset)) != (key ? LITE3_TYPE_OBJECT : LITE3_TYPE_ARRAY)) {
+        napi_throw_type_error(env, NULL, key ? "Offset does not point to an object" : "Offset does not point to an array");
+        return napi_invalid_arg;
+    }
+
+    char key_inline[EDIT_KEY_INLINE_SIZE];
+    char *key_str = key_inline;
+    if (key) status = get_key(env, key, key_inline, &key_str);
+
+    // A nested value takes many writes, and running out of room half way
+    // would leave it incomplete, so make room for all of it up front:
+    const edit_memory caller = mem;
+    size_t nested = 0;
+    if (status == napi_ok) status = lite3_napi_measure_value(env, value, &encode_options, &nested);
+    if (status == napi_ok) status = check_memory(env, buffer, &caller);
+    size_t reserve = nested ? nested * 2 + EDIT_NESTED_RESERVE : 0;
+    bool grown = false;
+    if (status == napi_ok && mem.bufsz - mem.buflen < reserve) {
+        status = grow(env, &mem, mem.buf, mem.buflen + reserve);
+        grown = true;
+    }
+
+    // Every attempt starts again from the message as it was:
+    const unsigned char *original = mem.buf;
+    size_t buflen = mem.buflen;
+    while (status == napi_ok) {
+        bool overflow;
+        status = lite3_napi_encode_value_at(env, value, mem.buf, &buflen, mem.bufsz, offset,
+                                            key ? key_str : NULL, &encode_options, &overflow);
+        // Until it grows, the edit writes into the caller's memory:
+        if (!grown && (status == napi_ok || overflow)) {
+            napi_status checked = check_memory(env, buffer, &caller);
+            if (checked != napi_ok) {
+                status = checked;
+                break;
+            }
+        }
+        if (status == napi_ok || !overflow) break;
+        if (nested) {
+            napi_throw_error(env, NULL, "Lite3 error");
+            break;
+        }
+        // A single write that doesn't fit leaves the message unchanged, so it
+        // can be retried in twice as much memory each time:
+        status = grow(env, &mem, original, mem.bufsz);
+        buflen = mem.buflen;
+        grown = true;
+    }
+
+    if (key_str != key_inline) free(key_str);
+    if (status != napi_ok) return status;
+
+    if (!grown && buflen == mem.buflen) {
+        *result = buffer;
+        return napi_ok;
+    }
+    mem.info->used = buflen;
+    return lite3_napi_create_view(env, mem.arraybuffer, 0, buflen, result);
+}
+
+// Shared argument handling: the Buffer and the offset into it.
+static napi_status
+edit_args(napi_env env, napi_value buffer, napi_value offset_value, size_t *offset) {
+    napi_status status = lite3_napi_get_message(env, buffer, "First argument must be a Buffer or Uint8Array",
+                                                NULL, NULL);
+    if (status != napi_ok) return status;
+
+    int64_t offset64;
+    status = napi_get_value_int64(env, offset_value, &offset64);
+    if (status != napi_ok) return status;
+    if (offset64 < 0) {
+        napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+        return napi_invalid_arg;
+    }
+    *offset = (size_t)offset64;
+    return napi_ok;
+}
+
+/**
+ * set(buffer, offset, key, value, options?) -> Buffer
+ * Writes `value` under `key` in the object at `offset`, replacing any value
+ * already there. Returns `buffer` if the message kept its length, otherwise
+ * a Buffer over the edited message that must be used from then on.
+ */
+napi_value
+set(napi_env env, napi_callback_info info) {
+    size_t argc = 5;
+    napi_value argv[5];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 4) {
+        napi_throw_type_error(env, NULL, "Expected 4-5 arguments: buffer, offset, key, value, options");
+        return NULL;
+    }
+
+    size_t offset;
+    NAPI_CALL(env, NULL, edit_args(env, argv[0], argv[1], &offset), NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_edit(env, argv[0], offset, argv[2], argv[3], argc > 4 ? argv[4] : NULL, &result), NULL);
+    return result;
+}
+
+/**
+ * arrAppend(buffer, offset, value, options?) -> Buffer
+ * Appends `value` to the array at `offset`. Returns a Buffer as set() does.
+ */
+napi_value
+arr_append(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 3) {
+        napi_throw_type_error(env, NULL, "Expected 3-4 arguments: buffer, offset, value, options");
+        return NULL;
+    }
+
+    size_t offset;
+    NAPI_CALL(env, NULL, edit_args(env, argv[0], argv[1], &offset), NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_edit(env, argv[0], offset, NULL, argv[2], argc > 3 ? argv[3] : NULL, &result), NULL);
+    return result;
+}
@@ -0,0 +1,162 @@
+/**
+ * Option object helpers
+ *
+ * Small readers for the optional `options` argument accepted by several entry
+ * points. A missing options object or a missing/undefined property yields the
+ * supplied default; a property of the wrong type is a TypeError.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Fetch `name` from `options`, or report that it is absent.
+napi_status
+lite3_napi_get_option(napi_env env, napi_value options, const char *name, napi_value *value, bool *present) {
+    *present = false;
+    if (options == NULL) return napi_ok;
+
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, options, &type);
+    if (status != napi_ok) return status;
+    if (type == napi_undefined || type == napi_null) return napi_ok;
+    if (type != napi_object) {
+        napi_throw_type_error(env, NULL, "Options must be an object");
+        return napi_object_expected;
+    }
+
+    bool has;
+    status = napi_has_named_property(env, options, name, &has);
+    if (status != napi_ok || !has) return status;
+
+    status = napi_get_named_property(env, options, name, value);
+    if (status != napi_ok) return status;
+
+    status = napi_typeof(env, *value, &type);
+    if (status != napi_ok) return status;
+    *present = type != napi_undefined;
+    return napi_ok;
+}
+
+static void
+throw_option_type_error(napi_env env, const char *name, const char *expected) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Option '%s' must be a %s", name, expected);
+    napi_throw_type_error(env, NULL, msg);
+}
+
+napi_status
+lite3_napi_get_bool_option(napi_env env, napi_value options, const char *name, bool default_value, bool *result) {
+    napi_value value;
+    bool present;
+    napi_status status = lite3_napi_get_option(env, options, name, &value, &present);
+    if (status != napi_ok) return status;
+
+    if (!present) {
+        *result = default_value;
+        return napi_ok;
+    }
+
+    status = napi_get_value_bool(env, value, result);
+    if (status == napi_boolean_expected) throw_option_type_error(env, name, "boolean");
+    return status;
+}
+
+napi_status
+lite3_napi_get_uint32_option(napi_env env, napi_value options, const char *name, uint32_t default_value, uint32_t *result) {
+    napi_value value;
+    bool present;
+    napi_status status = lite3_napi_get_option(env, options, name, &value, &present);
+    if (status != napi_ok) return status;
+
+    if (!present) {
+        *result = default_value;
+        return napi_ok;
+    }
+
+    double num;
+    status = napi_get_value_double(env, value, &num);
+    if (status == napi_number_expected || (status == napi_ok && !(num >= 0 && num <= UINT32_MAX && num == (uint32_t)num))) {
+        throw_option_type_error(env, name, "non-negative integer");
+        return napi_invalid_arg;
+    }
+    if (status != napi_ok) return status;
+
+    *result = (uint32_t)num;
+    return napi_ok;
+}
+
+void
+lite3_napi_string_list_free(lite3_napi_string_list *list) {
+    free(list->items);
+    free(list->storage);
+    list->items = NULL;
+    list->storage = NULL;
+    list->count = 0;
+}
+
+// Read an array of strings as null-terminated UTF-8. The list is empty when
+// the option is absent; release it with lite3_napi_string_list_free().
+napi_status
+lite3_napi_get_string_list_option(napi_env env, napi_value options, const char *name,
+                                  lite3_napi_string_list *result, bool *present) {
+    *result = (lite3_napi_string_list){ 0 };
+
+    napi_value value;
+    napi_status status = lite3_napi_get_option(env, options, name, &value, present);
+    if (status != napi_ok || !*present) return status;
+
+    bool is_array;
+    status = napi_is_array(env, value, &is_array);
+    if (status != napi_ok) return status;
+    if (!is_array) {
+        throw_option_type_error(env, name, "array of strings");
+        return napi_array_expected;
+    }
+
+    uint32_t count;
+    status = napi_get_array_length(env, value, &count);
+    if (status != napi_ok) return status;
+
+    // First pass: validate and measure.
+    size_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        napi_value item;
+        size_t len;
+        status = napi_get_element(env, value, i, &item);
+        if (status != napi_ok) return status;
+        status = napi_get_value_string_utf8(env, item, NULL, 0, &len);
+        if (status == napi_string_expected) {
+            throw_option_type_error(env, name, "array of strings");
+            return status;
+        }
+        if (status != napi_ok) return status;
+        total += len + 1;
+    }
+
+    result->items = malloc((count ? count : 1) * sizeof(*result->items));
+    result->storage = malloc(total ? total : 1);
+    if (!result->items || !result->storage) {
+        lite3_napi_string_list_free(result);
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+
+    // Second pass: copy.
+    char *out = result->storage;
+    for (uint32_t i = 0; i < count; i++) {
+        napi_value item;
+        size_t len;
+        status = napi_get_element(env, value, i, &item);
+        if (status == napi_ok) status = napi_get_value_string_utf8(env, item, out, total - (size_t)(out - result->storage), &len);
+        if (status != napi_ok) {
+            lite3_napi_string_list_free(result);
+            return status;
+        }
+        result->items[i] = out;
+        out += len + 1;
+    }
+    result->count = count;
+    return napi_ok;
+}
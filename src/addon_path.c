@@ -0,0 +1,349 @@
+/**
+ * Path-based field extraction
+ *
+ * getPath(buffer, "a.b[3].c") walks straight to one value with lite3 lookups
+ * and decodes only that value. project(buffer, paths) does the same for many
+ * paths in one call. Paths can be compiled once with compilePath() so that
+ * per-message cost is just the lookups.
+ *
+ * Syntax: keys separated by `.`, array indices as `[n]`, and keys that
+ * contain `.` or `[` quoted as `["key"]` or `['key']` (with `\` escaping the
+ * quote or a backslash). The empty path refers to the root.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Path strings up to this many bytes are read without a heap allocation.
+#define PATH_INLINE_SIZE 256
+
+typedef struct {
+    const char *key;        // NULL for an array index
+    uint32_t index;
+} path_segment;
+
+typedef struct {
+    uint32_t count;
+    path_segment *segments;
+    char *keys;             // storage for the null-terminated keys
+} lite3_napi_path;
+
+// Marks objects returned by compilePath():
+static const napi_type_tag path_type_tag = {
+    0x6c69746533706174ULL, 0x68636f6d70696c65ULL
+};
+
+static void
+path_free(lite3_napi_path *path) {
+    if (!path) return;
+    free(path->segments);
+    free(path->keys);
+    free(path);
+}
+
+static void
+path_finalize(napi_env env, void *data, void *hint) {
+    (void)env;
+    (void)hint;
+    path_free(data);
+}
+
+// Parse `src` into segments. Returns NULL on a syntax error (with the byte
+// position in *error_pos) or on allocation failure (with *error_pos == len + 1).
+static lite3_napi_path *
+path_parse(const char *src, size_t len, size_t *error_pos) {
+    lite3_napi_path *path = calloc(1, sizeof(*path));
+    if (path) {
+        // A path of n bytes has at most n + 1 segments, whose keys take at
+        // most n + 1 bytes including their terminators.
+        path->segments = malloc((len + 1) * sizeof(*path->segments));
+        path->keys = malloc(len + 1);
+    }
+    if (!path || !path->segments || !path->keys) {
+        path_free(path);
+        *error_pos = len + 1;
+        return NULL;
+    }
+
+    char *out = path->keys;
+    size_t pos = 0;
+    while (pos < len) {
+        path_segment *segment = &path->segments[path->count];
+
+        if (src[pos] == '[') {
+            pos++;
+            if (pos < len && (src[pos] == '"' || src[pos] == '\'')) {
+                // Quoted key:
+                char quote = src[pos++];
+                segment->key = out;
+                while (pos < len && src[pos] != quote) {
+                    if (src[pos] == '\\' && pos + 1 < len) pos++;
+                    *out++ = src[pos++];
+                }
+                if (pos >= len) goto syntax_error;
+                pos++;
+                *out++ = '\0';
+            } else {
+                // Array index:
+                size_t start = pos;
+                uint64_t index = 0;
+                while (pos < len && src[pos] >= '0' && src[pos] <= '9') {
+                    index = index * 10 + (uint64_t)(src[pos++] - '0');
+                    if (index > UINT32_MAX) goto syntax_error;
+                }
+                if (pos == start) goto syntax_error;
+                segment->key = NULL;
+                segment->index = (uint32_t)index;
+            }
+            if (pos >= len || src[pos] != ']') goto syntax_error;
+            pos++;
+        } else {
+            // Plain key, after a `.` unless it is the first segment:
+            if (path->count > 0) {
+                if (src[pos] != '.') goto syntax_error;
+                pos++;
+            }
+            size_t start = pos;
+            while (pos < len && src[pos] != '.' && src[pos] != '[') pos++;
+            if (pos == start) goto syntax_error;
+
+            segment->key = out;
+            memcpy(out, src + start, pos - start);
+            out += pos - start;
+            *out++ = '\0';
+        }
+        path->count++;
+    }
+    return path;
+
+syntax_error:
+    path_free(path);
+    *error_pos = pos;
+    return NULL;
+}
+
+// Parse a JS path string, throwing on invalid syntax.
+static napi_status
+path_from_string(napi_env env, napi_value value, lite3_napi_path **result) {
+    size_t len;
+    napi_status status = napi_get_value_string_utf8(env, value, NULL, 0, &len);
+    if (status != napi_ok) return status;
+
+    char inline_buf[PATH_INLINE_SIZE];
+    char *src = len < sizeof(inline_buf) ? inline_buf : malloc(len + 1);
+    if (!src) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+    status = napi_get_value_string_utf8(env, value, src, len + 1, NULL);
+
+    size_t error_pos = 0;
+    *result = status == napi_ok ? path_parse(src, len, &error_pos) : NULL;
+    if (src != inline_buf) free(src);
+    if (status != napi_ok) return status;
+
+    if (!*result) {
+        if (error_pos > len) {
+            napi_throw_error(env, NULL, "Memory allocation failure");
+        } else {
+            char msg[64];
+            snprintf(msg, sizeof(msg), "Invalid path syntax at position %zu", error_pos);
+            napi_throw_error(env, NULL, msg);
+        }
+        return napi_invalid_arg;
+    }
+    return napi_ok;
+}
+
+// Resolve `value` (a path string or a compiled path) to a parsed path. Paths
+// parsed from strings are owned by the caller (*owned is set).
+static napi_status
+path_get(napi_env env, napi_value value, lite3_napi_path **result, bool *owned) {
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, value, &type);
+    if (status != napi_ok) return status;
+
+    if (type == napi_string) {
+        *owned = true;
+        return path_from_string(env, value, result);
+    }
+
+    bool is_path = false;
+    if (type == napi_object) {
+        status = napi_check_object_type_tag(env, value, &path_type_tag, &is_path);
+        if (status != napi_ok) return status;
+    }
+    if (!is_path) {
+        napi_throw_type_error(env, NULL, "Path must be a string or a compiled path");
+        return napi_invalid_arg;
+    }
+
+    *owned = false;
+    return napi_unwrap(env, value, (void **)result);
+}
+
+// Walk `path` from the root. Returns false if any step is missing or
+// traverses a non-container.
+static bool
+path_resolve(const lite3_napi_path *path, const unsigned char *buf, size_t buflen, size_t *result) {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < path->count; i++) {
+        const path_segment *segment = &path->segments[i];
+        enum lite3_type type = lite3_val_type((lite3_val *)(buf + offset));
+
+        lite3_val *val;
+        if (segment->key) {
+            if (type != LITE3_TYPE_OBJECT || lite3_get(buf, buflen, offset, segment->key, &val) != 0) return false;
+        } else {
+            if (type != LITE3_TYPE_ARRAY || lite3_arr_get(buf, buflen, offset, segment->index, &val) != 0) return false;
+        }
+        offset = (size_t)((const unsigned char *)val - buf);
+    }
+    *result = offset;
+    return true;
+}
+
+// Resolve and decode one path; undefined if it does not exist.
+static napi_status
+path_extract(napi_env env, const lite3_napi_decoder *dec, napi_value path_value, napi_value *result) {
+    lite3_napi_path *path;
+    bool owned;
+    napi_status status = path_get(env, path_value, &path, &owned);
+    if (status != napi_ok) return status;
+
+    size_t offset;
+    if (path_resolve(path, dec->buf, dec->buflen, &offset)) {
+        status = lite3_napi_decode_value(env, dec, offset, result);
+    } else {
+        status = napi_get_undefined(env, result);
+    }
+
+    if (owned) path_free(path);
+    return status;
+}
+
+// Set up a decoder over a Lite3 Buffer argument.
+static napi_status
+path_decoder(napi_env env, napi_value buffer, lite3_napi_decoder *dec) {
+    void *data;
+    size_t length;
+    napi_status status = lite3_napi_get_message(env, buffer, "First argument must be a Buffer or Uint8Array",
+                                                &data, &length);
+    if (status != napi_ok) return status;
+    if (length == 0) {
+        napi_throw_error(env, NULL, "Buffer is empty");
+        return napi_invalid_arg;
+    }
+
+    *dec = (lite3_napi_decoder) {
+        .buf = data,
+        .buflen = length,
+        .instance = lite3_napi_get_instance(env),
+    };
+    status = lite3_napi_is_verified(env, buffer, &dec->verified);
+    if (status != napi_ok) return status;
+    return lite3_napi_decoder_set_source(env, dec, buffer);
+}
+
+/**
+ * compilePath(path) -> Lite3Path
+ * Parses a path once for reuse with getPath() and project().
+ */
+napi_value
+compile_path(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) {
+        NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    }
+    if (type != napi_string) {
+        napi_throw_type_error(env, NULL, "Path must be a string");
+        return NULL;
+    }
+
+    lite3_napi_path *path;
+    if (path_from_string(env, argv[0], &path) != napi_ok) return NULL;
+
+    napi_value result;
+    napi_status status = napi_create_object(env, &result);
+    if (status == napi_ok) status = napi_wrap(env, result, path, path_finalize, NULL, NULL);
+    if (status != napi_ok) {
+        path_free(path);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+    NAPI_CALL(env, NULL, napi_type_tag_object(env, result, &path_type_tag), NULL);
+
+    napi_property_descriptor source = { "path", NULL, NULL, NULL, NULL, argv[0], napi_enumerable, NULL };
+    NAPI_CALL(env, NULL, napi_define_properties(env, result, 1, &source), NULL);
+    NAPI_CALL(env, NULL, napi_object_freeze(env, result), NULL);
+    return result;
+}
+
+/**
+ * getPath(buffer, path) -> any
+ * Returns the decoded value at `path` (a string or compiled path), or
+ * undefined if it does not exist.
+ */
+napi_value
+get_path(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 2) {
+        napi_throw_type_error(env, NULL, "Expected 2 arguments: buffer, path");
+        return NULL;
+    }
+
+    lite3_napi_decoder dec;
+    NAPI_CALL(env, NULL, path_decoder(env, argv[0], &dec), NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, path_extract(env, &dec, argv[1], &result), NULL);
+    return result;
+}
+
+/**
+ * project(buffer, paths) -> any[]
+ * Resolves every path in one call; the result holds the value for each path
+ * in order (undefined where a path does not exist).
+ */
+napi_value
+project(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 2) {
+        napi_throw_type_error(env, NULL, "Expected 2 arguments: buffer, paths");
+        return NULL;
+    }
+
+    bool is_array;
+    NAPI_CALL(env, NULL, napi_is_array(env, argv[1], &is_array), NULL);
+    if (!is_array) {
+        napi_throw_type_error(env, NULL, "Paths must be an array");
+        return NULL;
+    }
+
+    lite3_napi_decoder dec;
+    NAPI_CALL(env, NULL, path_decoder(env, argv[0], &dec), NULL);
+
+    uint32_t count;
+    NAPI_CALL(env, NULL, napi_get_array_length(env, argv[1], &count), NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_create_array_with_length(env, count, &result), NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        napi_value path, value;
+        NAPI_CALL(env, NULL, napi_get_element(env, argv[1], i, &path), NULL);
+        NAPI_CALL(env, NULL, path_extract(env, &dec, path, &value), NULL);
+        NAPI_CALL(env, NULL, napi_set_element(env, result, i, value), NULL);
+    }
+    return result;
+}
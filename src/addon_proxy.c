@@ -3,17 +3,42 @@
  *
  * N-API functions for lazy/proxy-based access to Lite3 buffers.
  * These enable accessing individual properties without decoding the entire buffer.
+ * Lookups go straight to the Buffer's memory through lite3's buffer API, so
+ * an access costs one key lookup regardless of the message size.
  */
 
 #include <node_api.h>
 #include <lite3-napi.h>
-#include <lite3_context_api.h>
+#include <lite3.h>
 #include <string.h>
 
+// Helper: reject offsets outside the buffer, and report whether per-value
+// bounds checks can be skipped: only for reads from the root of a verified
+// Buffer. Any other offset comes from JS and may point into the middle of a
+// value, so reads from it are checked even in a verified Buffer.
+static napi_status
+check_offset(napi_env env, napi_value buffer, size_t buffer_len, int64_t offset, bool *verified) {
+    if (offset < 0 || (uint64_t)offset >= buffer_len) {
+        napi_throw_range_error(env, NULL, "Offset is outside the buffer");
+        return napi_invalid_arg;
+    }
+    *verified = false;
+    if (offset != 0) return napi_ok;
+    return lite3_napi_is_verified(env, buffer, verified);
+}
+
+// Helper: throw for a value that fails the bounds checks.
+static napi_status
+throw_malformed(napi_env env) {
+    napi_throw_error(env, NULL, "Malformed Lite3 buffer");
+    return napi_invalid_arg;
+}
+
 // Helper: extract buffer, offset, and key from arguments
 static napi_status
 extract_args_obj(napi_env env, napi_callback_info info,
-                 void **buffer, size_t *buffer_len, int64_t *offset, char *key, size_t key_size) {
+                 void **buffer, size_t *buffer_len, int64_t *offset, bool *verified,
+                 char *key, size_t key_size) {
     size_t argc = 3;
     napi_value argv[3];
     napi_status status;
@@ -26,19 +51,16 @@ extract_args_obj(napi_env env, napi_callback_info info,
         return napi_invalid_arg;
     }
 
-    bool is_buffer;
-    status = napi_is_buffer(env, argv[0], &is_buffer);
-    if (status != napi_ok || !is_buffer) {
-        napi_throw_type_error(env, NULL, "First argument must be a Buffer");
-        return napi_invalid_arg;
-    }
-
-    status = napi_get_buffer_info(env, argv[0], buffer, buffer_len);
+    status = lite3_napi_get_message(env, argv[0], "First argument must be a Buffer or Uint8Array",
+                                    buffer, buffer_len);
     if (status != napi_ok) return status;
 
     status = napi_get_value_int64(env, argv[1], offset);
     if (status != napi_ok) return status;
 
+    status = check_offset(env, argv[0], *buffer_len, *offset, verified);
+    if (status != napi_ok) return status;
+
     status = napi_get_value_string_utf8(env, argv[2], key, key_size, NULL);
     if (status != napi_ok) return status;
 
@@ -48,7 +70,7 @@ extract_args_obj(napi_env env, napi_callback_info info,
 // Helper: extract buffer, offset, and index from arguments (for arrays)
 static napi_status
 extract_args_arr(napi_env env, napi_callback_info info,
-                 void **buffer, size_t *buffer_len, int64_t *offset, uint32_t *index) {
+                 void **buffer, size_t *buffer_len, int64_t *offset, bool *verified, uint32_t *index) {
     size_t argc = 3;
     napi_value argv[3];
     napi_status status;
@@ -61,19 +83,16 @@ extract_args_arr(napi_env env, napi_callback_info info,
         return napi_invalid_arg;
     }
 
-    bool is_buffer;
-    status = napi_is_buffer(env, argv[0], &is_buffer);
-    if (status != napi_ok || !is_buffer) {
-        napi_throw_type_error(env, NULL, "First argument must be a Buffer");
-        return napi_invalid_arg;
-    }
-
-    status = napi_get_buffer_info(env, argv[0], buffer, buffer_len);
+    status = lite3_napi_get_message(env, argv[0], "First argument must be a Buffer or Uint8Array",
+                                    buffer, buffer_len);
     if (status != napi_ok) return status;
 
     status = napi_get_value_int64(env, argv[1], offset);
     if (status != napi_ok) return status;
 
+    status = check_offset(env, argv[0], *buffer_len, *offset, verified);
+    if (status != napi_ok) return status;
+
     status = napi_get_value_uint32(env, argv[2], index);
     if (status != napi_ok) return status;
 
@@ -83,7 +102,7 @@ extract_args_arr(napi_env env, napi_callback_info info,
 // Helper: extract just buffer and offset (for getKeys, getLength)
 static napi_status
 extract_args_buf_ofs(napi_env env, napi_callback_info info,
-                     void **buffer, size_t *buffer_len, int64_t *offset) {
+                     void **buffer, size_t *buffer_len, int64_t *offset, bool *verified) {
     size_t argc = 2;
     napi_value argv[2];
     napi_status status;
@@ -96,19 +115,16 @@ extract_args_buf_ofs(napi_env env, napi_callback_info info,
         return napi_invalid_arg;
     }
 
-    bool is_buffer;
-    status = napi_is_buffer(env, argv[0], &is_buffer);
-    if (status != napi_ok || !is_buffer) {
-        napi_throw_type_error(env, NULL, "First argument must be a Buffer");
-        return napi_invalid_arg;
-    }
-
-    status = napi_get_buffer_info(env, argv[0], buffer, buffer_len);
+    status = lite3_napi_get_message(env, argv[0], "First argument must be a Buffer or Uint8Array",
+                                    buffer, buffer_len);
     if (status != napi_ok) return status;
 
     status = napi_get_value_int64(env, argv[1], offset);
     if (status != napi_ok) return status;
 
+    status = check_offset(env, argv[0], *buffer_len, *offset, verified);
+    if (status != napi_ok) return status;
+
     return napi_ok;
 }
 
@@ -130,28 +146,62 @@ type_to_string(napi_env env, enum lite3_type type, napi_value *result) {
     return napi_create_string_utf8(env, type_str, NAPI_AUTO_LENGTH, result);
 }
 
+// Helper: convert a value found in `buffer` to JS. Objects and arrays are
+// returned as their offset, for further proxy calls; bytes as a view into
+// the Buffer passed as the first argument. Unless the Buffer was verified,
+// the value is bounds-checked first.
+static napi_status
+value_to_js(napi_env env, napi_callback_info info, void *buffer, size_t buffer_len,
+            bool verified, lite3_val *val, napi_value *result) {
+    size_t val_offset = (size_t)((unsigned char *)val - (unsigned char *)buffer);
+    if (!verified && !lite3_napi_check_value(buffer, buffer_len, val_offset)) {
+        return throw_malformed(env);
+    }
+    lite3_napi_decoder dec = {
+        .buf = buffer,
+        .buflen = buffer_len,
+        .instance = lite3_napi_get_instance(env),
+        .verified = verified,
+    };
+
+    switch (lite3_val_type(val)) {
+        case LITE3_TYPE_OBJECT:
+        case LITE3_TYPE_ARRAY:
+            return napi_create_int64(env, (int64_t)val_offset, result);
+
+        case LITE3_TYPE_BYTES: {
+            size_t argc = 1;
+            napi_value source;
+            napi_status status = napi_get_cb_info(env, info, &argc, &source, NULL, NULL);
+            if (status != napi_ok) return status;
+            status = lite3_napi_decoder_set_source(env, &dec, source);
+            if (status != napi_ok) return status;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return lite3_napi_decode_value(env, &dec, val_offset, result);
+}
+
 /**
  * getType(buffer, offset, key) -> string
- * Returns the type of a property as a string: "object", "array", "string", "number", "boolean", "null"
+ * Returns the type of a property as a string: "object", "array", "string", "number", "boolean", "null", "bytes"
  */
-napi_value proxy_get_type(napi_env env, napi_callback_info info) {
+static napi_value get_type(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     char key[256];
 
-    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, key, sizeof(key)) != napi_ok) {
+    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, &verified, key, sizeof(key)) != napi_ok) {
         return NULL;
     }
 
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
-        return NULL;
-    }
-
-    enum lite3_type type = lite3_ctx_get_type(ctx, (size_t)offset, key);
-    lite3_ctx_destroy(ctx);
+    enum lite3_type type = lite3_get_type(buffer, buffer_len, (size_t)offset, key);
 
     napi_value result;
     if (type_to_string(env, type, &result) != napi_ok) {
@@ -164,24 +214,18 @@ napi_value proxy_get_type(napi_env env, napi_callback_info info) {
  * getArrayType(buffer, offset, index) -> string
  * Returns the type of an array element as a string
  */
-napi_value proxy_get_array_type(napi_env env, napi_callback_info info) {
+static napi_value get_array_type(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     uint32_t index;
 
-    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &index) != napi_ok) {
-        return NULL;
-    }
-
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &verified, &index) != napi_ok) {
         return NULL;
     }
 
-    enum lite3_type type = lite3_ctx_arr_get_type(ctx, (size_t)offset, index);
-    lite3_ctx_destroy(ctx);
+    enum lite3_type type = lite3_arr_get_type(buffer, buffer_len, (size_t)offset, index);
 
     napi_value result;
     if (type_to_string(env, type, &result) != napi_ok) {
@@ -193,95 +237,30 @@ napi_value proxy_get_array_type(napi_env env, napi_callback_info info) {
 /**
  * getValue(buffer, offset, key) -> any
  * Decodes and returns a single primitive value (string, number, boolean, null)
+ * Bytes values are returned as a view sharing memory with `buffer`
  * For objects/arrays, use getChildOffset instead
  */
-napi_value proxy_get_value(napi_env env, napi_callback_info info) {
+static napi_value get_value(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     char key[256];
 
-    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, key, sizeof(key)) != napi_ok) {
-        return NULL;
-    }
-
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, &verified, key, sizeof(key)) != napi_ok) {
         return NULL;
     }
 
-    enum lite3_type type = lite3_ctx_get_type(ctx, (size_t)offset, key);
     napi_value result;
-
-    switch (type) {
-        case LITE3_TYPE_STRING: {
-            lite3_str str;
-            if (lite3_ctx_get_str(ctx, (size_t)offset, key, &str) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get string value");
-                return NULL;
-            }
-            napi_create_string_utf8(env, str.ptr, str.len, &result);
-            break;
-        }
-        case LITE3_TYPE_I64: {
-            int64_t val;
-            if (lite3_ctx_get_i64(ctx, (size_t)offset, key, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get integer value");
-                return NULL;
-            }
-            napi_create_int64(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_F64: {
-            double val;
-            if (lite3_ctx_get_f64(ctx, (size_t)offset, key, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get double value");
-                return NULL;
-            }
-            napi_create_double(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_BOOL: {
-            bool val;
-            if (lite3_ctx_get_bool(ctx, (size_t)offset, key, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get boolean value");
-                return NULL;
-            }
-            napi_get_boolean(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_NULL: {
-            napi_get_null(env, &result);
-            break;
-        }
-        case LITE3_TYPE_OBJECT:
-        case LITE3_TYPE_ARRAY: {
-            // For nested structures, return the offset as a number
-            // Caller should use getChildOffset for these
-            size_t child_offset;
-            int rc = (type == LITE3_TYPE_OBJECT)
-                ? lite3_ctx_get_obj(ctx, (size_t)offset, key, &child_offset)
-                : lite3_ctx_get_arr(ctx, (size_t)offset, key, &child_offset);
-            if (rc != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get child offset");
-                return NULL;
-            }
-            napi_create_int64(env, (int64_t)child_offset, &result);
-            break;
-        }
-        default: {
-            napi_get_undefined(env, &result);
-            break;
-        }
+    lite3_val *val;
+    if (lite3_get(buffer, buffer_len, (size_t)offset, key, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
     }
 
-    lite3_ctx_destroy(ctx);
+    if (value_to_js(env, info, buffer, buffer_len, verified, val, &result) != napi_ok) {
+        return NULL;
+    }
     return result;
 }
 
@@ -289,91 +268,109 @@ napi_value proxy_get_value(napi_env env, napi_callback_info info) {
  * getArrayElement(buffer, offset, index) -> any
  * Decodes and returns a single array element
  */
-napi_value proxy_get_array_element(napi_env env, napi_callback_info info) {
+static napi_value get_array_element(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     uint32_t index;
 
-    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &index) != napi_ok) {
+    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &verified, &index) != napi_ok) {
         return NULL;
     }
 
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    napi_value result;
+    lite3_val *val;
+    if (lite3_arr_get(buffer, buffer_len, (size_t)offset, index, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
+    }
+
+    if (value_to_js(env, info, buffer, buffer_len, verified, val, &result) != napi_ok) {
+        return NULL;
+    }
+    return result;
+}
+
+// Helper: like value_to_js(), but objects and arrays are returned as a
+// { type, offset } descriptor so the caller learns the kind of child and
+// where it lives from the same lookup.
+static napi_status
+entry_to_js(napi_env env, napi_callback_info info, void *buffer, size_t buffer_len,
+            bool verified, lite3_val *val, napi_value *result) {
+    enum lite3_type type = lite3_val_type(val);
+    if (type != LITE3_TYPE_OBJECT && type != LITE3_TYPE_ARRAY) {
+        return value_to_js(env, info, buffer, buffer_len, verified, val, result);
+    }
+
+    napi_value type_str, child_offset;
+    napi_status status = type_to_string(env, type, &type_str);
+    if (status != napi_ok) return status;
+    status = napi_create_int64(env, (int64_t)((unsigned char *)val - (unsigned char *)buffer), &child_offset);
+    if (status != napi_ok) return status;
+
+    status = napi_create_object(env, result);
+    if (status != napi_ok) return status;
+    status = napi_set_named_property(env, *result, "type", type_str);
+    if (status != napi_ok) return status;
+    return napi_set_named_property(env, *result, "offset", child_offset);
+}
+
+/**
+ * getEntry(buffer, offset, key) -> any
+ * Looks a property up once and returns its primitive value (bytes as a view),
+ * { type: "object" | "array", offset } for nested structures, or undefined
+ * if the key is absent
+ */
+static napi_value get_entry(napi_env env, napi_callback_info info) {
+    void *buffer;
+    size_t buffer_len;
+    int64_t offset;
+    bool verified;
+    char key[256];
+
+    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, &verified, key, sizeof(key)) != napi_ok) {
         return NULL;
     }
 
-    enum lite3_type type = lite3_ctx_arr_get_type(ctx, (size_t)offset, index);
     napi_value result;
+    lite3_val *val;
+    if (lite3_get(buffer, buffer_len, (size_t)offset, key, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
+    }
 
-    switch (type) {
-        case LITE3_TYPE_STRING: {
-            lite3_str str;
-            if (lite3_ctx_arr_get_str(ctx, (size_t)offset, index, &str) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get string value");
-                return NULL;
-            }
-            napi_create_string_utf8(env, str.ptr, str.len, &result);
-            break;
-        }
-        case LITE3_TYPE_I64: {
-            int64_t val;
-            if (lite3_ctx_arr_get_i64(ctx, (size_t)offset, index, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get integer value");
-                return NULL;
-            }
-            napi_create_int64(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_F64: {
-            double val;
-            if (lite3_ctx_arr_get_f64(ctx, (size_t)offset, index, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get double value");
-                return NULL;
-            }
-            napi_create_double(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_BOOL: {
-            bool val;
-            if (lite3_ctx_arr_get_bool(ctx, (size_t)offset, index, &val) != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get boolean value");
-                return NULL;
-            }
-            napi_get_boolean(env, val, &result);
-            break;
-        }
-        case LITE3_TYPE_NULL: {
-            napi_get_null(env, &result);
-            break;
-        }
-        case LITE3_TYPE_OBJECT:
-        case LITE3_TYPE_ARRAY: {
-            size_t child_offset;
-            int rc = (type == LITE3_TYPE_OBJECT)
-                ? lite3_ctx_arr_get_obj(ctx, (size_t)offset, index, &child_offset)
-                : lite3_ctx_arr_get_arr(ctx, (size_t)offset, index, &child_offset);
-            if (rc != 0) {
-                lite3_ctx_destroy(ctx);
-                napi_throw_error(env, NULL, "Failed to get child offset");
-                return NULL;
-            }
-            napi_create_int64(env, (int64_t)child_offset, &result);
-            break;
-        }
-        default: {
-            napi_get_undefined(env, &result);
-            break;
-        }
+    if (entry_to_js(env, info, buffer, buffer_len, verified, val, &result) != napi_ok) {
+        return NULL;
     }
+    return result;
+}
 
-    lite3_ctx_destroy(ctx);
+/**
+ * getArrayEntry(buffer, offset, index) -> any
+ * Array counterpart of getEntry
+ */
+static napi_value get_array_entry(napi_env env, napi_callback_info info) {
+    void *buffer;
+    size_t buffer_len;
+    int64_t offset;
+    bool verified;
+    uint32_t index;
+
+    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &verified, &index) != napi_ok) {
+        return NULL;
+    }
+
+    napi_value result;
+    lite3_val *val;
+    if (lite3_arr_get(buffer, buffer_len, (size_t)offset, index, &val) != 0) {
+        napi_get_undefined(env, &result);
+        return result;
+    }
+
+    if (entry_to_js(env, info, buffer, buffer_len, verified, val, &result) != napi_ok) {
+        return NULL;
+    }
     return result;
 }
 
@@ -381,38 +378,30 @@ napi_value proxy_get_array_element(napi_env env, napi_callback_info info) {
  * getChildOffset(buffer, offset, key) -> number
  * Returns the offset of a nested object or array
  */
-napi_value proxy_get_child_offset(napi_env env, napi_callback_info info) {
+static napi_value get_child_offset(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     char key[256];
 
-    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, key, sizeof(key)) != napi_ok) {
+    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, &verified, key, sizeof(key)) != napi_ok) {
         return NULL;
     }
 
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
-        return NULL;
-    }
-
-    enum lite3_type type = lite3_ctx_get_type(ctx, (size_t)offset, key);
+    enum lite3_type type = lite3_get_type(buffer, buffer_len, (size_t)offset, key);
     size_t child_offset;
     int rc;
 
     if (type == LITE3_TYPE_OBJECT) {
-        rc = lite3_ctx_get_obj(ctx, (size_t)offset, key, &child_offset);
+        rc = lite3_get_obj(buffer, buffer_len, (size_t)offset, key, &child_offset);
     } else if (type == LITE3_TYPE_ARRAY) {
-        rc = lite3_ctx_get_arr(ctx, (size_t)offset, key, &child_offset);
+        rc = lite3_get_arr(buffer, buffer_len, (size_t)offset, key, &child_offset);
     } else {
-        lite3_ctx_destroy(ctx);
         napi_throw_error(env, NULL, "Property is not an object or array");
         return NULL;
     }
 
-    lite3_ctx_destroy(ctx);
-
     if (rc != 0) {
         napi_throw_error(env, NULL, "Failed to get child offset");
         return NULL;
@@ -427,38 +416,30 @@ napi_value proxy_get_child_offset(napi_env env, napi_callback_info info) {
  * getArrayChildOffset(buffer, offset, index) -> number
  * Returns the offset of a nested object or array within an array
  */
-napi_value proxy_get_array_child_offset(napi_env env, napi_callback_info info) {
+static napi_value get_array_child_offset(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     uint32_t index;
 
-    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &index) != napi_ok) {
+    if (extract_args_arr(env, info, &buffer, &buffer_len, &offset, &verified, &index) != napi_ok) {
         return NULL;
     }
 
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
-        return NULL;
-    }
-
-    enum lite3_type type = lite3_ctx_arr_get_type(ctx, (size_t)offset, index);
+    enum lite3_type type = lite3_arr_get_type(buffer, buffer_len, (size_t)offset, index);
     size_t child_offset;
     int rc;
 
     if (type == LITE3_TYPE_OBJECT) {
-        rc = lite3_ctx_arr_get_obj(ctx, (size_t)offset, index, &child_offset);
+        rc = lite3_arr_get_obj(buffer, buffer_len, (size_t)offset, index, &child_offset);
     } else if (type == LITE3_TYPE_ARRAY) {
-        rc = lite3_ctx_arr_get_arr(ctx, (size_t)offset, index, &child_offset);
+        rc = lite3_arr_get_arr(buffer, buffer_len, (size_t)offset, index, &child_offset);
     } else {
-        lite3_ctx_destroy(ctx);
         napi_throw_error(env, NULL, "Element is not an object or array");
         return NULL;
     }
 
-    lite3_ctx_destroy(ctx);
-
     if (rc != 0) {
         napi_throw_error(env, NULL, "Failed to get child offset");
         return NULL;
@@ -473,45 +454,43 @@ napi_value proxy_get_array_child_offset(napi_env env, napi_callback_info info) {
  * getKeys(buffer, offset) -> string[]
  * Returns an array of keys for the object at the given offset
  */
-napi_value proxy_get_keys(napi_env env, napi_callback_info info) {
+static napi_value get_keys(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
 
-    if (extract_args_buf_ofs(env, info, &buffer, &buffer_len, &offset) != napi_ok) {
-        return NULL;
-    }
-
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    if (extract_args_buf_ofs(env, info, &buffer, &buffer_len, &offset, &verified) != napi_ok) {
         return NULL;
     }
 
     // Create result array
     napi_value result;
-    NAPI_CALL(env, ctx, napi_create_array(env, &result), NULL);
+    NAPI_CALL(env, NULL, napi_create_array(env, &result), NULL);
 
     // Iterate and collect keys
     lite3_iter iter;
-    if (lite3_ctx_iter_create(ctx, (size_t)offset, &iter) != 0) {
-        lite3_ctx_destroy(ctx);
+    if (lite3_iter_create(buffer, buffer_len, (size_t)offset, &iter) != 0) {
         napi_throw_error(env, NULL, "Failed to create iterator");
         return NULL;
     }
 
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
     uint32_t i = 0;
     lite3_str key;
     size_t val_ofs;
-    while (lite3_ctx_iter_next(ctx, &iter, &key, &val_ofs) == LITE3_ITER_ITEM) {
+    while (lite3_iter_next(buffer, buffer_len, &iter, &key, &val_ofs) == LITE3_ITER_ITEM) {
+        if (!verified && !lite3_napi_check_key(buffer, buffer_len, key.ptr)) {
+            throw_malformed(env);
+            return NULL;
+        }
         napi_value key_str;
         // Use strlen() as lite3_str.len may include extra data beyond the null terminator
-        NAPI_CALL(env, ctx, napi_create_string_utf8(env, key.ptr, strlen(key.ptr), &key_str), NULL);
-        NAPI_CALL(env, ctx, napi_set_element(env, result, i, key_str), NULL);
+        NAPI_CALL(env, NULL, lite3_napi_key_string(env, instance, key.ptr, strlen(key.ptr), &key_str), NULL);
+        NAPI_CALL(env, NULL, napi_set_element(env, result, i, key_str), NULL);
         i++;
     }
 
-    lite3_ctx_destroy(ctx);
     return result;
 }
 
@@ -519,30 +498,22 @@ napi_value proxy_get_keys(napi_env env, napi_callback_info info) {
  * getLength(buffer, offset) -> number
  * Returns the length of an array or object at the given offset
  */
-napi_value proxy_get_length(napi_env env, napi_callback_info info) {
+static napi_value get_length(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
 
-    if (extract_args_buf_ofs(env, info, &buffer, &buffer_len, &offset) != napi_ok) {
-        return NULL;
-    }
-
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    if (extract_args_buf_ofs(env, info, &buffer, &buffer_len, &offset, &verified) != napi_ok) {
         return NULL;
     }
 
     uint32_t count;
-    if (lite3_ctx_count(ctx, (size_t)offset, &count) < 0) {
-        lite3_ctx_destroy(ctx);
+    if (lite3_count(buffer, buffer_len, (size_t)offset, &count) < 0) {
         napi_throw_error(env, NULL, "Failed to get element count");
         return NULL;
     }
 
-    lite3_ctx_destroy(ctx);
-
     napi_value result;
     napi_create_uint32(env, count, &result);
     return result;
@@ -552,25 +523,18 @@ napi_value proxy_get_length(napi_env env, napi_callback_info info) {
  * hasKey(buffer, offset, key) -> boolean
  * Returns true if the object has the given key
  */
-napi_value proxy_has_key(napi_env env, napi_callback_info info) {
+static napi_value has_key(napi_env env, napi_callback_info info) {
     void *buffer;
     size_t buffer_len;
     int64_t offset;
+    bool verified;
     char key[256];
 
-    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, key, sizeof(key)) != napi_ok) {
-        return NULL;
-    }
-
-    lite3_ctx *ctx = lite3_ctx_create_from_buf(buffer, buffer_len);
-    if (!ctx) {
-        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+    if (extract_args_obj(env, info, &buffer, &buffer_len, &offset, &verified, key, sizeof(key)) != napi_ok) {
         return NULL;
     }
 
-    enum lite3_type type = lite3_ctx_get_type(ctx, (size_t)offset, key);
-    lite3_ctx_destroy(ctx);
-
+    enum lite3_type type = lite3_get_type(buffer, buffer_len, (size_t)offset, key);
     bool exists = (type != LITE3_TYPE_INVALID);
 
     napi_value result;
@@ -582,7 +546,7 @@ napi_value proxy_has_key(napi_env env, napi_callback_info info) {
  * getRootType(buffer) -> string
  * Returns the type of the root element
  */
-napi_value proxy_get_root_type(napi_env env, napi_callback_info info) {
+static napi_value get_root_type(napi_env env, napi_callback_info info) {
     size_t argc = 1;
     napi_value argv[1];
 
@@ -597,14 +561,8 @@ napi_value proxy_get_root_type(napi_env env, napi_callback_info info) {
 
     void *buffer;
     size_t buffer_len;
-    bool is_buffer;
-
-    if (napi_is_buffer(env, argv[0], &is_buffer) != napi_ok || !is_buffer) {
-        napi_throw_type_error(env, NULL, "Argument must be a Buffer");
-        return NULL;
-    }
-
-    if (napi_get_buffer_info(env, argv[0], &buffer, &buffer_len) != napi_ok) {
+    if (lite3_napi_get_message(env, argv[0], "Argument must be a Buffer or Uint8Array",
+                               &buffer, &buffer_len) != napi_ok) {
         return NULL;
     }
 
@@ -621,4 +579,18 @@ napi_value proxy_get_root_type(napi_env env, napi_callback_info info) {
         return NULL;
     }
     return result;
-}
\ No newline at end of file
+}
+
+// Exported entry points, timed as proxy reads while stats are enabled:
+LITE3_NAPI_TIMED(proxy_get_type, get_type, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_array_type, get_array_type, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_value, get_value, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_array_element, get_array_element, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_entry, get_entry, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_array_entry, get_array_entry, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_child_offset, get_child_offset, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_array_child_offset, get_array_child_offset, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_keys, get_keys, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_length, get_length, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_has_key, has_key, LITE3_NAPI_PHASE_PROXY)
+LITE3_NAPI_TIMED(proxy_get_root_type, get_root_type, LITE3_NAPI_PHASE_PROXY)
@@ -0,0 +1,375 @@
+/**
+ * Compiled Schemas
+ *
+ * compileSchema(shape) describes a fixed record shape up front, so encoding
+ * and decoding it skip the discovery encode() and decode() do per message:
+ *
+ *   - property names are not enumerated; each field is read with a key
+ *     string created once, and written with its UTF-8 form converted once
+ *   - values are read with the N-API getter for the declared type instead
+ *     of asking for their type first
+ *   - the lite3 context is sized from the messages encoded so far
+ *   - decoded objects are built with the fields in shape order, so every
+ *     object of a shape gets the same hidden class
+ *
+ * A shape is an object whose values are type names ("string", "number",
+ * "integer", "bigint", "boolean", "bytes", "any"), nested shapes, or a
+ * one-element array holding the type of an array's elements:
+ *
+ *   compileSchema({ id: 'integer', name: 'string', tags: ['string'],
+ *                   owner: { id: 'integer', email: 'string' } })
+ *
+ * A value that doesn't match its declared type is encoded as encode() would
+ * store it, so a schema never loses data; it is only slower for that value.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Deepest nesting of shapes and arrays accepted, which also stops cycles.
+#define SCHEMA_MAX_DEPTH 64
+
+typedef struct {
+    lite3_napi_shape *shape;
+    size_t size_hint;       // decaying maximum of encoded message sizes
+    lite3_napi_encode_options options;
+} lite3_napi_schema;
+
+static const struct {
+    const char *name;
+    lite3_napi_type type;
+} type_names[] = {
+    { "any", LITE3_NAPI_TYPE_ANY },
+    { "string", LITE3_NAPI_TYPE_STRING },
+    { "number", LITE3_NAPI_TYPE_NUMBER },
+    { "integer", LITE3_NAPI_TYPE_INTEGER },
+    { "bigint", LITE3_NAPI_TYPE_BIGINT },
+    { "boolean", LITE3_NAPI_TYPE_BOOLEAN },
+    { "bytes", LITE3_NAPI_TYPE_BYTES },
+};
+
+static void shape_free(napi_env, lite3_napi_shape*);
+
+static void
+spec_free(napi_env env, lite3_napi_type_spec *spec) {
+    if (spec->shape) shape_free(env, spec->shape);
+    if (spec->element) {
+        spec_free(env, spec->element);
+        free(spec->element);
+    }
+}
+
+static void
+shape_free(napi_env env, lite3_napi_shape *shape) {
+    for (uint32_t i = 0; i < shape->count; i++) {
+        free(shape->fields[i].key);
+        spec_free(env, &shape->fields[i].spec);
+    }
+    if (shape->names) napi_delete_reference(env, shape->names);
+    free(shape->fields);
+    free(shape);
+}
+
+static void
+schema_finalize(napi_env env, void *data, void *hint) {
+    (void)hint;
+
+    lite3_napi_schema *schema = data;
+    if (schema->shape) shape_free(env, schema->shape);
+    free(schema);
+}
+
+static napi_status
+throw_invalid(napi_env env, const char *key) {
+    char message[256];
+    snprintf(message, sizeof(message),
+             "Invalid schema type for \"%.160s\": expected a type name, a shape or a one-element array", key);
+    napi_throw_type_error(env, NULL, message);
+    return napi_invalid_arg;
+}
+
+static napi_status parse_shape(napi_env, napi_value, uint32_t, lite3_napi_shape**);
+
+// Parse the type declared for `key`.
+static napi_status
+parse_spec(napi_env env, napi_value value, const char *key, uint32_t depth, lite3_napi_type_spec *spec) {
+    if (depth > SCHEMA_MAX_DEPTH) {
+        napi_throw_range_error(env, NULL, "Schema is nested too deeply");
+        return napi_invalid_arg;
+    }
+
+    napi_valuetype type;
+    napi_status status = napi_typeof(env, value, &type);
+    if (status != napi_ok) return status;
+
+    if (type == napi_string) {
+        char name[16];
+        status = napi_get_value_string_utf8(env, value, name, sizeof(name), NULL);
+        if (status != napi_ok) return status;
+        for (size_t i = 0; i < a_count(type_names); i++) {
+            if (strcmp(name, type_names[i].name) == 0) {
+                spec->type = type_names[i].type;
+                return napi_ok;
+            }
+        }
+        return throw_invalid(env, key);
+    }
+    if (type != napi_object) return throw_invalid(env, key);
+
+    bool is_array;
+    status = napi_is_array(env, value, &is_array);
+    if (status != napi_ok) return status;
+    if (!is_array) {
+        spec->type = LITE3_NAPI_TYPE_OBJECT;
+        return parse_shape(env, value, depth + 1, &spec->shape);
+    }
+
+    uint32_t length;
+    status = napi_get_array_length(env, value, &length);
+    if (status != napi_ok) return status;
+    if (length != 1) return throw_invalid(env, key);
+
+    napi_value element;
+    status = napi_get_element(env, value, 0, &element);
+    if (status != napi_ok) return status;
+
+    spec->type = LITE3_NAPI_TYPE_ARRAY;
+    spec->element = calloc(1, sizeof(*spec->element));
+    if (!spec->element) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+    return parse_spec(env, element, key, depth + 1, spec->element);
+}
+
+// Parse a shape object into its fields, in property order.
+static napi_status
+parse_shape(napi_env env, napi_value value, uint32_t depth, lite3_napi_shape **result) {
+    napi_value names;
+    napi_status status = napi_get_property_names(env, value, &names);
+    if (status != napi_ok) return status;
+
+    uint32_t count;
+    status = napi_get_array_length(env, names, &count);
+    if (status != napi_ok) return status;
+
+    lite3_napi_shape *shape = calloc(1, sizeof(*shape));
+    if (shape) shape->fields = calloc(count ? count : 1, sizeof(*shape->fields));
+    if (!shape || !shape->fields) {
+        free(shape);
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return napi_generic_failure;
+    }
+
+    // The names array returned above is kept as the shape's key strings:
+    status = napi_create_reference(env, names, 1, &shape->names);
+
+    for (uint32_t i = 0; i < count && status == napi_ok; i++) {
+        lite3_napi_shape_field *field = &shape->fields[i];
+
+        napi_value name, declared;
+        size_t len;
+        status = napi_get_element(env, names, i, &name);
+        if (status == napi_ok) status = napi_get_value_string_utf8(env, name, NULL, 0, &len);
+        if (status != napi_ok) break;
+
+        field->key = malloc(len + 1);
+        if (!field->key) {
+            napi_throw_error(env, NULL, "Memory allocation failure");
+            status = napi_generic_failure;
+            break;
+        }
+        shape->count++;
+        status = napi_get_value_string_utf8(env, name, field->key, len + 1, NULL);
+        if (status == napi_ok) status = napi_get_property(env, value, name, &declared);
+        if (status == napi_ok) status = parse_spec(env, declared, field->key, depth, &field->spec);
+    }
+
+    if (status != napi_ok) {
+        shape_free(env, shape);
+        return status;
+    }
+    *result = shape;
+    return napi_ok;
+}
+
+static lite3_napi_schema *
+unwrap_schema(napi_env env, napi_callback_info info, size_t *argc, napi_value *argv) {
+    napi_value this_arg;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, argc, argv, &this_arg, NULL), NULL);
+
+    lite3_napi_schema *schema;
+    NAPI_CALL(env, NULL, napi_unwrap(env, this_arg, (void **)&schema), NULL);
+    return schema;
+}
+
+// new Schema(shape, options?), reached through compileSchema().
+static napi_value
+schema_constructor(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    napi_value this_arg;
+    napi_value new_target;
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, &this_arg, NULL), NULL);
+    NAPI_CALL(env, NULL, napi_get_new_target(env, info, &new_target), NULL);
+    if (new_target == NULL) {
+        napi_throw_type_error(env, NULL, "Schema must be called with new");
+        return NULL;
+    }
+
+    napi_valuetype type = napi_undefined;
+    bool is_array = false;
+    if (argc > 0) {
+        NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+        NAPI_CALL(env, NULL, napi_is_array(env, argv[0], &is_array), NULL);
+    }
+    if (type != napi_object || is_array) {
+        napi_throw_type_error(env, NULL, "Shape must be an object");
+        return NULL;
+    }
+
+    lite3_napi_encode_options options;
+    NAPI_CALL(env, NULL, lite3_napi_get_encode_options(env, argc > 1 ? argv[1] : NULL, &options), NULL);
+
+    lite3_napi_schema *schema = calloc(1, sizeof(*schema));
+    if (!schema) {
+        napi_throw_error(env, NULL, "Memory allocation failure");
+        return NULL;
+    }
+    schema->options = options;
+    napi_status status = parse_shape(env, argv[0], 0, &schema->shape);
+    if (status != napi_ok) {
+        free(schema);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    status = napi_wrap(env, this_arg, schema, schema_finalize, NULL, NULL);
+    if (status != napi_ok) {
+        schema_finalize(env, schema, NULL);
+        NAPI_CALL(env, NULL, status, NULL);
+    }
+
+    return this_arg;
+}
+
+/**
+ * schema.encode(value) -> Buffer
+ * Encodes an object of the schema's shape. Properties not in the shape are
+ * left out.
+ */
+static napi_value
+schema_encode(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_schema *schema = unwrap_schema(env, info, &argc, argv);
+    if (!schema) return NULL;
+
+    napi_valuetype type = napi_undefined;
+    if (argc > 0) {
+        NAPI_CALL(env, NULL, napi_typeof(env, argv[0], &type), NULL);
+    }
+    if (type != napi_object) {
+        napi_throw_type_error(env, NULL, "Argument must be an object");
+        return NULL;
+    }
+
+    // Size the context for the largest recent message, plus 25% headroom:
+    lite3_ctx *ctx = schema->size_hint
+        ? lite3_ctx_create_with_size(schema->size_hint + schema->size_hint / 4)
+        : lite3_ctx_create();
+    if (!ctx) {
+        napi_throw_error(env, NULL, "Failed to create Lite3 context");
+        return NULL;
+    }
+    LITE3_NAPI_STATS_INC(lite3_napi_get_instance(env), contexts);
+
+    NAPI_CALL(env, ctx, lite3_napi_encode_shape(env, argv[0], schema->shape, ctx, &schema->options), NULL);
+
+    // A maximum that decays by 1/8 per message, as in Encoder:
+    size_t decayed = schema->size_hint - schema->size_hint / 8;
+    schema->size_hint = ctx->buflen > decayed ? ctx->buflen : decayed;
+
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_ctx_to_buffer(env, ctx, true, &result), NULL);
+    return result;
+}
+
+/**
+ * schema.decode(buffer) -> object
+ * Decodes a message into an object with the shape's fields, in shape order.
+ * Fields missing from the message are left out; other keys are ignored.
+ */
+static napi_value
+schema_decode(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    lite3_napi_schema *schema = unwrap_schema(env, info, &argc, argv);
+    if (!schema) return NULL;
+
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1 argument: buffer");
+        return NULL;
+    }
+
+    napi_value result;
+    NAPI_CALL(env, NULL, lite3_napi_decode_shape(env, argv[0], schema->shape, &result), NULL);
+    return result;
+}
+
+/**
+ * schema.keys -> string[]
+ * Top-level field names, in shape order.
+ */
+static napi_value
+schema_get_keys(napi_env env, napi_callback_info info) {
+    size_t argc = 0;
+    lite3_napi_schema *schema = unwrap_schema(env, info, &argc, NULL);
+    if (!schema) return NULL;
+
+    napi_value names, result;
+    NAPI_CALL(env, NULL, napi_get_reference_value(env, schema->shape->names, &names), NULL);
+    NAPI_CALL(env, NULL, napi_create_array_with_length(env, schema->shape->count, &result), NULL);
+    for (uint32_t i = 0; i < schema->shape->count; i++) {
+        napi_value name;
+        NAPI_CALL(env, NULL, napi_get_element(env, names, i, &name), NULL);
+        NAPI_CALL(env, NULL, napi_set_element(env, result, i, name), NULL);
+    }
+    return result;
+}
+
+napi_status
+schema_define_class(napi_env env, napi_value *result) {
+    napi_property_descriptor props[] = {
+        { "encode", NULL, schema_encode, NULL, NULL, NULL, napi_default_method, NULL },
+        { "decode", NULL, schema_decode, NULL, NULL, NULL, napi_default_method, NULL },
+        { "keys", NULL, NULL, schema_get_keys, NULL, NULL, napi_default, NULL }
+    };
+
+    napi_status status = napi_define_class(env, "Schema", NAPI_AUTO_LENGTH, schema_constructor, NULL,
+                                           a_count(props), props, result);
+    if (status != napi_ok) return status;
+
+    // Kept so compileSchema() can construct schemas:
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    return napi_create_reference(env, *result, 1, &instance->schema_constructor);
+}
+
+/**
+ * compileSchema(shape, options?) -> Schema
+ *   options.integers - as for encode(), for "any" fields (default: false)
+ */
+napi_value
+compile_schema(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    napi_value constructor, result;
+    NAPI_CALL(env, NULL, napi_get_reference_value(env, instance->schema_constructor, &constructor), NULL);
+    NAPI_CALL(env, NULL, napi_new_instance(env, constructor, argc < 2 ? argc : 2, argv, &result), NULL);
+    return result;
+}
@@ -0,0 +1,138 @@
+/**
+ * Instrumentation Counters
+ *
+ * Opt-in counters for finding where time goes in production: how many calls
+ * each phase (encode, decode, proxy reads) served, the bytes they moved and
+ * the nanoseconds they took, plus lite3 context creations, buffer growth and
+ * the number of JS values created.
+ *
+ * Counters are per environment and off by default. While disabled, every
+ * instrumented path costs one branch on a thread-local flag, without even
+ * looking up the environment's state, and the clock is never read. An
+ * environment lives on one thread (the main thread or a worker's), so the
+ * flag mirrors its `enabled` setting. Only synchronous work on the JS thread is counted;
+ * the threadpool half of the async functions is not.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <uv.h>
+#include <string.h>
+
+LITE3_NAPI_THREAD_LOCAL bool lite3_napi_stats_thread_on;
+
+uint64_t
+lite3_napi_stats_clock(void) {
+    return uv_hrtime();
+}
+
+// Account one call of `phase` that started at `start` (a clock reading).
+void
+lite3_napi_stats_record(lite3_napi_instance *instance, lite3_napi_phase phase, uint64_t start, size_t bytes) {
+    lite3_napi_phase_stats *stats = &instance->stats.phases[phase];
+    stats->calls++;
+    stats->bytes += bytes;
+    stats->ns += uv_hrtime() - start;
+}
+
+// Run `callback`, timing it as `phase` when stats are enabled.
+napi_value
+lite3_napi_timed(napi_env env, napi_callback_info info, napi_callback callback, lite3_napi_phase phase) {
+    if (!lite3_napi_stats_thread_on) return callback(env, info);
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    if (!LITE3_NAPI_STATS_ON(instance)) return callback(env, info);
+
+    uint64_t start = uv_hrtime();
+    napi_value result = callback(env, info);
+    lite3_napi_stats_record(instance, phase, start, 0);
+    return result;
+}
+
+static napi_status
+set_stat(napi_env env, napi_value obj, const char *name, double value) {
+    napi_value num;
+    napi_status status = napi_create_double(env, value, &num);
+    if (status != napi_ok) return status;
+    return napi_set_named_property(env, obj, name, num);
+}
+
+static napi_status
+set_phase(napi_env env, napi_value obj, const char *name, const lite3_napi_phase_stats *stats,
+          const char *bytes_name) {
+    napi_value phase;
+    napi_status status = napi_create_object(env, &phase);
+    if (status != napi_ok) return status;
+    status = set_stat(env, phase, "calls", (double)stats->calls);
+    if (status == napi_ok && bytes_name) status = set_stat(env, phase, bytes_name, (double)stats->bytes);
+    if (status == napi_ok) status = set_stat(env, phase, "ns", (double)stats->ns);
+    if (status != napi_ok) return status;
+    return napi_set_named_property(env, obj, name, phase);
+}
+
+/**
+ * stats() -> { enabled, encode, decode, proxy, contexts, reallocs, copies, napiValues }
+ * Returns this environment's counters since the last resetStats().
+ */
+napi_value
+get_stats(napi_env env, napi_callback_info info) {
+    (void)info;  // unused
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    lite3_napi_stats empty = { 0 };
+    const lite3_napi_stats *stats = instance ? &instance->stats : &empty;
+
+    napi_value result, enabled;
+    NAPI_CALL(env, NULL, napi_create_object(env, &result), NULL);
+    NAPI_CALL(env, NULL, napi_get_boolean(env, stats->enabled, &enabled), NULL);
+    NAPI_CALL(env, NULL, napi_set_named_property(env, result, "enabled", enabled), NULL);
+    NAPI_CALL(env, NULL, set_phase(env, result, "encode", &stats->phases[LITE3_NAPI_PHASE_ENCODE], "bytesOut"), NULL);
+    NAPI_CALL(env, NULL, set_phase(env, result, "decode", &stats->phases[LITE3_NAPI_PHASE_DECODE], "bytesIn"), NULL);
+    NAPI_CALL(env, NULL, set_phase(env, result, "proxy", &stats->phases[LITE3_NAPI_PHASE_PROXY], NULL), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "contexts", (double)stats->contexts), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "reallocs", (double)stats->reallocs), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "copies", (double)stats->copies), NULL);
+    NAPI_CALL(env, NULL, set_stat(env, result, "napiValues", (double)stats->napi_values), NULL);
+    return result;
+}
+
+/**
+ * resetStats() -> undefined
+ * Zeroes the counters; whether they are collected is unchanged.
+ */
+napi_value
+reset_stats(napi_env env, napi_callback_info info) {
+    (void)info;  // unused
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    if (instance) {
+        bool enabled = instance->stats.enabled;
+        memset(&instance->stats, 0, sizeof(instance->stats));
+        instance->stats.enabled = enabled;
+    }
+    return NULL;
+}
+
+/**
+ * setStatsEnabled(enabled) -> undefined
+ * Starts or stops collecting counters for this environment.
+ */
+napi_value
+set_stats_enabled(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CALL(env, NULL, napi_get_cb_info(env, info, &argc, argv, NULL, NULL), NULL);
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Expected 1 argument: enabled");
+        return NULL;
+    }
+
+    bool enabled;
+    NAPI_CALL(env, NULL, napi_get_value_bool(env, argv[0], &enabled), NULL);
+
+    lite3_napi_instance *instance = lite3_napi_get_instance(env);
+    if (instance) {
+        instance->stats.enabled = enabled;
+        lite3_napi_stats_thread_on = enabled;
+    }
+    return NULL;
+}
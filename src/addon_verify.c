@@ -0,0 +1,260 @@
+/**
+ * Structural validation for untrusted buffers
+ *
+ * verify(buffer) walks a whole message once, checking that every node and
+ * value lies within the Buffer, that every type is known, that every key is
+ * terminated, and that nested objects and arrays only point forwards (so the
+ * structure can't loop back on itself). It creates no JS values.
+ *
+ * A Buffer that passes is marked as verified. The proxy functions, decode()
+ * and cursors check the mark and skip their per-value bounds checks for it.
+ * The mark only caches the last result: verify() always walks the message
+ * again and clears the mark if it no longer passes. It belongs to the Buffer
+ * object, so verify again after writing to the memory directly. Buffers over
+ * a SharedArrayBuffer or a mapped file (see addon_file.c) are never marked,
+ * as another thread or process can write to them at any time.
+ */
+
+#include <node_api.h>
+#include <lite3-napi.h>
+#include <lite3.h>
+#include <string.h>
+
+// Deepest nesting verify() accepts; decoding recurses once per level.
+#define VERIFY_MAX_DEPTH 256
+
+// Payload bytes following the type byte of fixed-size values, and the length
+// prefix of strings and bytes.
+#define VERIFY_BOOL_SIZE   1
+#define VERIFY_NUMBER_SIZE 8
+#define VERIFY_LENGTH_SIZE 4
+
+// Buffers that passed verify() are wrapped with a pointer to this. A type
+// tag can't be removed again, so a wrap marks them instead.
+static char verified_mark;
+
+// Check the non-container value at `offset` lies within the buffer.
+bool
+lite3_napi_check_value(const unsigned char *buf, size_t buflen, size_t offset) {
+    if (offset >= buflen) return false;
+
+    lite3_val *val = (lite3_val *)(buf + offset);
+    size_t avail = buflen - offset - 1;
+    size_t len;
+    const unsigned char *data;
+
+    switch (lite3_val_type(val)) {
+        case LITE3_TYPE_NULL:
+            return true;
+        case LITE3_TYPE_BOOL:
+            return avail >= VERIFY_BOOL_SIZE;
+        case LITE3_TYPE_I64:
+        case LITE3_TYPE_F64:
+            return avail >= VERIFY_NUMBER_SIZE;
+        case LITE3_TYPE_STRING:
+            if (avail < VERIFY_LENGTH_SIZE) return false;
+            data = (const unsigned char *)lite3_val_str_n(val, &len);
+            break;
+        case LITE3_TYPE_BYTES:
+            if (avail < VERIFY_LENGTH_SIZE) return false;
+            data = lite3_val_bytes(val, &len);
+            break;
+        case LITE3_TYPE_OBJECT:
+        case LITE3_TYPE_ARRAY:
+            return true;
+        default:
+            return false;
+    }
+    return data >= buf && data <= buf + buflen && len <= (size_t)(buf + buflen - data);
+}
+
+// Check a key returned by the iterator is null-terminated within the buffer.
+bool
+lite3_napi_check_key(const unsigned char *buf, size_t buflen, const char *key) {
+    const unsigned char *p = (const unsigned char *)key;
+    return p >= buf && p < buf + buflen && memchr(p, '\0', (size_t)(buf + buflen - p)) != NULL;
+}
+
+// Verify the object or array at `offset` and everything below it. `budget`
+// bounds the total number of values: each takes at least one byte, so a
+// well-formed message never has more values than bytes.
+static bool
+verify_node(const unsigned char *buf, size_t buflen, size_t offset, int depth, size_t *budget) {
+    if (depth > VERIFY_MAX_DEPTH) return false;
+
+    enum lite3_type type = lite3_val_type((lite3_val *)(buf + offset));
+    uint32_t count;
+    lite3_iter iter;
+    if (lite3_count(buf, buflen, offset, &count) < 0) return false;
+    if (lite3_iter_create(buf, buflen, offset, &iter) != 0) return false;
+
+    uint32_t seen = 0;
+    lite3_str key;
+    size_t val_offset;
+    int rc;
+    while ((rc = lite3_iter_next(buf, buflen, &iter, type == LITE3_TYPE_OBJECT ? &key : NULL, &val_offset)) == LITE3_ITER_ITEM) {
+        if (*budget == 0 || seen == count) return false;
+        (*budget)--;
+        seen++;
+
+        if (type == LITE3_TYPE_OBJECT && !lite3_napi_check_key(buf, buflen, key.ptr)) return false;
+        if (!lite3_napi_check_value(buf, buflen, val_offset)) return false;
+
+        enum lite3_type val_type = lite3_val_type((lite3_val *)(buf + val_offset));
+        if (val_type == LITE3_TYPE_OBJECT || val_type == LITE3_TYPE_ARRAY) {
+            // Children are always written after their parent; anything else
+            // could form a cycle.
+            if (val_offset <= offset) return false;
+            if (!verify_node(buf, buflen, val_offset, depth + 1, budget)) return false;
+        }
+    }
+    return rc == LITE3_ITER_DONE && seen == count;
+}
+
+// Verify the object or array at `offset` and everything below it without
+// marking anything. Creates no JS values, so it is safe to run off-thread.
+bool
+lite3_napi_verify_node(const unsigned char *buf, size_t buflen, size_t offset) {
+    if (offset >= buflen) return false;
+
+    enum lite3_type type = lite3_val_type((lite3_val *)(buf + offset));
+    size_t budget = buflen;
+    return (type == LITE3_TYPE_OBJECT || type == LITE3_TYPE_ARRAY)
+        && verify_node(buf, buflen, offset, 0, &budget);
+}
+
+// Search below the node at `node` of a verified message for an object or
+// array starting at `target`. Children always come after their parent, so
+// subtrees starting past `target` are skipped.
+static bool
+find_node(const unsigned char *buf, size_t buflen, size_t node, size_t target, int depth) {
+    if (depth > VERIFY_MAX_DEPTH) return false;
+
+    lite3_iter iter;
+    if (lite3_iter_create(buf, buflen, node, &iter) != 0) return false;
+
+    size_t val_offset;
+    while (lite3_iter_next(buf, buflen, &iter, NULL, &val_offset) == LITE3_ITER_ITEM) {
+        if (val_offset > target) continue;
+
+        enum lite3_type type = lite3_val_type((lite3_val *)(buf + val_offset));
+        if (type != LITE3_TYPE_OBJECT && type != LITE3_TYPE_ARRAY) continue;
+        if (val_offset == target || find_node(buf, buflen, val_offset, target, depth + 1)) return true;
+    }
+    return false;
+}
+
+// Check that `offset`, given by the caller rather than found by walking the
+// message, starts an object or array. In a verified message it must be one
+// reachable from the root, since reads from it skip their bounds checks; in
+// any other message every read is checked, so the type byte is enough.
+bool
+lite3_napi_check_node(const unsigned char *buf, size_t buflen, size_t offset, bool verified) {
+    if (offset >= buflen) return false;
+
+    enum lite3_type type = lite3_val_type((lite3_val *)(buf + offset));
+    if (type != LITE3_TYPE_OBJECT && type != LITE3_TYPE_ARRAY) return false;
+
+    return !verified || offset == 0 || find_node(buf, buflen, 0, offset, 0);
+}
+
+// Returns true if `buffer` is marked by a successful verify().
+napi_status
+lite3_napi_is_verified(napi_env env, napi_value buffer, bool *result) {
+    void *mark;
+    napi_status status = napi_unwrap(env, buffer, &mark);
+    *result = status == napi_ok && mark == &verified_mark;
+    return status == napi_invalid_arg ? napi_ok : status;  // not wrapped
+}
+
+// True if the memory behind `buffer` can change while this thread reads it:
+// a SharedArrayBuffer, which other threads may write to, or a mapped file,
+// which other processes may. A mark would vouch for bytes that may no longer
+// be the ones verified.
+static napi_status
+is_volatile(napi_env env, napi_value buffer, bool *result) {
+    napi_value arraybuffer;
+    napi_status status = napi_get_typedarray_info(env, buffer, NULL, NULL, NULL, &arraybuffer, NULL);
+    if (status != napi_ok) return status;
+
+    bool is_arraybuffer;
+    status = napi_is_arraybuffer(env, arraybuffer, &is_arraybuffer);
+    if (status != napi_ok || !is_arraybuffer) {
+        *result = true;
+        return status;
+    }
+    return napi_check_object_type_tag(env, arraybuffer, &lite3_napi_mapped_type_tag, result);
+}
+
+// Shared argument handling: the Buffer and its memory.
+static napi_status
+verify_args(napi_env env, napi_callback_info info, napi_value *buffer, void **buf, size_t *buflen) {
+    size_t argc = 1;
+    napi_status status = napi_get_cb_info(env, info, &argc, buffer, NULL, NULL);
+    if (status != napi_ok) return status;
+
+    if (argc < 1) {
+        napi_throw_type_error(env, NULL, "Argument must be a Buffer or Uint8Array");
+        return napi_invalid_arg;
+    }
+    return lite3_napi_get_message(env, *buffer, "Argument must be a Buffer or Uint8Array", buf, buflen);
+}
+
+/**
+ * verify(buffer) -> boolean
+ * Checks the whole structure of a Lite3 Buffer. On success the Buffer is
+ * marked as verified (unless its memory is shared or mapped) and true is
+ * returned; false means it is malformed, and clears any mark left by an
+ * earlier verify().
+ */
+napi_value
+verify(napi_env env, napi_callback_info info) {
+    napi_value buffer;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, verify_args(env, info, &buffer, &buf, &buflen), NULL);
+
+    bool verified;
+    NAPI_CALL(env, NULL, lite3_napi_is_verified(env, buffer, &verified), NULL);
+
+    bool valid = false;
+    if (buflen > 0) {
+        enum lite3_type type = lite3_val_type((lite3_val *)buf);
+        size_t budget = buflen;
+        valid = (type == LITE3_TYPE_OBJECT || type == LITE3_TYPE_ARRAY)
+            && verify_node(buf, buflen, 0, 0, &budget);
+    }
+
+    bool shared = false;
+    if (valid && !verified) {
+        NAPI_CALL(env, NULL, is_volatile(env, buffer, &shared), NULL);
+    }
+    if (valid && !verified && !shared) {
+        NAPI_CALL(env, NULL, napi_wrap(env, buffer, &verified_mark, NULL, NULL, NULL), NULL);
+    } else if (!valid && verified) {
+        NAPI_CALL(env, NULL, napi_remove_wrap(env, buffer, NULL), NULL);
+    }
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_get_boolean(env, valid, &result), NULL);
+    return result;
+}
+
+/**
+ * isVerified(buffer) -> boolean
+ * Returns true if verify() has accepted this Buffer.
+ */
+napi_value
+is_verified(napi_env env, napi_callback_info info) {
+    napi_value buffer;
+    void *buf;
+    size_t buflen;
+    NAPI_CALL(env, NULL, verify_args(env, info, &buffer, &buf, &buflen), NULL);
+
+    bool verified;
+    NAPI_CALL(env, NULL, lite3_napi_is_verified(env, buffer, &verified), NULL);
+
+    napi_value result;
+    NAPI_CALL(env, NULL, napi_get_boolean(env, verified, &result), NULL);
+    return result;
+}
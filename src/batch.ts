@@ -0,0 +1,166 @@
+/**
+ * BatchDecoder - Reads batches written by the native BatchEncoder
+ *
+ * A batch is a sequence of frames, each a u32 little-endian length followed
+ * by a lite3 message of that length. Frames are returned as zero-copy slices
+ * of the input, ready for `decode()` or `Lite3Buffer.from()`.
+ *
+ * For streams, push() accepts chunks split at arbitrary points. Only a frame
+ * that straddles two chunks is copied; every other frame is a slice of the
+ * chunk it arrived in, so don't reuse a chunk's memory while its frames are
+ * in use. The length header of a frame comes from the stream, so frames
+ * longer than `maxFrameLength` are refused before any memory is set aside
+ * for them.
+ */
+
+import { decode, type DecodeOptions } from './index';
+
+/** Bytes of the length header in front of every frame */
+export const FRAME_HEADER_SIZE = 4;
+
+/** Default for `BatchDecoderOptions.maxFrameLength`: 64 MiB */
+export const DEFAULT_MAX_FRAME_LENGTH = 64 * 1024 * 1024;
+
+/** Options accepted by `new BatchDecoder()` */
+export interface BatchDecoderOptions extends DecodeOptions {
+  /**
+   * Longest frame `push()` accepts, in bytes. A longer length header throws
+   * a RangeError instead of allocating the frame. Default: 64 MiB.
+   */
+  maxFrameLength?: number;
+}
+
+/** End of the frame starting at `offset`, or -1 if it is incomplete */
+function frameEnd(buffer: Buffer, offset: number): number {
+  if (buffer.length - offset < FRAME_HEADER_SIZE) return -1;
+  const end = offset + FRAME_HEADER_SIZE + buffer.readUInt32LE(offset);
+  return end <= buffer.length ? end : -1;
+}
+
+export class BatchDecoder {
+  /** Header of a frame split across chunks, while incomplete */
+  private readonly header = Buffer.alloc(FRAME_HEADER_SIZE);
+  private headerFilled = 0;
+
+  /** Message of a frame split across chunks, while incomplete */
+  private frame: Buffer | undefined;
+  private frameFilled = 0;
+
+  private readonly maxFrameLength: number;
+  private readonly options: DecodeOptions;
+
+  /** @param options - `maxFrameLength`, and options passed to `decode()` by `decode()` */
+  constructor(options: BatchDecoderOptions = {}) {
+    const { maxFrameLength = DEFAULT_MAX_FRAME_LENGTH, ...decodeOptions } = options;
+    if (!Number.isInteger(maxFrameLength) || maxFrameLength < 0) {
+      throw new TypeError('maxFrameLength must be a non-negative integer');
+    }
+    this.maxFrameLength = maxFrameLength;
+    this.options = decodeOptions;
+  }
+
+  /** Yields every frame of a complete batch as a slice of `batch` */
+  static *frames(batch: Buffer): Generator<Buffer> {
+    let offset = 0;
+    while (offset < batch.length) {
+      const end = frameEnd(batch, offset);
+      if (end < 0) throw new RangeError('Truncated frame in batch');
+      yield batch.subarray(offset + FRAME_HEADER_SIZE, end);
+      offset = end;
+    }
+  }
+
+  /** Decodes every frame of a complete batch */
+  static decodeAll<T = unknown>(batch: Buffer, options?: DecodeOptions): T[] {
+    const values: T[] = [];
+    for (const frame of BatchDecoder.frames(batch)) {
+      values.push(decode<T>(frame, options));
+    }
+    return values;
+  }
+
+  /** Yields the frames of a stream of chunks, such as a socket or file stream */
+  static async *stream(source: AsyncIterable<Buffer>, options?: BatchDecoderOptions): AsyncGenerator<Buffer> {
+    const decoder = new BatchDecoder(options);
+    for await (const chunk of source) {
+      yield* decoder.push(chunk);
+    }
+    decoder.end();
+  }
+
+  /** Returns a frame length read from the stream, if it is allowed */
+  private checkFrameLength(length: number): number {
+    if (length > this.maxFrameLength) {
+      this.headerFilled = 0;
+      this.frame = undefined;
+      throw new RangeError(`Frame of ${length} bytes exceeds maxFrameLength (${this.maxFrameLength})`);
+    }
+    return length;
+  }
+
+  /**
+   * Adds the next chunk of a stream and returns the frames it completes. A
+   * frame that runs past the end of the chunk is completed by later chunks.
+   * Throws a RangeError for a frame longer than `maxFrameLength`.
+   */
+  push(chunk: Buffer): Buffer[] {
+    const frames: Buffer[] = [];
+    let offset = 0;
+
+    // Finish a frame that started in an earlier chunk:
+    if (this.headerFilled > 0) {
+      offset = chunk.copy(this.header, this.headerFilled, 0, FRAME_HEADER_SIZE - this.headerFilled);
+      this.headerFilled += offset;
+      if (this.headerFilled < FRAME_HEADER_SIZE) return frames;
+      this.headerFilled = 0;
+      this.frame = Buffer.allocUnsafe(this.checkFrameLength(this.header.readUInt32LE(0)));
+      this.frameFilled = 0;
+    }
+    if (this.frame) {
+      const copied = chunk.copy(this.frame, this.frameFilled, offset);
+      this.frameFilled += copied;
+      offset += copied;
+      if (this.frameFilled < this.frame.length) return frames;
+      frames.push(this.frame);
+      this.frame = undefined;
+    }
+
+    while (offset < chunk.length) {
+      const end = frameEnd(chunk, offset);
+      if (end >= 0) {
+        this.checkFrameLength(end - offset - FRAME_HEADER_SIZE);
+        frames.push(chunk.subarray(offset + FRAME_HEADER_SIZE, end));
+        offset = end;
+        continue;
+      }
+
+      // The rest of the chunk starts a frame; keep a copy until it completes:
+      if (chunk.length - offset < FRAME_HEADER_SIZE) {
+        this.headerFilled = chunk.copy(this.header, 0, offset);
+      } else {
+        this.frame = Buffer.allocUnsafe(this.checkFrameLength(chunk.readUInt32LE(offset)));
+        this.frameFilled = chunk.copy(this.frame, 0, offset + FRAME_HEADER_SIZE);
+      }
+      break;
+    }
+    return frames;
+  }
+
+  /** `push()`, decoding each completed frame with the decoder's options */
+  decode<T = unknown>(chunk: Buffer): T[] {
+    return this.push(chunk).map((frame) => decode<T>(frame, this.options));
+  }
+
+  /** Bytes held for a frame that is not complete yet */
+  get pending(): number {
+    return this.frame ? FRAME_HEADER_SIZE + this.frameFilled : this.headerFilled;
+  }
+
+  /** Ends the stream; throws if it stopped in the middle of a frame */
+  end(): void {
+    const pending = this.pending;
+    this.headerFilled = 0;
+    this.frame = undefined;
+    if (pending > 0) throw new RangeError('Stream ended in the middle of a frame');
+  }
+}
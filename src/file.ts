@@ -0,0 +1,26 @@
+/**
+ * Lite3File - Lazy access to lite3 documents on disk
+ *
+ * Opens a file with `mapFile()` and reads it through a Lite3Buffer proxy, so
+ * opening costs the same for a 1 KB or a 10 GB file and only the pages a
+ * lookup touches are read from disk. Use `Lite3Buffer.getBuffer()` on the
+ * proxy to reach the mapped Buffer for `getPath()` or the proxy functions.
+ */
+
+import { mapFile } from './index';
+import { Lite3Buffer } from './proxy';
+
+export const Lite3File = {
+  /**
+   * Map the lite3 file at `path` and open a lazy proxy over it
+   *
+   * @example
+   * ```ts
+   * const snapshot = Lite3File.open<Snapshot>('snapshot.lite3');
+   * snapshot.users[42].name;  // reads only the pages on the way to this field
+   * ```
+   */
+  open<T = unknown>(path: string): T {
+    return Lite3Buffer.from<T>(mapFile(path));
+  },
+};
@@ -20,10 +20,323 @@ export type Lite3Serializable =
   | string
   | number
   | boolean
+  | bigint
   | null
+  | Lite3NumericArray
+  | Lite3Bytes
   | Lite3Serializable[]
   | { [key: string]: Lite3Serializable };
 
+/**
+ * TypedArrays encoded in bulk as lite3 arrays of numbers (float arrays as
+ * f64, integer arrays as i64).
+ */
+export type Lite3NumericArray =
+  | Int8Array
+  | Int16Array
+  | Uint16Array
+  | Int32Array
+  | Uint32Array
+  | Float32Array
+  | Float64Array
+  | BigInt64Array
+  | BigUint64Array;
+
+/**
+ * Binary values stored as lite3 bytes. Decoded as a view (`Buffer` where the
+ * runtime supports it, otherwise `Uint8Array`) sharing the message's memory.
+ */
+export type Lite3Bytes = Uint8Array | Uint8ClampedArray | DataView | ArrayBuffer;
+
+/** Options accepted by `encode()` */
+export interface EncodeOptions {
+  /**
+   * Hand the encoder's memory to the returned Buffer instead of copying it.
+   * Small or heavily over-allocated results are still copied. Default: `true`.
+   */
+  zeroCopy?: boolean;
+
+  /**
+   * Store integral numbers within `Number.MAX_SAFE_INTEGER` as lite3 i64
+   * instead of f64. `-0` stays f64. BigInts are always stored as i64.
+   * Default: `false`.
+   */
+  integers?: boolean;
+}
+
+/** Options accepted by `set()`, `arrAppend()` and the cursor edit methods */
+export interface EditOptions extends Pick<EncodeOptions, 'integers'> {
+  /**
+   * Allow editing a message in a `SharedArrayBuffer` in place, where other
+   * threads may be reading it without synchronization. Default: `false`,
+   * which makes such edits throw.
+   */
+  shared?: boolean;
+}
+
+/** Options accepted by `decode()` */
+export interface DecodeOptions {
+  /**
+   * Return arrays whose elements are all f64 as `Float64Array`, and arrays
+   * whose elements are all i64 as `BigInt64Array`. Default: `false`.
+   */
+  typedArrays?: boolean;
+
+  /**
+   * Return bytes values as independent `Buffer` copies instead of views into
+   * the decoded buffer. Default: `false`. Bytes decoded from a
+   * SharedArrayBuffer are always copies.
+   */
+  copyBytes?: boolean;
+
+  /**
+   * Decode only the object or array at this offset, as returned by the proxy
+   * functions (e.g. `getEntry()`). Default: `0`, the root.
+   */
+  offset?: number;
+
+  /** Decode only these properties of the object being decoded */
+  pick?: readonly string[];
+
+  /** Decode every property of the object being decoded except these */
+  omit?: readonly string[];
+}
+
+/** Options accepted by `encodeAsync()` */
+export interface EncodeAsyncOptions extends Pick<EncodeOptions, 'zeroCopy'> {
+  /**
+   * JSON text shorter than this many bytes is converted on the calling thread
+   * instead of the threadpool. Default: `65536`.
+   */
+  asyncThreshold?: number;
+}
+
+/** Options accepted by `decodeAsync()` */
+export interface DecodeAsyncOptions extends DecodeOptions {
+  /**
+   * Messages smaller than this many bytes are decoded on the calling thread
+   * instead of the threadpool. Default: `65536`.
+   */
+  asyncThreshold?: number;
+}
+
+/** Options accepted by `fromJSON()` and `fromJSONAsync()` */
+export interface FromJSONOptions extends EncodeAsyncOptions {}
+
+/** Options accepted by `toJSON()` and `toJSONAsync()` */
+export interface ToJSONOptions {
+  /** Convert only the object or array at this offset. Default: `0`, the root. */
+  offset?: number;
+
+  /** Return the JSON as a Buffer of UTF-8 bytes instead of a string. Default: `false`. */
+  asBuffer?: boolean;
+
+  /** Messages smaller than this many bytes are converted on the calling thread (`toJSONAsync()` only). Default: `65536`. */
+  asyncThreshold?: number;
+}
+
+/** Options accepted by the `Encoder` constructor */
+export interface EncoderOptions extends Pick<EncodeOptions, 'integers'> {
+  /** Bytes to allocate for the encoder's context up front. Default: `4096`. */
+  initialCapacity?: number;
+}
+
+/**
+ * Reusable encoder that keeps its lite3 context between messages, so encoding
+ * similarly sized messages does no buffer growth once warmed up.
+ */
+export interface Encoder {
+  /** Encodes an object or array into a new Buffer, reusing the encoder's context */
+  encode<T extends Lite3Serializable>(data: T): Buffer;
+
+  /** Forgets the learned capacity hint and shrinks back to the initial capacity */
+  reset(): void;
+
+  /** Bytes currently allocated by the encoder's context */
+  readonly capacity: number;
+
+  /** Message size the encoder expects, learned from previous messages */
+  readonly capacityHint: number;
+}
+
+export interface EncoderConstructor {
+  new (options?: EncoderOptions): Encoder;
+}
+
+/** Options accepted by the `BatchEncoder` constructor */
+export interface BatchEncoderOptions extends Pick<EncodeOptions, 'integers'> {
+  /** Bytes to allocate for each batch up front. Default: `65536`. */
+  initialCapacity?: number;
+}
+
+/**
+ * Encodes many messages into one Buffer, each framed by its length as a u32
+ * little-endian. Read batches back with `BatchDecoder`.
+ */
+export interface BatchEncoder {
+  /** Encodes an object or array as the next frame; returns the number of frames in the batch */
+  add<T extends Lite3Serializable>(data: T): number;
+
+  /** Returns the batch as one Buffer and starts a new batch */
+  finish(): Buffer;
+
+  /** Discards the frames added since the last `finish()` */
+  reset(): void;
+
+  /** Frames added since the last `finish()` */
+  readonly count: number;
+
+  /** Bytes the next `finish()` will return, frame headers included */
+  readonly length: number;
+}
+
+export interface BatchEncoderConstructor {
+  new (options?: BatchEncoderOptions): BatchEncoder;
+}
+
+/** Type names a schema field can declare */
+export type SchemaTypeName = 'string' | 'number' | 'integer' | 'bigint' | 'boolean' | 'bytes' | 'any';
+
+/** Declared type of a field: a type name, a nested shape, or `[elementType]` for arrays */
+export type SchemaType = SchemaTypeName | SchemaShape | [SchemaType];
+
+/** Fields of a record and the type each holds */
+export interface SchemaShape {
+  [key: string]: SchemaType;
+}
+
+/**
+ * Encoder and decoder specialized for one record shape, from `compileSchema()`.
+ * Values that don't match their declared type are stored as `encode()` would
+ * store them, so nothing is lost; they only miss the fast path.
+ */
+export interface Schema<T extends object = Record<string, unknown>> {
+  /** Encodes the shape's fields of `value`; other properties are left out */
+  encode(value: T): Buffer;
+
+  /** Decodes the shape's fields, in shape order; fields missing from the message are left out */
+  decode(buffer: Uint8Array): T;
+
+  /** Top-level field names, in shape order */
+  readonly keys: string[];
+}
+
+/** Value read through a Cursor: nested objects and arrays are Cursors */
+export type Lite3CursorValue = string | number | bigint | boolean | null | Uint8Array | Cursor;
+
+/**
+ * Native handle on one object or array inside a Lite3 Buffer. All cursors
+ * into the same Buffer share a document that hands out at most one live
+ * cursor per nested node.
+ */
+export interface Cursor {
+  /** Reads a property; `undefined` if absent */
+  get(key: string): Lite3CursorValue | undefined;
+
+  /** Reads an array element; `undefined` if out of range */
+  at(index: number): Lite3CursorValue | undefined;
+
+  /** Returns true if the object has the given key */
+  has(key: string): boolean;
+
+  /** Property names of an object cursor (empty for arrays) */
+  keys(): string[];
+
+  /** All elements (or property values) in one native call */
+  values(): Lite3CursorValue[];
+
+  /**
+   * Writes a property of an object cursor in place (see `set()`). Every
+   * cursor into the document then reads from the Buffer this returns.
+   */
+  set(key: string, value: Lite3Serializable, options?: EditOptions): Buffer;
+
+  /** Appends an element to an array cursor in place (see `arrAppend()`) */
+  append(value: Lite3Serializable, options?: EditOptions): Buffer;
+
+  readonly type: 'object' | 'array';
+
+  /** Number of elements or properties */
+  readonly length: number;
+
+  /** Position of the node in the Buffer, as used by the proxy functions */
+  readonly offset: number;
+
+  readonly buffer: Buffer;
+
+  /** Counters for the document this cursor belongs to */
+  readonly stats: CursorStats;
+}
+
+export interface CursorConstructor {
+  /**
+   * Creates a cursor at the root of a Lite3 Buffer or Uint8Array (which may
+   * view a SharedArrayBuffer), or at the object or array at `offset` in it
+   */
+  new (buffer: Uint8Array, offset?: number): Cursor;
+}
+
+/** Memory and cache counters for the cursors sharing one Buffer */
+export interface CursorStats {
+  /** Live cursors */
+  cursors: number;
+  /** Cursors registered in the document's offset table */
+  cachedCursors: number;
+  /** Child lookups that reused a live cursor */
+  hits: number;
+  /** Child lookups that created a cursor */
+  misses: number;
+  /** Native memory held for the lazy view, excluding the Buffer itself */
+  nativeBytes: number;
+}
+
+/** A path parsed once by `compilePath()` for reuse across messages */
+export interface Lite3Path {
+  /** The source path string */
+  readonly path: string;
+}
+
+/** Counters for the native key-name interning cache */
+export interface KeyCacheStats {
+  /** Keys served from the cache */
+  hits: number;
+  /** Keys that had to be created (and were then cached) */
+  misses: number;
+  /** Cached keys replaced by a colliding key */
+  evictions: number;
+  /** Slots currently in use */
+  entries: number;
+  /** Maximum number of cached keys */
+  capacity: number;
+}
+
+/** Calls and cumulative time of one instrumented phase */
+export interface PhaseStats {
+  calls: number;
+  /** Nanoseconds spent in the phase */
+  ns: number;
+}
+
+/** Instrumentation counters returned by `stats()` */
+export interface Lite3Stats {
+  /** Whether counters are being collected (see `setStatsEnabled()`) */
+  enabled: boolean;
+  /** Encode walks, by every encoding function; `bytesOut` is message bytes written */
+  encode: PhaseStats & { bytesOut: number };
+  /** Decodes run on the JS thread; `bytesIn` is message bytes read */
+  decode: PhaseStats & { bytesIn: number };
+  /** Reads by the proxy functions and Lite3Buffer proxies */
+  proxy: PhaseStats;
+  /** lite3 contexts created */
+  contexts: number;
+  /** Encode contexts, BatchEncoder arenas and edited messages that had to grow */
+  reallocs: number;
+  /** Encoded messages copied out of the encoder's memory instead of handed to the Buffer */
+  copies: number;
+  /** JS values created by decode and proxy reads, keys excluded */
+  napiValues: number;
+}
+
 /** Type strings returned by getType/getArrayType/getRootType */
 export type Lite3TypeString =
   | 'object'
@@ -35,6 +348,27 @@ export type Lite3TypeString =
   | 'bytes'
   | 'undefined';
 
+/** Descriptor returned by getEntry/getArrayEntry for nested structures */
+export interface Lite3ChildEntry {
+  type: 'object' | 'array';
+  /** Offset of the nested structure, for further proxy calls */
+  offset: number;
+}
+
+/**
+ * Result of getEntry/getArrayEntry: a primitive value, a bytes view, a
+ * descriptor for a nested structure, or `undefined` if absent.
+ */
+export type Lite3Entry =
+  | string
+  | number
+  | bigint
+  | boolean
+  | null
+  | Uint8Array
+  | Lite3ChildEntry
+  | undefined;
+
 /**
  * lite3 native addon interface.
  */
@@ -45,58 +379,281 @@ export interface Lite3Addon {
   /**
    * Encodes a JavaScript object or array into a lite3 binary buffer.
    * @param data - The object or array to encode
+   * @param options - Encoding options
    * @returns A Buffer containing the lite3 binary representation
    */
-  encode<T extends Lite3Serializable>(data: T): Buffer;
+  encode<T extends Lite3Serializable>(data: T, options?: EncodeOptions): Buffer;
+
+  /**
+   * Encodes a JavaScript object or array directly into existing memory.
+   * @param data - The object or array to encode
+   * @param target - Memory to write into
+   * @param offset - Byte offset into `target` to start writing at (default: 0)
+   * @param options - Encoding options (`integers`, as for `encode()`)
+   * @returns The number of bytes written, or `-n` if the message needs `n`
+   *   bytes and did not fit (the target past `offset` is then unspecified)
+   * @throws TypeError if a getter on `data` detached or shrank `target`. The
+   *   walk writes into `target` while getters run, so writes may already have
+   *   reached memory it no longer owns; don't let getters touch the target.
+   */
+  encodeInto<T extends Lite3Serializable>(
+    data: T,
+    target: ArrayBufferView | ArrayBuffer,
+    offset?: number,
+    options?: Pick<EncodeOptions, 'integers'>
+  ): number;
+
+  /**
+   * Writes `value` under `key` in the object at `offset`, replacing any
+   * existing value, without re-encoding the rest of the message. `buffer` is
+   * modified in place. When the message grows, the result is a new Buffer
+   * (with spare capacity for further edits); continue with it, as earlier
+   * Buffers returned by edits may no longer hold a valid message.
+   * @param offset - Offset of the object: `0` for the root, or as returned by
+   *   the proxy functions
+   * @returns `buffer` if the message kept its length, otherwise the edited message
+   */
+  set<T extends Lite3Serializable>(
+    buffer: Buffer,
+    offset: number,
+    key: string,
+    value: T,
+    options?: EditOptions
+  ): Buffer;
+
+  /** Appends `value` to the array at `offset`. Returns a Buffer as `set()` does. */
+  arrAppend<T extends Lite3Serializable>(
+    buffer: Buffer,
+    offset: number,
+    value: T,
+    options?: EditOptions
+  ): Buffer;
+
+  /**
+   * Returns the number of heap allocations encode walks have made since the
+   * addon was loaded. Encoding typical records makes none; only strings too
+   * long for the encoder's inline scratch space allocate.
+   */
+  getEncodeAllocations(): number;
+
+  /**
+   * Returns counters for the key-name cache used when decoding object keys.
+   * Counters are per thread (main thread or worker).
+   */
+  getKeyCacheStats(): KeyCacheStats;
+
+  /**
+   * Returns the instrumentation counters collected since the last
+   * `resetStats()`. Counters are per thread and only collected after
+   * `setStatsEnabled(true)`.
+   */
+  stats(): Lite3Stats;
+
+  /** Zeroes the instrumentation counters */
+  resetStats(): void;
+
+  /**
+   * Starts or stops collecting instrumentation counters. While disabled
+   * (the default) they cost a branch per call and the clock is never read.
+   */
+  setStatsEnabled(enabled: boolean): void;
 
   /**
    * Decodes a lite3 binary buffer back into a JavaScript value.
-   * @param buffer - The Buffer to decode
+   * @param buffer - The Buffer to decode; any Uint8Array, including one over a SharedArrayBuffer
+   * @param options - Decoding options
    * @returns The decoded JavaScript object or array
    */
-  decode<T = unknown>(buffer: Buffer): T;
+  decode<T = unknown>(buffer: Uint8Array, options?: DecodeOptions): T;
+
+  /**
+   * Encodes on the libuv threadpool. The value is serialized with
+   * `JSON.stringify` on the calling thread (or pass JSON text directly) and
+   * converted to lite3 off-thread, so only JSON types are supported and
+   * integral numbers are stored as i64. Values JSON would change (binary
+   * data, BigInts, `undefined`, NaN, objects with a `toJSON()` method) and
+   * cyclic values reject the Promise with a TypeError, as do other invalid
+   * arguments. Use `encode()` for them.
+   * @param data - The object or array to encode, or JSON text
+   * @param options - Encoding options
+   * @returns A Promise for a Buffer containing the lite3 binary representation
+   */
+  encodeAsync<T extends Lite3Serializable>(data: T | string, options?: EncodeAsyncOptions): Promise<Buffer>;
+
+  /**
+   * Decodes on the libuv threadpool: the message is converted to JSON
+   * off-thread, after verifying it there unless `verify()` has accepted the
+   * buffer, and materialized with `JSON.parse`. The result is the same as
+   * `decode()`'s; messages JSON can't represent exactly (bytes, integers
+   * beyond `Number.MAX_SAFE_INTEGER`, NaN) and the `typedArrays`, `pick` and
+   * `omit` options are decoded on the calling thread. Do not modify the
+   * buffer until the Promise settles.
+   * @param buffer - The Buffer to decode
+   * @param options - Decoding options
+   * @returns A Promise for the decoded JavaScript object or array
+   */
+  decodeAsync<T = unknown>(buffer: Uint8Array, options?: DecodeAsyncOptions): Promise<T>;
+
+  /**
+   * Converts JSON text straight to a lite3 Buffer in native code, without
+   * creating JS objects. Integral numbers are stored as i64.
+   * @param json - JSON text, as a string or a Buffer of UTF-8 bytes
+   */
+  fromJSON(json: string | Buffer, options?: Pick<FromJSONOptions, 'zeroCopy'>): Buffer;
+
+  /** `fromJSON()` on the libuv threadpool. Do not modify a Buffer of JSON until the Promise settles. */
+  fromJSONAsync(json: string | Buffer, options?: FromJSONOptions): Promise<Buffer>;
+
+  /**
+   * Converts a lite3 Buffer straight to JSON text in native code, without
+   * creating JS objects. Bytes values are written as base64 strings. Throws
+   * if the message holds values JSON can't represent (NaN, Infinity).
+   */
+  toJSON(buffer: Uint8Array, options: ToJSONOptions & { asBuffer: true }): Buffer;
+  toJSON(buffer: Uint8Array, options?: ToJSONOptions): string;
+
+  /** `toJSON()` on the libuv threadpool. Do not modify the buffer until the Promise settles. */
+  toJSONAsync(buffer: Uint8Array, options: ToJSONOptions & { asBuffer: true }): Promise<Buffer>;
+  toJSONAsync(buffer: Uint8Array, options?: ToJSONOptions): Promise<string>;
+
+  /**
+   * Checks the whole structure of a Lite3 Buffer once: bounds, types, key
+   * termination and nesting. Returns false for a malformed buffer. A Buffer
+   * that passes is marked as verified, and proxies, cursors and the proxy
+   * functions then skip their per-value bounds checks for it, so only verify
+   * a Buffer after its last write. A Buffer over a SharedArrayBuffer or a
+   * mapped file is checked but never marked.
+   */
+  verify(buffer: Uint8Array): boolean;
+
+  /** Returns true if `verify()` has accepted this Buffer */
+  isVerified(buffer: Uint8Array): boolean;
+
+  /** Reusable encoder class */
+  Encoder: EncoderConstructor;
+
+  /** Length-prefixed batch encoder class */
+  BatchEncoder: BatchEncoderConstructor;
+
+  /** Native cursor class backing Lite3Buffer proxies */
+  Cursor: CursorConstructor;
+
+  /**
+   * Parses a path such as `"a.b[3].c"` once, for reuse with `getPath()` and
+   * `project()`. Keys containing `.` or `[` can be quoted: `'a["x.y"]'`.
+   */
+  compilePath(path: string): Lite3Path;
+
+  /**
+   * Compiles a record shape into a specialized encoder and decoder. Fields
+   * are read by precreated key strings with the getter for their declared
+   * type, the lite3 context is sized from previous messages, and decoded
+   * objects always have the same key order (and so one hidden class).
+   *
+   * `integer` fields store integral numbers as i64; `number` fields as f64.
+   *
+   * @example
+   * const user = compileSchema({ id: 'integer', name: 'string', tags: ['string'] });
+   * const buf = user.encode({ id: 1, name: 'Ada', tags: ['admin'] });
+   * user.decode(buf); // { id: 1, name: 'Ada', tags: ['admin'] }
+   */
+  compileSchema<T extends object = Record<string, unknown>>(
+    shape: SchemaShape,
+    options?: Pick<EncodeOptions, 'integers'>
+  ): Schema<T>;
+
+  /**
+   * Maps the lite3 file at `path` into memory and returns a Buffer over it,
+   * for the proxy functions, `getPath()`, `decode()` and `Lite3Buffer.from()`.
+   * Nothing is read up front: pages are loaded as lookups touch them, and are
+   * shared with other processes mapping the same file. The file is never
+   * written; writes to the Buffer stay private to this process. The mapping
+   * is released when the Buffer is garbage collected.
+   */
+  mapFile(path: string): Buffer;
+
+  /**
+   * Returns the decoded value at `path`, or `undefined` if it does not exist.
+   * Only the value at the path is decoded.
+   */
+  getPath<T = unknown>(buffer: Uint8Array, path: string | Lite3Path): T | undefined;
+
+  /** Resolves many paths in one call; `undefined` where a path does not exist */
+  project(buffer: Uint8Array, paths: ReadonlyArray<string | Lite3Path>): unknown[];
 
   // Proxy support functions for lazy access:
 
   /** Returns the type of a property at the given offset and key */
-  getType(buffer: Buffer, offset: number, key: string): Lite3TypeString;
+  getType(buffer: Uint8Array, offset: number, key: string): Lite3TypeString;
 
   /** Returns the type of an array element at the given offset and index */
-  getArrayType(buffer: Buffer, offset: number, index: number): Lite3TypeString;
+  getArrayType(buffer: Uint8Array, offset: number, index: number): Lite3TypeString;
 
   /** Returns the value of a property (primitives) or child offset (objects/arrays) */
-  getValue(buffer: Buffer, offset: number, key: string): unknown;
+  getValue(buffer: Uint8Array, offset: number, key: string): unknown;
 
   /** Returns the value of an array element or child offset for nested structures */
-  getArrayElement(buffer: Buffer, offset: number, index: number): unknown;
+  getArrayElement(buffer: Uint8Array, offset: number, index: number): unknown;
+
+  /** Looks up a property once: its value, or a descriptor for a nested structure */
+  getEntry(buffer: Uint8Array, offset: number, key: string): Lite3Entry;
+
+  /** Looks up an array element once: its value, or a descriptor for a nested structure */
+  getArrayEntry(buffer: Uint8Array, offset: number, index: number): Lite3Entry;
 
   /** Returns the offset of a nested object or array */
-  getChildOffset(buffer: Buffer, offset: number, key: string): number;
+  getChildOffset(buffer: Uint8Array, offset: number, key: string): number;
 
   /** Returns the offset of a nested object or array within an array */
-  getArrayChildOffset(buffer: Buffer, offset: number, index: number): number;
+  getArrayChildOffset(buffer: Uint8Array, offset: number, index: number): number;
 
   /** Returns an array of keys for the object at the given offset */
-  getKeys(buffer: Buffer, offset: number): string[];
+  getKeys(buffer: Uint8Array, offset: number): string[];
 
   /** Returns the length of an array or object at the given offset */
-  getLength(buffer: Buffer, offset: number): number;
+  getLength(buffer: Uint8Array, offset: number): number;
 
   /** Returns true if the object has the given key */
-  hasKey(buffer: Buffer, offset: number, key: string): boolean;
+  hasKey(buffer: Uint8Array, offset: number, key: string): boolean;
 
   /** Returns the type of the root element */
-  getRootType(buffer: Buffer): Lite3TypeString;
+  getRootType(buffer: Uint8Array): Lite3TypeString;
 }
 
 export const {
   lite3Version,
   encode,
+  encodeInto,
+  set,
+  arrAppend,
+  getEncodeAllocations,
+  getKeyCacheStats,
+  stats,
+  resetStats,
+  setStatsEnabled,
   decode,
+  encodeAsync,
+  decodeAsync,
+  fromJSON,
+  fromJSONAsync,
+  toJSON,
+  toJSONAsync,
+  verify,
+  isVerified,
+  Encoder,
+  BatchEncoder,
+  Cursor,
+  compilePath,
+  compileSchema,
+  mapFile,
+  getPath,
+  project,
   getType,
   getArrayType,
   getValue,
   getArrayElement,
+  getEntry,
+  getArrayEntry,
   getChildOffset,
   getArrayChildOffset,
   getKeys,
@@ -108,4 +665,10 @@ export const {
 export default addon as Lite3Addon;
 
 // Re-export proxy API
-export { Lite3Buffer, $buffer, $decode, $isLite3Buffer } from './proxy';
\ No newline at end of file
+export { Lite3Buffer, $buffer, $decode, $isLite3Buffer, $cursor, type Lite3Transferable } from './proxy';
+
+// Re-export batch framing API
+export { BatchDecoder, FRAME_HEADER_SIZE, DEFAULT_MAX_FRAME_LENGTH, type BatchDecoderOptions } from './batch';
+
+// Re-export memory-mapped file API
+export { Lite3File } from './file';
@@ -3,23 +3,27 @@
  *
  * Provides transparent access to Lite3-encoded data without eager decoding.
  * Access properties/elements on-demand; nested structures return new proxies.
+ *
+ * Each proxy is a thin shell around a native Cursor (see addon_cursor.c). The
+ * proxy handlers are shared by every proxy, and the cursors into one Buffer
+ * share a single native document that hands out one cursor per nested node,
+ * so a lazy view holds no per-node closures or JS caches.
+ *
+ * Assigning a property (or pushing onto an array) writes into the Buffer in
+ * place through the cursor. Read the Buffer back with `$buffer` afterwards:
+ * when the message grows it moves to a new Buffer.
+ *
+ * A proxy can't be posted to a worker, but its message can: toTransferable()
+ * describes it as a SharedArrayBuffer range, and fromTransferable() reopens a
+ * lazy view over that same memory on the other side.
  */
 
 import {
   encode,
   decode,
-  getRootType,
-  getType,
-  getArrayType,
-  getValue,
-  getArrayElement,
-  getChildOffset,
-  getArrayChildOffset,
-  getKeys,
-  getLength,
-  hasKey,
+  Cursor,
+  type Lite3CursorValue,
   type Lite3Serializable,
-  type Lite3TypeString,
 } from './index';
 
 /** Symbol for accessing the underlying buffer */
@@ -31,319 +35,236 @@ export const $decode = Symbol.for('lite3.decode');
 /** Symbol to check if value is a Lite3Buffer proxy */
 export const $isLite3Buffer = Symbol.for('lite3.isLite3Buffer');
 
-type ProxyCache = Map<string | number, unknown>;
+/** Symbol for accessing the native Cursor behind a proxy */
+export const $cursor = Symbol.for('lite3.cursor');
+
+/** Array length, stored on array proxy targets so reads stay in JS */
+const $length = Symbol('lite3.length');
+
+interface ProxyTarget {
+  [$cursor]: Cursor;
+  [$length]?: number;
+}
 
-interface Lite3ProxyState {
-  buffer: Buffer;
+/**
+ * A Lite3Buffer's message as plain data `postMessage()` can send to a worker
+ * without copying: the memory is shared, not cloned.
+ */
+export interface Lite3Transferable {
+  buffer: SharedArrayBuffer;
+  byteOffset: number;
+  byteLength: number;
+  /** Position of the proxied object or array in the message */
   offset: number;
-  isArray: boolean;
-  cache: ProxyCache;
 }
 
-function createObjectProxy<T extends object>(state: Lite3ProxyState): T {
-  const { buffer, offset, cache } = state;
-
-  return new Proxy({} as T, {
-    get(_target, prop: string | symbol): unknown {
-      // Handle symbols
-      if (prop === $buffer) return buffer;
-      if (prop === $isLite3Buffer) return true;
-      if (prop === $decode) {
-        return () => decode(buffer);
-      }
-
-      // Handle special properties
-      if (typeof prop === 'symbol') return undefined;
-
-      // Check cache first (for identity consistency)
-      if (cache.has(prop)) {
-        return cache.get(prop);
-      }
-
-      // Get type and value
-      const type = getType(buffer, offset, prop);
-
-      if (type === 'undefined') {
-        return undefined;
-      }
-
-      let result: unknown;
-
-      if (type === 'object') {
-        const childOffset = getChildOffset(buffer, offset, prop);
-        result = createObjectProxy({
-          buffer,
-          offset: childOffset,
-          isArray: false,
-          cache: new Map(),
-        });
-      } else if (type === 'array') {
-        const childOffset = getChildOffset(buffer, offset, prop);
-        result = createArrayProxy({
-          buffer,
-          offset: childOffset,
-          isArray: true,
-          cache: new Map(),
-        });
-      } else {
-        // Primitive value
-        result = getValue(buffer, offset, prop);
-      }
-
-      // Cache for identity consistency
-      cache.set(prop, result);
-      return result;
-    },
-
-    has(_target, prop: string | symbol): boolean {
-      if (typeof prop === 'symbol') {
-        return prop === $buffer || prop === $decode || prop === $isLite3Buffer;
-      }
-      return hasKey(buffer, offset, prop);
-    },
-
-    ownKeys(): string[] {
-      return getKeys(buffer, offset);
-    },
-
-    getOwnPropertyDescriptor(_target, prop: string | symbol) {
-      if (typeof prop === 'symbol') return undefined;
-      if (!hasKey(buffer, offset, prop)) return undefined;
-      return {
-        enumerable: true,
-        configurable: true,
-        writable: false,
-      };
-    },
-  });
+/** One proxy per live cursor, so repeated access yields the same object */
+const proxies = new WeakMap<Cursor, object>();
+
+function toProxy(cursor: Cursor): object {
+  let proxy = proxies.get(cursor);
+  if (!proxy) {
+    proxy =
+      cursor.type === 'array'
+        ? new Proxy(Object.assign([], { [$cursor]: cursor, [$length]: cursor.length }), arrayHandler)
+        : new Proxy({ [$cursor]: cursor }, objectHandler);
+    proxies.set(cursor, proxy);
+  }
+  return proxy;
 }
 
-function createArrayProxy<T extends unknown[]>(state: Lite3ProxyState): T {
-  const { buffer, offset, cache } = state;
-  const length = getLength(buffer, offset);
-
-  return new Proxy([] as unknown as T, {
-    get(_target, prop: string | symbol): unknown {
-      // Handle symbols
-      if (prop === $buffer) return buffer;
-      if (prop === $isLite3Buffer) return true;
-      if (prop === $decode) {
-        return () => decode(buffer);
-      }
-
-      // Handle array length
-      if (prop === 'length') return length;
-
-      // Handle symbol.iterator for for...of loops
-      if (prop === Symbol.iterator) {
-        return function* () {
-          for (let i = 0; i < length; i++) {
-            yield getElementAt(i);
-          }
-        };
-      }
-
-      // Handle numeric indices
-      if (typeof prop === 'string') {
-        const index = Number(prop);
-        if (!Number.isNaN(index) && Number.isInteger(index) && index >= 0 && index < length) {
-          return getElementAt(index);
-        }
-      }
-
-      // Handle array methods that should work
-      if (prop === 'map') {
-        return (fn: (value: unknown, index: number) => unknown) => {
-          const result = [];
-          for (let i = 0; i < length; i++) {
-            result.push(fn(getElementAt(i), i));
-          }
-          return result;
-        };
-      }
-
-      if (prop === 'forEach') {
-        return (fn: (value: unknown, index: number) => void) => {
-          for (let i = 0; i < length; i++) {
-            fn(getElementAt(i), i);
-          }
-        };
-      }
-
-      if (prop === 'filter') {
-        return (fn: (value: unknown, index: number) => boolean) => {
-          const result = [];
-          for (let i = 0; i < length; i++) {
-            const val = getElementAt(i);
-            if (fn(val, i)) result.push(val);
-          }
-          return result;
-        };
-      }
-
-      if (prop === 'find') {
-        return (fn: (value: unknown, index: number) => boolean) => {
-          for (let i = 0; i < length; i++) {
-            const val = getElementAt(i);
-            if (fn(val, i)) return val;
-          }
-          return undefined;
-        };
-      }
-
-      if (prop === 'findIndex') {
-        return (fn: (value: unknown, index: number) => boolean) => {
-          for (let i = 0; i < length; i++) {
-            if (fn(getElementAt(i), i)) return i;
-          }
-          return -1;
-        };
-      }
-
-      if (prop === 'some') {
-        return (fn: (value: unknown, index: number) => boolean) => {
-          for (let i = 0; i < length; i++) {
-            if (fn(getElementAt(i), i)) return true;
-          }
-          return false;
-        };
-      }
-
-      if (prop === 'every') {
-        return (fn: (value: unknown, index: number) => boolean) => {
-          for (let i = 0; i < length; i++) {
-            if (!fn(getElementAt(i), i)) return false;
-          }
-          return true;
-        };
-      }
-
-      if (prop === 'reduce') {
-        return (fn: (acc: unknown, value: unknown, index: number) => unknown, initial?: unknown) => {
-          let acc = initial;
-          let startIndex = 0;
-          if (acc === undefined && length > 0) {
-            acc = getElementAt(0);
-            startIndex = 1;
-          }
-          for (let i = startIndex; i < length; i++) {
-            acc = fn(acc, getElementAt(i), i);
-          }
-          return acc;
-        };
-      }
-
-      if (prop === 'includes') {
-        return (searchElement: unknown) => {
-          for (let i = 0; i < length; i++) {
-            if (getElementAt(i) === searchElement) return true;
-          }
-          return false;
-        };
-      }
-
-      if (prop === 'indexOf') {
-        return (searchElement: unknown) => {
-          for (let i = 0; i < length; i++) {
-            if (getElementAt(i) === searchElement) return i;
-          }
-          return -1;
-        };
-      }
-
-      if (prop === 'at') {
-        return (index: number) => {
-          if (index < 0) index = length + index;
-          if (index < 0 || index >= length) return undefined;
-          return getElementAt(index);
-        };
-      }
-
-      if (prop === 'slice') {
-        return (start?: number, end?: number) => {
-          const result = [];
-          const s = start ?? 0;
-          const e = end ?? length;
-          const actualStart = s < 0 ? Math.max(length + s, 0) : Math.min(s, length);
-          const actualEnd = e < 0 ? Math.max(length + e, 0) : Math.min(e, length);
-          for (let i = actualStart; i < actualEnd; i++) {
-            result.push(getElementAt(i));
-          }
-          return result;
-        };
-      }
-
-      if (typeof prop === 'symbol') return undefined;
-      return undefined;
-
-      function getElementAt(index: number): unknown {
-        // Check cache
-        if (cache.has(index)) {
-          return cache.get(index);
-        }
-
-        const type = getArrayType(buffer, offset, index);
-        let result: unknown;
-
-        if (type === 'object') {
-          const childOffset = getArrayChildOffset(buffer, offset, index);
-          result = createObjectProxy({
-            buffer,
-            offset: childOffset,
-            isArray: false,
-            cache: new Map(),
-          });
-        } else if (type === 'array') {
-          const childOffset = getArrayChildOffset(buffer, offset, index);
-          result = createArrayProxy({
-            buffer,
-            offset: childOffset,
-            isArray: true,
-            cache: new Map(),
-          });
-        } else {
-          result = getArrayElement(buffer, offset, index);
-        }
-
-        cache.set(index, result);
-        return result;
-      }
-    },
-
-    has(_target, prop: string | symbol): boolean {
-      if (typeof prop === 'symbol') {
-        return prop === $buffer || prop === $decode || prop === $isLite3Buffer;
-      }
-      if (prop === 'length') return true;
-      const index = Number(prop);
-      return !Number.isNaN(index) && Number.isInteger(index) && index >= 0 && index < length;
-    },
-
-    ownKeys(): string[] {
-      // Return numeric indices as strings
-      const keys: string[] = [];
-      for (let i = 0; i < length; i++) {
-        keys.push(String(i));
-      }
-      return keys;
-    },
-
-    getOwnPropertyDescriptor(_target, prop: string | symbol) {
-      if (prop === 'length') {
-        return { value: length, writable: false, enumerable: false, configurable: false };
-      }
-      if (typeof prop === 'symbol') return undefined;
-      const index = Number(prop);
-      if (Number.isNaN(index) || !Number.isInteger(index) || index < 0 || index >= length) {
-        return undefined;
-      }
-      return {
-        enumerable: true,
-        configurable: true,
-        writable: false,
+/** Turn a value read through a cursor into what the proxy exposes */
+function toValue(value: Lite3CursorValue | undefined): unknown {
+  return value instanceof Cursor ? toProxy(value) : value;
+}
+
+/** All elements of an array cursor, read in one native call */
+function elements(cursor: Cursor): unknown[] {
+  return cursor.values().map(toValue);
+}
+
+function getSymbol(cursor: Cursor, prop: symbol): unknown {
+  if (prop === $buffer) return cursor.buffer;
+  if (prop === $cursor) return cursor;
+  if (prop === $isLite3Buffer) return true;
+  if (prop === $decode) {
+    return () => decode(cursor.buffer);
+  }
+  return undefined;
+}
+
+function hasSymbol(prop: symbol): boolean {
+  return prop === $buffer || prop === $decode || prop === $isLite3Buffer || prop === $cursor;
+}
+
+const objectHandler: ProxyHandler<ProxyTarget> = {
+  get(target, prop: string | symbol): unknown {
+    const cursor = target[$cursor];
+    if (typeof prop === 'symbol') return getSymbol(cursor, prop);
+    return toValue(cursor.get(prop));
+  },
+
+  has(target, prop: string | symbol): boolean {
+    if (typeof prop === 'symbol') return hasSymbol(prop);
+    return target[$cursor].has(prop);
+  },
+
+  ownKeys(target): string[] {
+    return target[$cursor].keys();
+  },
+
+  set(target, prop: string | symbol, value: unknown): boolean {
+    if (typeof prop === 'symbol') return false;
+    target[$cursor].set(prop, value as Lite3Serializable);
+    return true;
+  },
+
+  getOwnPropertyDescriptor(target, prop: string | symbol) {
+    if (typeof prop === 'symbol') return undefined;
+    if (!target[$cursor].has(prop)) return undefined;
+    return {
+      enumerable: true,
+      configurable: true,
+      writable: true,
+    };
+  },
+};
+
+type Callback<R> = (value: unknown, index: number) => R;
+
+/** Array methods supported on array proxies, each bound to a cursor */
+const arrayMethods: Record<string, (cursor: Cursor, length: number) => unknown> = {
+  map: (cursor) => (fn: Callback<unknown>) => elements(cursor).map((v, i) => fn(v, i)),
+
+  forEach: (cursor) => (fn: Callback<void>) => {
+    elements(cursor).forEach((v, i) => fn(v, i));
+  },
+
+  filter: (cursor) => (fn: Callback<boolean>) => elements(cursor).filter((v, i) => fn(v, i)),
+
+  find: (cursor) => (fn: Callback<boolean>) => elements(cursor).find((v, i) => fn(v, i)),
+
+  findIndex: (cursor) => (fn: Callback<boolean>) => elements(cursor).findIndex((v, i) => fn(v, i)),
+
+  some: (cursor) => (fn: Callback<boolean>) => elements(cursor).some((v, i) => fn(v, i)),
+
+  every: (cursor) => (fn: Callback<boolean>) => elements(cursor).every((v, i) => fn(v, i)),
+
+  reduce: (cursor) => (fn: (acc: unknown, value: unknown, index: number) => unknown, initial?: unknown) => {
+    const values = elements(cursor);
+    let acc = initial;
+    let startIndex = 0;
+    if (acc === undefined && values.length > 0) {
+      acc = values[0];
+      startIndex = 1;
+    }
+    for (let i = startIndex; i < values.length; i++) {
+      acc = fn(acc, values[i], i);
+    }
+    return acc;
+  },
+
+  includes: (cursor) => (searchElement: unknown) => elements(cursor).indexOf(searchElement) !== -1,
+
+  indexOf: (cursor) => (searchElement: unknown) => elements(cursor).indexOf(searchElement),
+
+  at: (cursor, length) => (index: number) => {
+    if (index < 0) index = length + index;
+    if (index < 0 || index >= length) return undefined;
+    return toValue(cursor.at(index));
+  },
+
+  slice: (cursor) => (start?: number, end?: number) => elements(cursor).slice(start, end),
+};
+
+/** Append values to an array proxy, keeping its cached length current */
+function push(target: ProxyTarget, values: unknown[]): number {
+  const cursor = target[$cursor];
+  for (const value of values) {
+    cursor.append(value as Lite3Serializable);
+  }
+  target[$length] = cursor.length;
+  return cursor.length;
+}
+
+function isIndex(prop: string, length: number): boolean {
+  const index = Number(prop);
+  return !Number.isNaN(index) && Number.isInteger(index) && index >= 0 && index < length;
+}
+
+const arrayHandler: ProxyHandler<ProxyTarget> = {
+  get(target, prop: string | symbol): unknown {
+    const cursor = target[$cursor];
+    const length = target[$length] as number;
+
+    // Handle symbol.iterator for for...of loops
+    if (prop === Symbol.iterator) {
+      return function* () {
+        yield* elements(cursor);
       };
-    },
-  });
+    }
+    if (typeof prop === 'symbol') return getSymbol(cursor, prop);
+
+    // Handle array length
+    if (prop === 'length') return length;
+
+    // Handle numeric indices
+    if (isIndex(prop, length)) {
+      return toValue(cursor.at(Number(prop)));
+    }
+
+    if (prop === 'push') return (...values: unknown[]) => push(target, values);
+
+    // Handle array methods that should work
+    const method = arrayMethods[prop];
+    return method ? method(cursor, length) : undefined;
+  },
+
+  has(target, prop: string | symbol): boolean {
+    if (typeof prop === 'symbol') return hasSymbol(prop);
+    if (prop === 'length') return true;
+    return isIndex(prop, target[$length] as number);
+  },
+
+  set(target, prop: string | symbol, value: unknown): boolean {
+    // lite3 arrays grow only at the end:
+    if (prop !== String(target[$length])) {
+      throw new TypeError('Lite3 arrays can only be appended to');
+    }
+    push(target, [value]);
+    return true;
+  },
+
+  ownKeys(target): string[] {
+    // Return numeric indices as strings
+    const keys: string[] = [];
+    for (let i = 0; i < (target[$length] as number); i++) {
+      keys.push(String(i));
+    }
+    return keys;
+  },
+
+  getOwnPropertyDescriptor(target, prop: string | symbol) {
+    const length = target[$length] as number;
+    if (prop === 'length') {
+      return { value: length, writable: false, enumerable: false, configurable: false };
+    }
+    if (typeof prop === 'symbol') return undefined;
+    if (!isIndex(prop, length)) return undefined;
+    return {
+      enumerable: true,
+      configurable: true,
+      writable: false,
+    };
+  },
+};
+
+/** A Buffer over an existing message, or undefined if `data` is not one */
+function asMessage(data: unknown): Buffer | undefined {
+  if (Buffer.isBuffer(data)) return data;
+  if (data instanceof Uint8Array) return Buffer.from(data.buffer, data.byteOffset, data.byteLength);
+  if (data instanceof SharedArrayBuffer || data instanceof ArrayBuffer) return Buffer.from(data);
+  return undefined;
 }
 
 /**
@@ -351,7 +272,9 @@ function createArrayProxy<T extends unknown[]>(state: Lite3ProxyState): T {
  */
 export const Lite3Buffer = {
   /**
-   * Create a lazy proxy from a POJO or existing Buffer
+   * Create a lazy proxy from a POJO or an existing message: a Buffer, any
+   * other Uint8Array, or a whole SharedArrayBuffer or ArrayBuffer. Messages
+   * are read in place, never copied.
    *
    * Returns `unknown` by default for type safety. Provide a type parameter
    * when you trust the data source matches your expected type.
@@ -368,22 +291,53 @@ export const Lite3Buffer = {
    * const data = Lite3Buffer.from<MyType>(buffer);
    * ```
    */
-  from<T = unknown>(data: Lite3Serializable | Buffer): T {
-    const buffer = Buffer.isBuffer(data) ? data : encode(data);
-    const rootType = getRootType(buffer);
-
-    const state: Lite3ProxyState = {
-      buffer,
-      offset: 0,
-      isArray: rootType === 'array',
-      cache: new Map(),
-    };
+  from<T = unknown>(data: Lite3Serializable | Uint8Array | SharedArrayBuffer): T {
+    const buffer = asMessage(data) ?? encode(data as Lite3Serializable);
+    return toProxy(new Cursor(buffer)) as T;
+  },
+
+  /**
+   * Describe a proxy's message for `postMessage()`. A message already in a
+   * SharedArrayBuffer is described in place; any other is copied into a new
+   * SharedArrayBuffer once. To share without any copy, encode into shared
+   * memory in the first place with `encodeInto()`.
+   *
+   * The memory is shared, not snapshotted: edits through any view of it are
+   * seen by every other view, with no synchronization.
+   *
+   * @example
+   * ```ts
+   * worker.postMessage(Lite3Buffer.toTransferable(proxy));
+   * // In the worker:
+   * const data = Lite3Buffer.fromTransferable<MyType>(message);
+   * ```
+   */
+  toTransferable(proxy: unknown): Lite3Transferable {
+    const cursor = Lite3Buffer.getCursor(proxy);
+    if (!cursor) throw new TypeError('Argument must be a Lite3Buffer proxy');
 
-    if (rootType === 'array') {
-      return createArrayProxy(state) as T;
-    } else {
-      return createObjectProxy(state) as T;
+    const message = cursor.buffer;
+    if (message.buffer instanceof SharedArrayBuffer) {
+      return {
+        buffer: message.buffer,
+        byteOffset: message.byteOffset,
+        byteLength: message.byteLength,
+        offset: cursor.offset,
+      };
     }
+
+    const buffer = new SharedArrayBuffer(message.byteLength);
+    new Uint8Array(buffer).set(message);
+    return { buffer, byteOffset: 0, byteLength: message.byteLength, offset: cursor.offset };
+  },
+
+  /**
+   * Reopen a lazy proxy over a message described by `toTransferable()`,
+   * typically in another thread. Nothing is copied or decoded.
+   */
+  fromTransferable<T = unknown>(transferable: Lite3Transferable): T {
+    const { buffer, byteOffset, byteLength, offset } = transferable;
+    return toProxy(new Cursor(Buffer.from(buffer, byteOffset, byteLength), offset)) as T;
   },
 
   /**
@@ -404,4 +358,12 @@ export const Lite3Buffer = {
     if (!Lite3Buffer.isLite3Buffer(proxy)) return undefined;
     return (proxy as Record<symbol, Buffer>)[$buffer];
   },
-};
\ No newline at end of file
+
+  /**
+   * Get the native cursor behind a proxy, e.g. to read `cursor.stats`
+   */
+  getCursor(proxy: unknown): Cursor | undefined {
+    if (!Lite3Buffer.isLite3Buffer(proxy)) return undefined;
+    return (proxy as Record<symbol, Cursor>)[$cursor];
+  },
+};
@@ -0,0 +1,109 @@
+import { describe, it, expect } from 'vitest';
+import { encode, decode, encodeAsync, decodeAsync, getEntry } from '../src/index';
+
+const data = {
+  name: 'test',
+  count: 42,
+  ratio: 0.5,
+  flags: [true, false, null],
+  nested: { items: [{ id: 1 }, { id: 2 }], label: 'ünïcödé' },
+};
+
+describe('encodeAsync', () => {
+  it('encodes on the threadpool', async () => {
+    const buf = await encodeAsync(data, { asyncThreshold: 0 });
+    expect(decode(buf)).toEqual(data);
+  });
+
+  it('encodes small values on the calling thread', async () => {
+    const buf = await encodeAsync(data);
+    expect(decode(buf)).toEqual(data);
+  });
+
+  it('accepts JSON text', async () => {
+    const buf = await encodeAsync(JSON.stringify(data), { asyncThreshold: 0 });
+    expect(decode(buf)).toEqual(data);
+  });
+
+  it('encodes large payloads', async () => {
+    const rows = Array.from({ length: 5000 }, (_, i) => ({ id: i, name: `row ${i}`, score: i / 7 }));
+    const buf = await encodeAsync({ rows });
+    expect(decode(buf)).toEqual({ rows });
+  });
+
+  it('rejects invalid JSON and non-container roots', async () => {
+    await expect(encodeAsync('{"a":', { asyncThreshold: 0 })).rejects.toThrow();
+    await expect(encodeAsync('42')).rejects.toThrow();
+  });
+
+  it('rejects values JSON would not round-trip', async () => {
+    await expect(encodeAsync({ big: 1n })).rejects.toThrow(TypeError);
+    await expect(encodeAsync({ blob: Buffer.from([1, 2]) })).rejects.toThrow('binary data');
+    await expect(encodeAsync({ xs: new Float64Array([1]) })).rejects.toThrow(TypeError);
+    await expect(encodeAsync({ a: [1, undefined] })).rejects.toThrow(TypeError);
+    await expect(encodeAsync({ n: NaN })).rejects.toThrow(TypeError);
+    await expect(encodeAsync({ when: new Date(0) })).rejects.toThrow('toJSON');
+  });
+
+  it('rejects cyclic values without walking every path', async () => {
+    const a: Record<string, unknown> = {};
+    a.x = a;
+    a.y = a;
+    await expect(encodeAsync(a)).rejects.toThrow(TypeError);
+  });
+
+  it('reports invalid arguments through the promise', async () => {
+    await expect(encodeAsync(42 as never)).rejects.toThrow(TypeError);
+    await expect(encodeAsync(data, { zeroCopy: 'yes' as never })).rejects.toThrow(TypeError);
+  });
+});
+
+describe('decodeAsync', () => {
+  it('decodes on the threadpool with the same result as decode()', async () => {
+    const buf = encode(data);
+    expect(await decodeAsync(buf, { asyncThreshold: 0 })).toEqual(decode(buf));
+  });
+
+  it('decodes large payloads', async () => {
+    const rows = Array.from({ length: 5000 }, (_, i) => ({ id: i, name: `row ${i}`, score: i / 7 }));
+    const buf = encode({ rows });
+    expect(buf.length).toBeGreaterThan(64 * 1024);
+    expect(await decodeAsync(buf)).toEqual({ rows });
+  });
+
+  it('decodes a subtree at an offset', async () => {
+    const buf = encode({ a: { b: [1, 2, 3] }, c: 'x' });
+    const { offset } = getEntry(buf, 0, 'a') as { offset: number };
+    expect(await decodeAsync(buf, { offset, asyncThreshold: 0 })).toEqual({ b: [1, 2, 3] });
+  });
+
+  it('falls back to decode() for values JSON cannot represent', async () => {
+    const buf = encode({ blob: Buffer.from([1, 2, 3]), big: 2n ** 60n, nan: NaN });
+    const decoded = await decodeAsync<{ blob: Uint8Array; big: bigint; nan: number }>(buf, { asyncThreshold: 0 });
+    expect(Array.from(decoded.blob)).toEqual([1, 2, 3]);
+    expect(decoded.big).toBe(2n ** 60n);
+    expect(decoded.nan).toBeNaN();
+  });
+
+  it('honours decode() options', async () => {
+    const buf = encode({ id: 1, xs: new Float64Array([1.5, 2.5]) });
+    expect(await decodeAsync(buf, { pick: ['id'], asyncThreshold: 0 })).toEqual({ id: 1 });
+    const decoded = await decodeAsync<{ xs: Float64Array }>(buf, { typedArrays: true, asyncThreshold: 0 });
+    expect(decoded.xs).toBeInstanceOf(Float64Array);
+  });
+
+  it('rejects invalid options', async () => {
+    const buf = encode(data);
+    await expect(decodeAsync(buf, { offset: buf.length, asyncThreshold: 0 })).rejects.toThrow(RangeError);
+  });
+
+  it('verifies messages off-thread and rejects malformed ones', async () => {
+    const buf = encode({ text: 'x'.repeat(200), n: 1 });
+    const truncated = Buffer.from(buf.subarray(0, buf.length - 50));
+    await expect(decodeAsync(truncated, { asyncThreshold: 0 })).rejects.toThrow('Malformed Lite3 buffer');
+  });
+
+  it('throws for non-Buffer arguments', () => {
+    expect(() => decodeAsync('nope' as never)).toThrow(TypeError);
+  });
+});
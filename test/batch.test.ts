@@ -0,0 +1,145 @@
+import { describe, it, expect } from 'vitest';
+import { BatchEncoder, BatchDecoder, FRAME_HEADER_SIZE, encode, decode } from '../src/index';
+
+const records = Array.from({ length: 200 }, (_, i) => ({ id: i, name: `record ${i}`, tags: ['a', 'b'].slice(i % 3) }));
+
+function encodeBatch(values: object[], options?: ConstructorParameters<typeof BatchEncoder>[0]): Buffer {
+  const encoder = new BatchEncoder(options);
+  for (const value of values) encoder.add(value);
+  return encoder.finish();
+}
+
+describe('BatchEncoder', () => {
+  it('frames each message with its u32 LE length', () => {
+    const batch = encodeBatch([{ a: 1 }, [2]]);
+    const first = encode({ a: 1 });
+    expect(batch.readUInt32LE(0)).toBe(first.length);
+    expect(batch.subarray(FRAME_HEADER_SIZE, FRAME_HEADER_SIZE + first.length).equals(first)).toBe(true);
+    expect(batch.length).toBe(2 * FRAME_HEADER_SIZE + first.length + encode([2]).length);
+  });
+
+  it('tracks count and length, and starts a new batch after finish()', () => {
+    const encoder = new BatchEncoder();
+    expect(encoder.add({ a: 1 })).toBe(1);
+    expect(encoder.add({ b: 2 })).toBe(2);
+    expect(encoder.count).toBe(2);
+    const length = encoder.length;
+    expect(encoder.finish().length).toBe(length);
+    expect(encoder.count).toBe(0);
+    expect(encoder.length).toBe(0);
+    expect(encoder.finish().length).toBe(0);
+  });
+
+  it('grows past the initial capacity', () => {
+    const big = { blob: 'x'.repeat(100_000) };
+    const batch = encodeBatch([{ small: true }, big, { small: false }], { initialCapacity: 1024 });
+    expect(BatchDecoder.decodeAll(batch)).toEqual([{ small: true }, big, { small: false }]);
+  });
+
+  it('returns independent Buffers for consecutive batches', () => {
+    const encoder = new BatchEncoder();
+    records.forEach((r) => encoder.add(r));
+    const first = encoder.finish();
+    encoder.add({ other: 'batch' });
+    encoder.finish();
+    expect(BatchDecoder.decodeAll(first)).toEqual(records);
+  });
+
+  it('reset() discards pending frames', () => {
+    const encoder = new BatchEncoder();
+    encoder.add({ dropped: true });
+    encoder.reset();
+    encoder.add({ kept: true });
+    expect(BatchDecoder.decodeAll(encoder.finish())).toEqual([{ kept: true }]);
+  });
+
+  it('honours the integers option', () => {
+    const batch = encodeBatch([{ n: 1 }], { integers: true });
+    const [frame] = BatchDecoder.frames(batch);
+    expect(frame.equals(encode({ n: 1 }, { integers: true }))).toBe(true);
+  });
+
+  it('rejects values that cannot be a message root', () => {
+    const encoder = new BatchEncoder();
+    expect(() => encoder.add(42 as never)).toThrow(TypeError);
+    expect(encoder.count).toBe(0);
+  });
+
+  it('refuses to be used from a getter while encoding', () => {
+    const encoder = new BatchEncoder();
+    for (const call of [() => encoder.add({ b: 1 }), () => encoder.finish(), () => encoder.reset()]) {
+      const value = {
+        get a() {
+          call();
+          return 1;
+        },
+      };
+      expect(() => encoder.add(value)).toThrow('while it is encoding');
+    }
+    expect(encoder.count).toBe(0);
+    encoder.add({ a: 1 });
+    expect(BatchDecoder.decodeAll(encoder.finish())).toEqual([{ a: 1 }]);
+  });
+});
+
+describe('BatchDecoder', () => {
+  const batch = encodeBatch(records);
+
+  it('yields zero-copy frames', () => {
+    const frames = [...BatchDecoder.frames(batch)];
+    expect(frames).toHaveLength(records.length);
+    expect(frames[0].buffer).toBe(batch.buffer);
+    expect(frames.map((f) => decode(f))).toEqual(records);
+  });
+
+  it('throws for a truncated batch', () => {
+    expect(() => [...BatchDecoder.frames(batch.subarray(0, batch.length - 1))]).toThrow(RangeError);
+  });
+
+  it('reassembles frames split across chunks', () => {
+    for (const size of [1, 3, 7, 64, 1000]) {
+      const decoder = new BatchDecoder();
+      const decoded: unknown[] = [];
+      for (let offset = 0; offset < batch.length; offset += size) {
+        decoded.push(...decoder.decode(batch.subarray(offset, offset + size)));
+      }
+      expect(decoder.pending).toBe(0);
+      decoder.end();
+      expect(decoded).toEqual(records);
+    }
+  });
+
+  it('end() throws when the stream stops mid-frame', () => {
+    const decoder = new BatchDecoder();
+    decoder.push(batch.subarray(0, 10));
+    expect(decoder.pending).toBe(10);
+    expect(() => decoder.end()).toThrow(RangeError);
+  });
+
+  it('refuses frames longer than maxFrameLength', () => {
+    const hostile = Buffer.alloc(8);
+    hostile.writeUInt32LE(0xffffffff, 0);
+    expect(() => new BatchDecoder().push(hostile)).toThrow(/maxFrameLength/);
+
+    const longest = Math.max(...[...BatchDecoder.frames(batch)].map((f) => f.length));
+    const strict = new BatchDecoder({ maxFrameLength: longest - 1 });
+    expect(() => strict.push(batch)).toThrow(RangeError);
+    expect(strict.pending).toBe(0);
+
+    // Split headers are checked as they complete:
+    const split = new BatchDecoder({ maxFrameLength: 16 });
+    split.push(hostile.subarray(0, 2));
+    expect(() => split.push(hostile.subarray(2))).toThrow(RangeError);
+    expect(new BatchDecoder({ maxFrameLength: longest }).push(batch)).toHaveLength(records.length);
+    expect(() => new BatchDecoder({ maxFrameLength: -1 })).toThrow(TypeError);
+  });
+
+  it('reads frames from an async stream', async () => {
+    async function* chunks() {
+      for (let offset = 0; offset < batch.length; offset += 500) yield batch.subarray(offset, offset + 500);
+    }
+    const decoded: unknown[] = [];
+    for await (const frame of BatchDecoder.stream(chunks())) decoded.push(decode(frame));
+    expect(decoded).toEqual(records);
+  });
+});
@@ -0,0 +1,64 @@
+import { describe, it, expect } from 'vitest';
+import { Cursor, encode, getChildOffset } from '../src/index';
+
+describe('Cursor', () => {
+  const obj = {
+    name: 'doc',
+    nested: { deep: { value: 1.5 } },
+    items: ['a', { b: 2 }, [3]],
+  };
+  const buf = encode(obj);
+
+  it('reads primitives and returns cursors for nested nodes', () => {
+    const root = new Cursor(buf);
+    expect(root.type).toBe('object');
+    expect(root.length).toBe(3);
+    expect(root.get('name')).toBe('doc');
+    expect(root.get('missing')).toBeUndefined();
+
+    const nested = root.get('nested') as Cursor;
+    expect(nested).toBeInstanceOf(Cursor);
+    expect(nested.offset).toBe(getChildOffset(buf, 0, 'nested'));
+    expect((nested.get('deep') as Cursor).get('value')).toBe(1.5);
+  });
+
+  it('reads array elements individually and in bulk', () => {
+    const items = new Cursor(buf).get('items') as Cursor;
+    expect(items.type).toBe('array');
+    expect(items.length).toBe(3);
+    expect(items.at(0)).toBe('a');
+    expect(items.at(3)).toBeUndefined();
+
+    const values = items.values();
+    expect(values[0]).toBe('a');
+    expect((values[1] as Cursor).get('b')).toBe(2);
+    expect((values[2] as Cursor).at(0)).toBe(3);
+  });
+
+  it('lists keys and checks membership', () => {
+    const root = new Cursor(buf);
+    expect(root.keys().sort()).toEqual(['items', 'name', 'nested']);
+    expect(root.has('items')).toBe(true);
+    expect(root.has('missing')).toBe(false);
+  });
+
+  it('hands out one live cursor per node and counts reuse', () => {
+    const root = new Cursor(buf);
+    const first = root.get('nested');
+    const second = root.get('nested');
+    expect(first).toBe(second);
+    expect(root.buffer).toBe(buf);
+
+    const stats = root.stats;
+    expect(stats.misses).toBe(1);
+    expect(stats.hits).toBe(1);
+    expect(stats.cursors).toBeGreaterThanOrEqual(2);
+    expect(stats.cachedCursors).toBe(stats.cursors);
+    expect(stats.nativeBytes).toBeGreaterThan(0);
+  });
+
+  it('rejects buffers that do not hold an object or array', () => {
+    expect(() => new Cursor(Buffer.alloc(0))).toThrow(TypeError);
+    expect(() => new Cursor('x' as unknown as Buffer)).toThrow(TypeError);
+  });
+});
@@ -1,5 +1,19 @@
 import { describe, it, expect } from 'vitest';
-import { encode, decode, version, lite3Version } from '../src/index';
+import {
+  encode,
+  encodeInto,
+  decode,
+  Encoder,
+  getEncodeAllocations,
+  stats,
+  resetStats,
+  setStatsEnabled,
+  getKeyCacheStats,
+  getEntry,
+  verify,
+  version,
+  lite3Version,
+} from '../src/index';
 
 describe('version', () => {
   it('returns a semver-like version string', () => {
@@ -97,6 +111,20 @@ describe('encode/decode roundtrip', () => {
     expect(decode(encode(obj))).toEqual(obj);
   });
 
+  it('handles objects of every width around the batching threshold', () => {
+    for (const width of [31, 32, 33, 64, 500]) {
+      const obj = Object.fromEntries(Array.from({ length: width }, (_, i) => [`k${i}`, { v: i }]));
+      expect(decode(encode(obj))).toEqual(obj);
+    }
+  });
+
+  it('creates arrays at their final length', () => {
+    const obj = { arr: Array.from({ length: 1000 }, (_, i) => i) };
+    const decoded = decode<typeof obj>(encode(obj));
+    expect(decoded.arr.length).toBe(1000);
+    expect(decoded).toEqual(obj);
+  });
+
   it('handles mixed-type arrays with nested objects', () => {
     const obj = {
       arr: [5, { a: 1 }, 'string', null],
@@ -150,4 +178,354 @@ describe('root-level arrays', () => {
     const arr = ['🎉', '中文', 'hello 世界'];
     expect(decode(encode(arr))).toEqual(arr);
   });
-});
\ No newline at end of file
+});
+
+describe('large payloads', () => {
+  const big = {
+    items: Array.from({ length: 2000 }, (_, i) => ({ id: i, name: `item-${i}`, tags: ['a', 'b'] })),
+  };
+
+  it('roundtrips without copying the encoded buffer', () => {
+    resetStats();
+    setStatsEnabled(true);
+    try {
+      const buf = encode(big);
+      expect(buf.length).toBeGreaterThan(4096);
+      expect(stats().copies).toBe(0);
+      expect(decode(buf)).toEqual(big);
+
+      encode(big, { zeroCopy: false });
+      expect(stats().copies).toBe(1);
+    } finally {
+      setStatsEnabled(false);
+      resetStats();
+    }
+  });
+
+  it('produces identical bytes with zeroCopy disabled', () => {
+    expect(encode(big, { zeroCopy: false }).equals(encode(big))).toBe(true);
+  });
+
+  it('rejects non-boolean zeroCopy', () => {
+    expect(() => encode(big, { zeroCopy: 'yes' as unknown as boolean })).toThrow(TypeError);
+  });
+});
+
+describe('encodeInto', () => {
+  const obj = { id: 7, name: 'frame', tags: ['x', 'y'], nested: { ok: true } };
+
+  it('writes the same bytes as encode() at the given offset', () => {
+    const expected = encode(obj);
+    const target = Buffer.alloc(expected.length + 64);
+    const written = encodeInto(obj, target, 16);
+    expect(written).toBe(expected.length);
+    expect(target.subarray(16, 16 + written).equals(expected)).toBe(true);
+    expect(decode(target.subarray(16, 16 + written))).toEqual(obj);
+  });
+
+  it('accepts ArrayBuffer targets', () => {
+    const target = new ArrayBuffer(4096);
+    const written = encodeInto(obj, target);
+    expect(decode(Buffer.from(target, 0, written))).toEqual(obj);
+  });
+
+  it('encodes root arrays', () => {
+    const target = Buffer.alloc(4096);
+    const written = encodeInto([1, 'two'], target);
+    expect(decode(target.subarray(0, written))).toEqual([1, 'two']);
+  });
+
+  it('returns the negated required size when the target is too small', () => {
+    const needed = encode(obj).length;
+    const result = encodeInto(obj, Buffer.alloc(8));
+    expect(result).toBe(-needed);
+
+    const target = Buffer.alloc(-result);
+    expect(encodeInto(obj, target)).toBe(needed);
+  });
+
+  it('rejects offsets outside the target', () => {
+    expect(() => encodeInto(obj, Buffer.alloc(16), 17)).toThrow(RangeError);
+  });
+
+  it('throws when a getter detaches the target', () => {
+    // ArrayBuffer.prototype.transfer() is newer than the ES2022 lib:
+    const target = new ArrayBuffer(4096) as ArrayBuffer & { transfer(): ArrayBuffer };
+    let moved: ArrayBuffer | undefined;  // keeps the memory written to alive
+    const value = {
+      id: 1,
+      get name() {
+        moved = target.transfer();
+        return 'frame';
+      },
+    };
+    expect(() => encodeInto(value, target)).toThrow('detached or resized');
+    expect(moved?.byteLength).toBe(4096);
+  });
+});
+
+describe('encode allocations', () => {
+  it('makes no heap allocations for typical records', () => {
+    const record = Object.fromEntries(
+      Array.from({ length: 1000 }, (_, i) => [`field_${i}`, `value ${i} 🎉`])
+    );
+    const before = getEncodeAllocations();
+    const buf = encode(record);
+    expect(getEncodeAllocations()).toBe(before);
+    expect(decode(buf)).toEqual(record);
+  });
+
+  it('allocates only for outlier strings', () => {
+    const long = 'x'.repeat(10_000);
+    const before = getEncodeAllocations();
+    const buf = encode({ a: long, b: long, c: 'short' });
+    expect(getEncodeAllocations() - before).toBe(1);
+    expect(decode(buf)).toEqual({ a: long, b: long, c: 'short' });
+  });
+
+  it('handles multi-byte characters at the scratch boundary', () => {
+    for (let n = 500; n < 520; n++) {
+      const obj = { s: 'a'.repeat(n) + '🎉' + 'b' };
+      expect(decode(encode(obj))).toEqual(obj);
+    }
+  });
+});
+
+describe('key cache', () => {
+  it('serves repeated keys from the cache', () => {
+    const buf = encode({ alpha: 1, beta: 2, gamma: { alpha: 3 } });
+    decode(buf);
+    const before = getKeyCacheStats();
+    expect(decode(buf)).toEqual({ alpha: 1, beta: 2, gamma: { alpha: 3 } });
+    const after = getKeyCacheStats();
+    expect(before.entries).toBeGreaterThan(0);
+    expect(after.hits).toBeGreaterThan(0);
+    expect(after.hits - before.hits).toBe(4);
+    expect(after.misses).toBe(before.misses);
+  });
+
+  it('stays within its capacity', () => {
+    const obj = Object.fromEntries(Array.from({ length: 5000 }, (_, i) => [`k${i}`, i]));
+    expect(decode(encode(obj))).toEqual(obj);
+    const stats = getKeyCacheStats();
+    expect(stats.entries).toBeLessThanOrEqual(stats.capacity);
+  });
+
+  it('decodes long keys that bypass the cache', () => {
+    const obj = { ['k'.repeat(200)]: 'long', short: 'x' };
+    expect(decode(encode(obj))).toEqual(obj);
+  });
+});
+
+describe('typed arrays', () => {
+  it('encodes float typed arrays as numbers', () => {
+    const obj = { f64: new Float64Array([1.5, -2.25, 1e300]), f32: new Float32Array([0.5, 2]) };
+    expect(decode(encode(obj))).toEqual({ f64: [1.5, -2.25, 1e300], f32: [0.5, 2] });
+  });
+
+  it('encodes integer typed arrays as numbers', () => {
+    const obj = {
+      i8: new Int8Array([-1, 2]),
+      u16: new Uint16Array([65535]),
+      i32: new Int32Array([-2147483648, 7]),
+      u32: new Uint32Array([4294967295]),
+    };
+    expect(decode(encode(obj))).toEqual({ i8: [-1, 2], u16: [65535], i32: [-2147483648, 7], u32: [4294967295] });
+  });
+
+  it('encodes typed arrays at the root and inside arrays', () => {
+    expect(decode(encode(new Float64Array([1, 2, 3])))).toEqual([1, 2, 3]);
+    expect(decode(encode([new Int32Array([4, 5])]))).toEqual([[4, 5]]);
+  });
+
+  it('rejects BigUint64Array values above the signed range', () => {
+    expect(() => encode({ v: new BigUint64Array([2n ** 64n - 1n]) })).toThrow(RangeError);
+  });
+
+  it('decodes homogeneous f64 arrays as Float64Array on request', () => {
+    const values = Array.from({ length: 10_000 }, (_, i) => i * 0.5);
+    const decoded = decode<{ values: Float64Array }>(encode({ values }), { typedArrays: true });
+    expect(decoded.values).toBeInstanceOf(Float64Array);
+    expect(Array.from(decoded.values)).toEqual(values);
+  });
+
+  it('decodes homogeneous i64 arrays as BigInt64Array on request', () => {
+    const decoded = decode<{ v: BigInt64Array }>(encode({ v: new Int32Array([1, -2, 3]) }), { typedArrays: true });
+    expect(decoded.v).toBeInstanceOf(BigInt64Array);
+    expect(Array.from(decoded.v)).toEqual([1n, -2n, 3n]);
+  });
+
+  it('keeps mixed and empty arrays as plain arrays', () => {
+    const obj = { mixed: [1.5, 'two'], empty: [] };
+    expect(decode(encode(obj), { typedArrays: true })).toEqual(obj);
+  });
+});
+
+describe('integers', () => {
+  it('round-trips numbers without the integers option', () => {
+    expect(decode(encode({ id: 42, frac: 0.25 }))).toEqual({ id: 42, frac: 0.25 });
+  });
+
+  it('round-trips integral numbers with the integers option', () => {
+    const obj = { id: 42, neg: -7, max: Number.MAX_SAFE_INTEGER, min: Number.MIN_SAFE_INTEGER, frac: 1.5 };
+    expect(decode(encode(obj, { integers: true }))).toEqual(obj);
+  });
+
+  it('stores integral numbers as i64 only with the integers option', () => {
+    // typedArrays exposes the stored type: all-i64 arrays decode as BigInt64Array
+    const ids = [1, 2, Number.MAX_SAFE_INTEGER];
+    const asInt = decode<{ ids: BigInt64Array }>(encode({ ids }, { integers: true }), { typedArrays: true });
+    expect(asInt.ids).toBeInstanceOf(BigInt64Array);
+    expect(Array.from(asInt.ids)).toEqual(ids.map(BigInt));
+
+    const asFloat = decode<{ ids: Float64Array }>(encode({ ids }), { typedArrays: true });
+    expect(asFloat.ids).toBeInstanceOf(Float64Array);
+
+    // Beyond the safe range integral numbers stay f64:
+    const big = decode<{ ids: Float64Array }>(encode({ ids: [2 ** 60] }, { integers: true }), { typedArrays: true });
+    expect(big.ids).toBeInstanceOf(Float64Array);
+  });
+
+  it('keeps -0 as a float', () => {
+    const decoded = decode<{ z: number }>(encode({ z: -0 }, { integers: true }));
+    expect(Object.is(decoded.z, -0)).toBe(true);
+  });
+
+  it('encodes BigInts and decodes out-of-safe-range values as bigint', () => {
+    const decoded = decode<{ small: number; big: bigint; neg: bigint }>(
+      encode({ small: 5n, big: 2n ** 62n, neg: -(2n ** 63n) })
+    );
+    expect(decoded).toEqual({ small: 5, big: 2n ** 62n, neg: -(2n ** 63n) });
+  });
+
+  it('rejects BigInts outside the signed 64-bit range', () => {
+    expect(() => encode({ v: 2n ** 63n })).toThrow(RangeError);
+  });
+
+  it('accepts the integers option in encodeInto and Encoder', () => {
+    const target = Buffer.alloc(256);
+    const written = encodeInto({ n: 3 }, target, undefined, { integers: true });
+    expect(decode(target.subarray(0, written))).toEqual({ n: 3 });
+    expect(decode(new Encoder({ integers: true }).encode({ n: 3 }))).toEqual({ n: 3 });
+  });
+});
+
+describe('bytes', () => {
+  it('round-trips Buffer and Uint8Array values as bytes', () => {
+    const blob = Buffer.from([0, 1, 2, 254, 255]);
+    const decoded = decode<{ blob: Uint8Array; u8: Uint8Array }>(
+      encode({ blob, u8: new Uint8Array([9, 8, 7]) })
+    );
+    expect(decoded.blob).toBeInstanceOf(Uint8Array);
+    expect(Array.from(decoded.blob)).toEqual([0, 1, 2, 254, 255]);
+    expect(Array.from(decoded.u8)).toEqual([9, 8, 7]);
+  });
+
+  it('encodes ArrayBuffer and DataView contents as bytes', () => {
+    const ab = new Uint8Array([1, 2, 3, 4]).buffer;
+    const decoded = decode<{ ab: Uint8Array; dv: Uint8Array }>(
+      encode({ ab, dv: new DataView(ab, 1, 2) })
+    );
+    expect(Array.from(decoded.ab)).toEqual([1, 2, 3, 4]);
+    expect(Array.from(decoded.dv)).toEqual([2, 3]);
+  });
+
+  it('encodes bytes inside arrays', () => {
+    const decoded = decode<Uint8Array[]>(encode([Buffer.from('hi'), Buffer.alloc(0)]));
+    expect(Buffer.from(decoded[0]).toString()).toBe('hi');
+    expect(decoded[1].length).toBe(0);
+  });
+
+  it('decodes bytes as views sharing the message memory', () => {
+    const buf = encode({ blob: Buffer.from([1, 2, 3]) });
+    const decoded = decode<{ blob: Uint8Array }>(buf);
+    expect(decoded.blob.buffer).toBe(buf.buffer);
+    buf.fill(0);
+    expect(Array.from(decoded.blob)).toEqual([0, 0, 0]);
+  });
+
+  it('decodes bytes as independent Buffer copies with copyBytes', () => {
+    const buf = encode({ blob: Buffer.from([1, 2, 3]) });
+    const decoded = decode<{ blob: Buffer }>(buf, { copyBytes: true });
+    expect(Buffer.isBuffer(decoded.blob)).toBe(true);
+    buf.fill(0);
+    expect(Array.from(decoded.blob)).toEqual([1, 2, 3]);
+  });
+
+  it('rejects binary data at the root', () => {
+    expect(() => encode(Buffer.from([1]))).toThrow(TypeError);
+  });
+});
+
+describe('partial decode', () => {
+  const data = {
+    id: 7,
+    meta: { kind: 'order', tags: ['a', 'b'] },
+    payload: { items: [{ sku: 'x', qty: 2 }], raw: 'z'.repeat(1000) },
+  };
+  const buf = encode(data);
+
+  it('decodes a subtree at an offset', () => {
+    const entry = getEntry(buf, 0, 'payload') as { offset: number };
+    expect(decode(buf, { offset: entry.offset })).toEqual(data.payload);
+  });
+
+  it('decodes only picked keys, in pick order', () => {
+    const decoded = decode<Record<string, unknown>>(buf, { pick: ['meta', 'id', 'missing'] });
+    expect(decoded).toEqual({ meta: data.meta, id: 7 });
+    expect(Object.keys(decoded)).toEqual(['meta', 'id']);
+  });
+
+  it('decodes all but omitted keys', () => {
+    expect(decode(buf, { omit: ['payload'] })).toEqual({ id: 7, meta: data.meta });
+  });
+
+  it('combines offset with pick or omit', () => {
+    const entry = getEntry(buf, 0, 'payload') as { offset: number };
+    expect(decode(buf, { offset: entry.offset, omit: ['raw'] })).toEqual({ items: data.payload.items });
+    expect(decode(buf, { offset: entry.offset, pick: ['raw'] })).toEqual({ raw: data.payload.raw });
+  });
+
+  it('rejects invalid combinations', () => {
+    expect(() => decode(buf, { pick: ['id'], omit: ['id'] })).toThrow(TypeError);
+    expect(() => decode(encode([1, 2]), { pick: ['0'] })).toThrow(TypeError);
+    expect(() => decode(buf, { offset: buf.length })).toThrow(RangeError);
+  });
+
+  it('rejects offsets that do not start an object or array', () => {
+    const forged = encode({ a: { b: [1] }, raw: new Uint8Array(256).map((_, i) => i) });
+    const a = (getEntry(forged, 0, 'a') as { offset: number }).offset;
+    const b = (getEntry(forged, a, 'b') as { offset: number }).offset;
+
+    // Every byte value occurs in `raw`, so some offsets inside it carry an
+    // object or array type byte:
+    for (const verified of [false, true]) {
+      if (verified) expect(verify(forged)).toBe(true);
+      for (let offset = 1; offset < forged.length; offset++) {
+        if (offset === a || offset === b) {
+          expect(() => decode(forged, { offset })).not.toThrow();
+        } else if (verified) {
+          expect(() => decode(forged, { offset })).toThrow(TypeError);
+        } else {
+          // Unverified reads are all bounds-checked, so a forged node that
+          // parses yields garbage at worst
+          try {
+            decode(forged, { offset });
+          } catch (err) {
+            expect(err).toBeInstanceOf(Error);
+          }
+        }
+      }
+    }
+  });
+});
+
+describe('malformed input', () => {
+  it('throws on truncated messages instead of reading past the end', () => {
+    const buf = encode({ text: 'x'.repeat(200), n: 1, list: [1.5, 2.5, 3.5] });
+    for (const cut of [3, 50, 150]) {
+      const truncated = Buffer.from(buf.subarray(0, buf.length - cut));
+      expect(() => decode(truncated)).toThrow('Malformed Lite3 buffer');
+    }
+  });
+});
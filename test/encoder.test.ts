@@ -0,0 +1,71 @@
+import { describe, it, expect } from 'vitest';
+import { Encoder, encode, decode } from '../src/index';
+
+describe('Encoder', () => {
+  it('encodes the same bytes as encode()', () => {
+    const encoder = new Encoder();
+    const obj = { name: 'Alice', tags: ['a', 'b'], nested: { n: 1.5 } };
+    expect(encoder.encode(obj).equals(encode(obj))).toBe(true);
+  });
+
+  it('can be reused for many messages', () => {
+    const encoder = new Encoder();
+    for (let i = 0; i < 100; i++) {
+      const obj = { id: i, label: `msg-${i}`, items: [i, i + 1] };
+      expect(decode(encoder.encode(obj))).toEqual(obj);
+    }
+  });
+
+  it('returns buffers that are independent of later messages', () => {
+    const encoder = new Encoder();
+    const first = encoder.encode({ value: 'first' });
+    encoder.encode({ value: 'second' });
+    expect(decode(first)).toEqual({ value: 'first' });
+  });
+
+  it('encodes root arrays', () => {
+    const encoder = new Encoder();
+    expect(decode(encoder.encode([1, 'two', null]))).toEqual([1, 'two', null]);
+  });
+
+  it('honours initialCapacity', () => {
+    const encoder = new Encoder({ initialCapacity: 64 * 1024 });
+    expect(encoder.capacity).toBe(64 * 1024);
+  });
+
+  it('does not grow once warmed up on similar messages', () => {
+    const encoder = new Encoder({ initialCapacity: 1024 });
+    const make = (i: number) => ({ rows: Array.from({ length: 200 }, (_, j) => ({ i, j, s: 'xxxxxxxx' })) });
+    encoder.encode(make(0));
+    const warmed = encoder.capacity;
+    for (let i = 1; i < 20; i++) encoder.encode(make(i));
+    expect(encoder.capacity).toBe(warmed);
+    expect(encoder.capacityHint).toBeGreaterThan(0);
+  });
+
+  it('reset() forgets the hint and shrinks to the initial capacity', () => {
+    const encoder = new Encoder({ initialCapacity: 2048 });
+    encoder.encode({ big: 'x'.repeat(100_000) });
+    encoder.reset();
+    expect(encoder.capacityHint).toBe(0);
+    expect(encoder.capacity).toBe(2048);
+  });
+
+  it('rejects non-object values', () => {
+    const encoder = new Encoder();
+    expect(() => encoder.encode('nope' as unknown as object)).toThrow(TypeError);
+  });
+
+  it('refuses to be used from a getter while encoding', () => {
+    const encoder = new Encoder();
+    const value = {
+      get a() {
+        encoder.reset();
+        return 1;
+      },
+    };
+    expect(() => encoder.encode(value)).toThrow('while it is encoding');
+    expect(() => encoder.encode({ get a() { return encoder.encode({ b: 1 }); } })).toThrow('while it is encoding');
+    expect(decode(encoder.encode({ a: 1 }))).toEqual({ a: 1 });
+  });
+});
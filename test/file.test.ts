@@ -0,0 +1,62 @@
+import { describe, it, expect, beforeAll, afterAll } from 'vitest';
+import { mkdtempSync, readFileSync, rmSync, writeFileSync } from 'node:fs';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+import { encode, decode, getPath, verify, isVerified, mapFile, Lite3File, Lite3Buffer } from '../src/index';
+
+const snapshot = {
+  version: 3,
+  users: Array.from({ length: 1000 }, (_, i) => ({ id: i, name: `user ${i}`, tags: ['a', 'b'] })),
+};
+
+describe('mapFile', () => {
+  let dir: string;
+  let path: string;
+
+  beforeAll(() => {
+    dir = mkdtempSync(join(tmpdir(), 'lite3-file-'));
+    path = join(dir, 'snapshot.lite3');
+    writeFileSync(path, encode(snapshot));
+  });
+
+  afterAll(() => {
+    rmSync(dir, { recursive: true, force: true });
+  });
+
+  it('returns a Buffer over the file contents', () => {
+    const buffer = mapFile(path);
+    expect(Buffer.isBuffer(buffer)).toBe(true);
+    expect(buffer.equals(readFileSync(path))).toBe(true);
+    expect(verify(buffer)).toBe(true);
+    expect(isVerified(buffer)).toBe(false);  // the file can still change under it
+    expect(isVerified(buffer.subarray(0))).toBe(false);
+    expect(decode(buffer)).toEqual(snapshot);
+  });
+
+  it('reads through getPath and lazy proxies', () => {
+    expect(getPath(mapFile(path), 'users[500].name')).toBe('user 500');
+
+    const proxy = Lite3File.open<typeof snapshot>(path);
+    expect(proxy.version).toBe(3);
+    expect(proxy.users[999].tags).toEqual(['a', 'b']);
+    expect(Buffer.isBuffer(Lite3Buffer.getBuffer(proxy))).toBe(true);
+  });
+
+  it('keeps writes private to the process', () => {
+    const before = readFileSync(path);
+    const buffer = mapFile(path);
+    buffer[buffer.length - 1] ^= 0xff;
+    expect(readFileSync(path).equals(before)).toBe(true);
+    expect(mapFile(path).equals(before)).toBe(true);
+  });
+
+  it('reports file errors like fs', () => {
+    expect(() => mapFile(join(dir, 'missing.lite3'))).toThrow(expect.objectContaining({ code: 'ENOENT' }));
+    expect(() => mapFile(dir)).toThrow(expect.objectContaining({ code: 'EISDIR' }));
+
+    const empty = join(dir, 'empty.lite3');
+    writeFileSync(empty, '');
+    expect(() => mapFile(empty)).toThrow('File is empty');
+    expect(() => mapFile(42 as unknown as string)).toThrow(TypeError);
+  });
+});
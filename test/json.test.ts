@@ -0,0 +1,96 @@
+import { describe, it, expect } from 'vitest';
+import { encode, decode, fromJSON, toJSON, fromJSONAsync, toJSONAsync, getEntry } from '../src/index';
+
+const data = {
+  name: 'test',
+  count: 42,
+  ratio: 0.5,
+  flags: [true, false, null],
+  nested: { items: [{ id: 1 }, { id: 2 }], label: 'ünïcödé' },
+};
+
+describe('fromJSON', () => {
+  it('converts JSON strings', () => {
+    expect(decode(fromJSON(JSON.stringify(data)))).toEqual(data);
+  });
+
+  it('converts Buffers of UTF-8 JSON', () => {
+    expect(decode(fromJSON(Buffer.from(JSON.stringify(data))))).toEqual(data);
+  });
+
+  it('converts root arrays', () => {
+    expect(decode(fromJSON('[1, "two", {"three": 3}]'))).toEqual([1, 'two', { three: 3 }]);
+  });
+
+  it('throws for invalid JSON and non-container roots', () => {
+    expect(() => fromJSON('{"a":')).toThrow();
+    expect(() => fromJSON('42')).toThrow();
+    expect(() => fromJSON(42 as never)).toThrow(TypeError);
+  });
+});
+
+describe('toJSON', () => {
+  it('converts to a JSON string', () => {
+    expect(JSON.parse(toJSON(encode(data)))).toEqual(data);
+  });
+
+  it('converts to a Buffer of UTF-8 JSON', () => {
+    const out = toJSON(encode(data), { asBuffer: true });
+    expect(Buffer.isBuffer(out)).toBe(true);
+    expect(JSON.parse(out.toString('utf8'))).toEqual(data);
+  });
+
+  it('converts a subtree at an offset', () => {
+    const buf = encode(data);
+    const { offset } = getEntry(buf, 0, 'nested') as { offset: number };
+    expect(JSON.parse(toJSON(buf, { offset }))).toEqual(data.nested);
+  });
+
+  it('round-trips through fromJSON', () => {
+    const json = toJSON(encode(data));
+    expect(JSON.parse(toJSON(fromJSON(json)))).toEqual(data);
+  });
+
+  it('rejects invalid arguments', () => {
+    const buf = encode(data);
+    expect(() => toJSON('nope' as never)).toThrow(TypeError);
+    expect(() => toJSON(buf, { offset: buf.length })).toThrow(RangeError);
+    expect(() => toJSON(buf, { offset: buf.indexOf('test') })).toThrow('Offset does not point to an object or array');
+  });
+
+  it('refuses malformed messages', () => {
+    const buf = encode({ text: 'x'.repeat(200) });
+    const at = buf.indexOf('x'.repeat(200));
+    buf.fill(0xff, at - 4, at);
+    expect(() => toJSON(buf)).toThrow('Malformed Lite3 buffer');
+  });
+});
+
+describe('async JSON conversion', () => {
+  it('converts on the threadpool', async () => {
+    const json = JSON.stringify(data);
+    expect(decode(await fromJSONAsync(json, { asyncThreshold: 0 }))).toEqual(data);
+    expect(decode(await fromJSONAsync(Buffer.from(json), { asyncThreshold: 0 }))).toEqual(data);
+
+    const buf = encode(data);
+    expect(JSON.parse(await toJSONAsync(buf, { asyncThreshold: 0 }))).toEqual(data);
+    const bytes = await toJSONAsync(buf, { asBuffer: true, asyncThreshold: 0 });
+    expect(JSON.parse(bytes.toString('utf8'))).toEqual(data);
+  });
+
+  it('converts small inputs on the calling thread', async () => {
+    expect(decode(await fromJSONAsync(JSON.stringify(data)))).toEqual(data);
+    expect(JSON.parse(await toJSONAsync(encode(data)))).toEqual(data);
+  });
+
+  it('rejects invalid JSON', async () => {
+    await expect(fromJSONAsync('{"a":', { asyncThreshold: 0 })).rejects.toThrow();
+  });
+
+  it('verifies messages on the threadpool', async () => {
+    const buf = encode({ text: 'x'.repeat(200) });
+    const at = buf.indexOf('x'.repeat(200));
+    buf.fill(0xff, at - 4, at);
+    await expect(toJSONAsync(buf, { asyncThreshold: 0 })).rejects.toThrow('Malformed Lite3 buffer');
+  });
+});
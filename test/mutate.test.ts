@@ -0,0 +1,166 @@
+import { describe, it, expect } from 'vitest';
+import { encode, decode, set, arrAppend, getEntry, verify, Lite3Buffer } from '../src/index';
+
+describe('set', () => {
+  it('adds and replaces properties', () => {
+    let buf = encode({ name: 'test', count: 1 });
+    buf = set(buf, 0, 'count', 2);
+    buf = set(buf, 0, 'label', 'added');
+    expect(decode(buf)).toEqual({ name: 'test', count: 2, label: 'added' });
+  });
+
+  it('writes nested values', () => {
+    let buf = encode({ a: 1 });
+    buf = set(buf, 0, 'nested', { items: [1, 2, { deep: true }], blob: Buffer.from([1, 2]) });
+    const decoded = decode<{ a: number; nested: { items: unknown[]; blob: Uint8Array } }>(buf);
+    expect(decoded.nested.items).toEqual([1, 2, { deep: true }]);
+    expect(Array.from(decoded.nested.blob)).toEqual([1, 2]);
+    expect(verify(buf)).toBe(true);
+  });
+
+  it('edits a nested object by offset', () => {
+    let buf = encode({ user: { name: 'Alice' }, other: 1 });
+    const { offset } = getEntry(buf, 0, 'user') as { offset: number };
+    buf = set(buf, offset, 'age', 30, { integers: true });
+    expect(decode(buf)).toEqual({ user: { name: 'Alice', age: 30 }, other: 1 });
+  });
+
+  it('returns the same Buffer when the message keeps its length', () => {
+    const buf = encode({ x: 1.5 });
+    expect(set(buf, 0, 'x', 2.5)).toBe(buf);
+    expect(decode(buf)).toEqual({ x: 2.5 });
+  });
+
+  it('grows into spare capacity across many edits', () => {
+    let buf = encode({});
+    const expected: Record<string, number> = {};
+    const memory = new Set<ArrayBufferLike>();
+    for (let i = 0; i < 500; i++) {
+      buf = set(buf, 0, `key${i}`, i);
+      expected[`key${i}`] = i;
+      memory.add(buf.buffer);
+    }
+    expect(decode(buf)).toEqual(expected);
+    // Capacity doubles, so only a handful of edits copy the message:
+    expect(memory.size).toBeLessThan(20);
+  });
+
+  it('does not write past a Buffer it did not allocate', () => {
+    const pool = Buffer.alloc(4096, 0xaa);
+    const message = encode({ a: 1 });
+    const view = pool.subarray(0, message.length);
+    message.copy(view);
+
+    const edited = set(view, 0, 'b', 'grown');
+    expect(decode(edited)).toEqual({ a: 1, b: 'grown' });
+    expect(pool.subarray(message.length).every((byte) => byte === 0xaa)).toBe(true);
+  });
+
+  it('leaves a Buffer it did not allocate intact when it grows', () => {
+    const original = encode({ a: 1 });
+    const copy = Buffer.from(original);
+    const edited = set(original, 0, 'b', { c: [1, 2, 3] });
+    expect(edited).not.toBe(original);
+    expect(original.equals(copy)).toBe(true);
+  });
+
+  it('rejects edits through a Buffer replaced by a later edit', () => {
+    const first = set(encode({ a: 1 }), 0, 'b', 2);
+    const second = set(first, 0, 'c', 'a longer value');
+    expect(second).not.toBe(first);
+    expect(decode(second)).toEqual({ a: 1, b: 2, c: 'a longer value' });
+    expect(() => set(first, 0, 'd', 4)).toThrow(/out of date/);
+  });
+
+  it('retries a write that outgrows its memory from the original message', () => {
+    let buf = set(encode({ a: 1 }), 0, 'b', 2);
+    const big = 'x'.repeat(64 * 1024);
+    buf = set(buf, 0, 'c', big);
+    expect(decode(buf)).toEqual({ a: 1, b: 2, c: big });
+  });
+
+  it('refuses to finish an edit whose value changed the Buffer', () => {
+    const buf = set(encode({ a: 1 }), 0, 'b', 2);
+    const editing = { get c() { set(buf, 0, 'd', 'inner'); return 3; } };
+    expect(() => set(buf, 0, 'e', editing)).toThrow(/out of date|while the value was read/);
+
+    const other = set(encode({ a: 1 }), 0, 'b', 2);
+    const arraybuffer = other.buffer as ArrayBuffer & { transfer(): ArrayBuffer };
+    let moved: ArrayBuffer | undefined;  // keeps the memory alive
+    const detaching = { get c() { moved = arraybuffer.transfer(); return 3; } };
+    expect(() => set(other, 0, 'e', detaching)).toThrow(/out of date|detached/);
+    expect(moved).toBeDefined();
+  });
+
+  it('edits shared memory in place only when asked to', () => {
+    const message = encode({ x: 1.5, s: 'short' });
+    const shared = new Uint8Array(new SharedArrayBuffer(message.length));
+    shared.set(message);
+
+    expect(() => set(shared as Buffer, 0, 'x', 2.5)).toThrow(/SharedArrayBuffer/);
+    expect(decode(shared)).toEqual({ x: 1.5, s: 'short' });
+
+    expect(set(shared as Buffer, 0, 'x', 2.5, { shared: true })).toBe(shared);
+    expect(decode(shared)).toEqual({ x: 2.5, s: 'short' });
+  });
+
+  it('rejects bad arguments', () => {
+    const buf = encode({ list: [1] });
+    const { offset } = getEntry(buf, 0, 'list') as { offset: number };
+    expect(() => set(buf, offset, 'x', 1)).toThrow(TypeError);
+    expect(() => set(buf, buf.length, 'x', 1)).toThrow(RangeError);
+    expect(() => set(buf, 0, 'x', undefined as never)).toThrow(TypeError);
+    expect(() => set(buf, 0, 1 as never, 1)).toThrow(TypeError);
+    expect(() => set('nope' as never, 0, 'x', 1)).toThrow(TypeError);
+  });
+});
+
+describe('arrAppend', () => {
+  it('appends primitives and nested values', () => {
+    let buf = encode([1]);
+    buf = arrAppend(buf, 0, 'two');
+    buf = arrAppend(buf, 0, { three: [3] });
+    expect(decode(buf)).toEqual([1, 'two', { three: [3] }]);
+  });
+
+  it('appends to a nested array', () => {
+    let buf = encode({ log: [] as number[] });
+    const { offset } = getEntry(buf, 0, 'log') as { offset: number };
+    for (let i = 0; i < 100; i++) buf = arrAppend(buf, offset, i);
+    expect(decode(buf)).toEqual({ log: Array.from({ length: 100 }, (_, i) => i) });
+  });
+
+  it('rejects offsets that are not arrays', () => {
+    const buf = encode({ a: 1 });
+    expect(() => arrAppend(buf, 0, 1)).toThrow(TypeError);
+  });
+});
+
+describe('writable Lite3Buffer', () => {
+  it('writes properties through the proxy', () => {
+    const proxy = Lite3Buffer.from<Record<string, unknown>>({ name: 'test', nested: { n: 1 } });
+    proxy.name = 'changed';
+    proxy.extra = [1, 2];
+    (proxy.nested as Record<string, unknown>).m = 2;
+
+    expect(proxy.name).toBe('changed');
+    expect(Object.keys(proxy).sort()).toEqual(['extra', 'name', 'nested']);
+    expect(decode(Lite3Buffer.getBuffer(proxy)!)).toEqual({ name: 'changed', nested: { n: 1, m: 2 }, extra: [1, 2] });
+  });
+
+  it('appends to array proxies', () => {
+    const proxy = Lite3Buffer.from<{ items: number[] }>({ items: [1] });
+    expect(proxy.items.push(2, 3)).toBe(3);
+    proxy.items[3] = 4;
+    expect(proxy.items.length).toBe(4);
+    expect([...proxy.items]).toEqual([1, 2, 3, 4]);
+    expect(decode(Lite3Buffer.getBuffer(proxy)!)).toEqual({ items: [1, 2, 3, 4] });
+  });
+
+  it('rejects writes other than appends to arrays', () => {
+    const proxy = Lite3Buffer.from<{ items: number[] }>({ items: [1, 2] });
+    expect(() => {
+      proxy.items[0] = 5;
+    }).toThrow(TypeError);
+  });
+});
@@ -0,0 +1,66 @@
+import { describe, it, expect } from 'vitest';
+import { encode, getPath, project, compilePath } from '../src/index';
+
+describe('path access', () => {
+  const obj = {
+    meta: { type: 'order', tenant: 'acme' },
+    payload: { items: [{ id: 1, tags: ['a', 'b'] }, { id: 2, tags: [] }] },
+    'dotted.key': { 'x[0]': true },
+  };
+  const buf = encode(obj);
+
+  describe('getPath', () => {
+    it('resolves keys and indices', () => {
+      expect(getPath(buf, 'meta.type')).toBe('order');
+      expect(getPath(buf, 'payload.items[1].id')).toBe(2);
+      expect(getPath(buf, 'payload.items[0].tags[1]')).toBe('b');
+    });
+
+    it('decodes containers at the path', () => {
+      expect(getPath(buf, 'meta')).toEqual(obj.meta);
+      expect(getPath(buf, '')).toEqual(obj);
+    });
+
+    it('supports quoted keys', () => {
+      expect(getPath(buf, '["dotted.key"]["x[0]"]')).toBe(true);
+      expect(getPath(buf, "['dotted.key']")).toEqual({ 'x[0]': true });
+    });
+
+    it('returns undefined for missing paths', () => {
+      expect(getPath(buf, 'meta.missing')).toBeUndefined();
+      expect(getPath(buf, 'payload.items[5]')).toBeUndefined();
+      expect(getPath(buf, 'meta[0]')).toBeUndefined();
+      expect(getPath(buf, 'meta.type.length')).toBeUndefined();
+    });
+
+    it('supports root arrays', () => {
+      expect(getPath(encode([{ a: 1 }]), '[0].a')).toBe(1);
+    });
+
+    it('throws on invalid syntax', () => {
+      expect(() => getPath(buf, 'a..b')).toThrow(/position/);
+      expect(() => getPath(buf, 'a[x]')).toThrow(/position/);
+      expect(() => getPath(buf, 'a["b]')).toThrow(/position/);
+    });
+  });
+
+  describe('compilePath', () => {
+    it('returns a reusable path', () => {
+      const path = compilePath('payload.items[0].id');
+      expect(path.path).toBe('payload.items[0].id');
+      expect(getPath(buf, path)).toBe(1);
+      expect(getPath(encode({ payload: { items: [{ id: 9 }] } }), path)).toBe(9);
+    });
+
+    it('rejects non-path objects', () => {
+      expect(() => getPath(buf, { path: 'meta' } as never)).toThrow(TypeError);
+    });
+  });
+
+  describe('project', () => {
+    it('resolves many paths in one call', () => {
+      const paths = ['meta.type', compilePath('meta.tenant'), 'payload.items[1].id', 'nope'];
+      expect(project(buf, paths)).toEqual(['order', 'acme', 2, undefined]);
+    });
+  });
+});
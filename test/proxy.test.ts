@@ -8,6 +8,8 @@ import {
   getArrayElement,
   getChildOffset,
   getArrayChildOffset,
+  getEntry,
+  getArrayEntry,
   getKeys,
   getLength,
   hasKey,
@@ -100,6 +102,14 @@ describe('proxy functions', () => {
       expect(getValue(buf, 0, 'nothing')).toBe(null);
     });
 
+    it('returns bytes value as a view into the buffer', () => {
+      const bytesBuf = encode({ blob: Buffer.from([1, 2, 3]) });
+      const blob = getValue(bytesBuf, 0, 'blob') as Uint8Array;
+      expect(getType(bytesBuf, 0, 'blob')).toBe('bytes');
+      expect(Array.from(blob)).toEqual([1, 2, 3]);
+      expect(blob.buffer).toBe(bytesBuf.buffer);
+    });
+
     it('returns offset for nested object', () => {
       const offset = getValue(buf, 0, 'nested');
       expect(typeof offset).toBe('number');
@@ -164,6 +174,30 @@ describe('proxy functions', () => {
     });
   });
 
+  describe('getEntry', () => {
+    it('returns primitive values directly', () => {
+      expect(getEntry(buf, 0, 'name')).toBe('test');
+      expect(getEntry(buf, 0, 'count')).toBe(42);
+      expect(getEntry(buf, 0, 'nothing')).toBe(null);
+    });
+
+    it('returns a descriptor for nested structures', () => {
+      expect(getEntry(buf, 0, 'nested')).toEqual({ type: 'object', offset: getChildOffset(buf, 0, 'nested') });
+      expect(getEntry(buf, 0, 'items')).toEqual({ type: 'array', offset: getChildOffset(buf, 0, 'items') });
+    });
+
+    it('returns undefined for missing keys', () => {
+      expect(getEntry(buf, 0, 'missing')).toBeUndefined();
+    });
+
+    it('resolves array elements', () => {
+      const mixedOffset = getChildOffset(buf, 0, 'mixed');
+      expect(getArrayEntry(buf, mixedOffset, 1)).toBe('two');
+      expect(getArrayEntry(buf, mixedOffset, 2)).toEqual({ type: 'object', offset: getArrayChildOffset(buf, mixedOffset, 2) });
+      expect(getArrayEntry(buf, mixedOffset, 3)).toBeUndefined();
+    });
+  });
+
   describe('array access', () => {
     let itemsOffset: number;
     let mixedOffset: number;
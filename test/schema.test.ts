@@ -0,0 +1,91 @@
+import { describe, it, expect } from 'vitest';
+import { compileSchema, encode, decode, type SchemaShape } from '../src/index';
+
+const shape: SchemaShape = {
+  id: 'integer',
+  name: 'string',
+  score: 'number',
+  active: 'boolean',
+  big: 'bigint',
+  blob: 'bytes',
+  extra: 'any',
+  tags: ['string'],
+  owner: { id: 'integer', email: 'string' },
+  rows: [{ x: 'number', y: 'number' }],
+};
+
+const record = {
+  id: 42,
+  name: 'Ada',
+  score: 1.5,
+  active: true,
+  big: 2n ** 60n,
+  blob: Buffer.from([1, 2, 3]),
+  extra: { anything: [1, 'two', null] },
+  tags: ['a', 'b'],
+  owner: { id: 7, email: 'ada@example.com' },
+  rows: [{ x: 1, y: 2 }, { x: 3.5, y: -4 }],
+};
+
+describe('compileSchema', () => {
+  it('round-trips a record', () => {
+    const schema = compileSchema(shape);
+    const decoded = schema.decode(schema.encode(record)) as typeof record;
+    expect({ ...decoded, blob: Buffer.from(decoded.blob) }).toEqual(record);
+  });
+
+  it('writes ordinary lite3 messages', () => {
+    const schema = compileSchema(shape);
+    const decoded = decode<typeof record>(schema.encode(record));
+    expect(decoded.owner).toEqual(record.owner);
+    expect(decoded.tags).toEqual(record.tags);
+    expect(compileSchema({ id: 'integer', name: 'string' }).decode(encode(record))).toEqual({ id: 42, name: 'Ada' });
+  });
+
+  it('decodes fields in shape order', () => {
+    const schema = compileSchema({ b: 'string', a: 'integer', c: 'boolean' });
+    expect(schema.keys).toEqual(['b', 'a', 'c']);
+    expect(Object.keys(schema.decode(encode({ c: true, a: 1, b: 'x' })))).toEqual(['b', 'a', 'c']);
+  });
+
+  it('round-trips integer and number fields', () => {
+    const schema = compileSchema({ i: 'integer', n: 'number' });
+    expect(schema.decode(schema.encode({ i: 3, n: 3 }))).toEqual({ i: 3, n: 3 });
+    expect(schema.decode(schema.encode({ i: 2.5, n: -0 }))).toEqual({ i: 2.5, n: -0 });
+    expect(Object.is(schema.decode(schema.encode({ i: -0, n: 1 })).i, -0)).toBe(true);
+  });
+
+  it('stores values of another type as encode() would', () => {
+    const schema = compileSchema({ id: 'integer', name: 'string', owner: { id: 'integer' }, tags: ['string'] });
+    const value = { id: 'not a number', name: null, owner: [1, 2], tags: { not: 'an array' } };
+    expect(schema.decode(schema.encode(value))).toEqual(value);
+  });
+
+  it('leaves out properties not in the shape and fields not in the message', () => {
+    const schema = compileSchema({ id: 'integer', name: 'string' });
+    expect(decode(schema.encode({ id: 1, secret: 'x' } as any))).toEqual({ id: 1 });
+    expect(schema.decode(encode({ name: 'n', other: true }))).toEqual({ name: 'n' });
+  });
+
+  it('handles shapes with many fields', () => {
+    const wide = Object.fromEntries(Array.from({ length: 100 }, (_, i) => [`f${i}`, 'integer' as const]));
+    const value = Object.fromEntries(Array.from({ length: 100 }, (_, i) => [`f${i}`, i]));
+    const schema = compileSchema(wide);
+    expect(schema.decode(schema.encode(value))).toEqual(value);
+  });
+
+  it('rejects invalid shapes', () => {
+    expect(() => compileSchema({ id: 'int' as any })).toThrow(TypeError);
+    expect(() => compileSchema({ list: ['string', 'number'] as any })).toThrow(TypeError);
+    expect(() => compileSchema([] as any)).toThrow(TypeError);
+    const cyclic: any = {};
+    cyclic.self = cyclic;
+    expect(() => compileSchema(cyclic)).toThrow(RangeError);
+  });
+
+  it('rejects non-object values and messages', () => {
+    const schema = compileSchema({ id: 'integer' });
+    expect(() => schema.encode([1] as any)).toThrow(TypeError);
+    expect(() => schema.decode(encode([1]))).toThrow(TypeError);
+  });
+});
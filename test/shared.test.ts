@@ -0,0 +1,153 @@
+import { describe, it, expect } from 'vitest';
+import { Worker } from 'node:worker_threads';
+import { resolve } from 'node:path';
+import {
+  encode,
+  encodeInto,
+  decode,
+  verify,
+  isVerified,
+  getValue,
+  getKeys,
+  getRootType,
+  getPath,
+  Cursor,
+  Lite3Buffer,
+  $buffer,
+} from '../src/index';
+
+const doc = { name: 'Ada', tags: ['a', 'b'], meta: { id: 7, blob: new Uint8Array([1, 2, 3]) } };
+
+/** `doc` encoded into a SharedArrayBuffer, at a non-zero offset */
+function sharedMessage(): Uint8Array {
+  const sab = new SharedArrayBuffer(4096);
+  const written = encodeInto(doc, new Uint8Array(sab), 64);
+  expect(written).toBeGreaterThan(0);
+  return new Uint8Array(sab, 64, written);
+}
+
+describe('Uint8Array and SharedArrayBuffer input', () => {
+  it('decodes a plain Uint8Array', () => {
+    const buf = encode(doc);
+    expect(decode(new Uint8Array(buf.buffer, buf.byteOffset, buf.length))).toEqual(decode(buf));
+  });
+
+  it('decodes and verifies shared memory, copying bytes values', () => {
+    const message = sharedMessage();
+    expect(verify(message)).toBe(true);
+    expect(isVerified(message)).toBe(false);  // another thread could still write to it
+
+    const value = decode<typeof doc>(message);
+    expect(value.name).toBe('Ada');
+    expect(Array.from(value.meta.blob)).toEqual([1, 2, 3]);
+    expect(value.meta.blob.buffer).not.toBeInstanceOf(SharedArrayBuffer);
+  });
+
+  it('reads shared memory through the proxy functions and paths', () => {
+    const message = sharedMessage();
+    expect(getRootType(message)).toBe('object');
+    expect(getKeys(message, 0).sort()).toEqual(['meta', 'name', 'tags']);
+    expect(getValue(message, 0, 'name')).toBe('Ada');
+    expect(getPath(message, 'meta.id')).toBe(7);
+  });
+
+  it('opens proxies over Uint8Arrays and whole SharedArrayBuffers', () => {
+    const message = sharedMessage();
+    const proxy = Lite3Buffer.from<typeof doc>(message);
+    expect(proxy.tags[1]).toBe('b');
+    expect((proxy as any)[$buffer].buffer).toBe(message.buffer);
+
+    const whole = new SharedArrayBuffer(encode(doc).length);
+    new Uint8Array(whole).set(encode(doc));
+    expect(Lite3Buffer.from<typeof doc>(whole).meta.id).toBe(7);
+  });
+
+  it('still rejects other views', () => {
+    expect(() => decode(new Uint16Array(8) as unknown as Uint8Array)).toThrow(TypeError);
+    expect(() => new Cursor(new DataView(new ArrayBuffer(8)) as unknown as Uint8Array)).toThrow(TypeError);
+  });
+});
+
+describe('Cursor offset', () => {
+  it('opens a cursor at a nested node', () => {
+    const buf = encode(doc);
+    const meta = new Cursor(buf).get('meta') as Cursor;
+    expect(new Cursor(buf, meta.offset).get('id')).toBe(7);
+  });
+
+  it('rejects offsets that are not an object or array', () => {
+    const buf = encode(doc);
+    expect(() => new Cursor(buf, -1)).toThrow(RangeError);
+    expect(() => new Cursor(buf, buf.length)).toThrow(TypeError);
+  });
+
+  it('only accepts real nodes of a verified buffer', () => {
+    const buf = encode({ meta: { id: 7 }, raw: new Uint8Array(256).map((_, i) => i) });
+    expect(verify(buf)).toBe(true);
+    const meta = (new Cursor(buf).get('meta') as Cursor).offset;
+
+    // Some offsets inside `raw` carry an object or array type byte:
+    for (let offset = 1; offset < buf.length; offset++) {
+      if (offset === meta) {
+        expect(new Cursor(buf, offset).get('id')).toBe(7);
+      } else {
+        expect(() => new Cursor(buf, offset)).toThrow(TypeError);
+      }
+    }
+  });
+});
+
+describe('Lite3Buffer transferables', () => {
+  it('describes shared memory in place', () => {
+    const message = sharedMessage();
+    const t = Lite3Buffer.toTransferable(Lite3Buffer.from(message));
+    expect(t.buffer).toBe(message.buffer);
+    expect(t.byteOffset).toBe(64);
+    expect(t.byteLength).toBe(message.length);
+    expect(t.offset).toBe(0);
+  });
+
+  it('copies other memory into a SharedArrayBuffer and reopens nested proxies', () => {
+    const proxy = Lite3Buffer.from<typeof doc>(doc);
+    const t = Lite3Buffer.toTransferable(proxy.meta);
+    expect(t.buffer).toBeInstanceOf(SharedArrayBuffer);
+    expect(t.offset).toBeGreaterThan(0);
+
+    const meta = Lite3Buffer.fromTransferable<typeof doc.meta>(t);
+    expect(meta.id).toBe(7);
+    expect(Object.keys(meta).sort()).toEqual(['blob', 'id']);
+  });
+
+  it('rejects values that are not proxies', () => {
+    expect(() => Lite3Buffer.toTransferable({})).toThrow(TypeError);
+  });
+
+  it('shares one message with a worker without copying', async () => {
+    const t = Lite3Buffer.toTransferable(Lite3Buffer.from(sharedMessage()));
+    const worker = new Worker(
+      `
+      const { parentPort, workerData } = require('node:worker_threads');
+      const { Cursor } = require(workerData.addon);
+      parentPort.on('message', ({ buffer, byteOffset, byteLength, offset }) => {
+        const cursor = new Cursor(Buffer.from(buffer, byteOffset, byteLength), offset);
+        // Write through the shared memory so the parent can see it:
+        new Uint8Array(buffer)[0] = 0xff;
+        parentPort.postMessage(cursor.get('name'));
+      });
+      `,
+      { eval: true, workerData: { addon: resolve('build/Release/lite3.node') } }
+    );
+
+    try {
+      const name = await new Promise((done, reject) => {
+        worker.once('message', done);
+        worker.once('error', reject);
+        worker.postMessage(t);
+      });
+      expect(name).toBe('Ada');
+      expect(new Uint8Array(t.buffer)[0]).toBe(0xff);
+    } finally {
+      await worker.terminate();
+    }
+  });
+});
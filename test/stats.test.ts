@@ -0,0 +1,74 @@
+import { describe, it, expect, beforeEach, afterEach } from 'vitest';
+import { encode, decode, stats, resetStats, setStatsEnabled, Lite3Buffer, BatchEncoder } from '../src/index';
+
+describe('stats', () => {
+  beforeEach(() => {
+    resetStats();
+  });
+
+  afterEach(() => {
+    setStatsEnabled(false);
+    resetStats();
+  });
+
+  it('collects nothing until enabled', () => {
+    decode(encode({ a: 1 }));
+    const s = stats();
+    expect(s.enabled).toBe(false);
+    expect(s.encode.calls).toBe(0);
+    expect(s.decode.calls).toBe(0);
+    expect(s.contexts).toBe(0);
+  });
+
+  it('counts encode calls, bytes and contexts', () => {
+    setStatsEnabled(true);
+    const buf = encode({ a: 1, b: 'two' });
+    const s = stats();
+    expect(s.enabled).toBe(true);
+    expect(s.encode.calls).toBe(1);
+    expect(s.encode.bytesOut).toBe(buf.length);
+    expect(s.encode.ns).toBeGreaterThan(0);
+    expect(s.contexts).toBe(1);
+  });
+
+  it('counts decode calls, bytes and created values', () => {
+    const buf = encode({ a: 1, b: 'two', c: [true, null] });
+    setStatsEnabled(true);
+    decode(buf);
+    const s = stats();
+    expect(s.decode.calls).toBe(1);
+    expect(s.decode.bytesIn).toBe(buf.length);
+    expect(s.napiValues).toBe(6);
+    expect(s.encode.calls).toBe(0);
+  });
+
+  it('counts proxy reads', () => {
+    const proxy = Lite3Buffer.from(encode({ user: { name: 'Ada' } })) as any;
+    setStatsEnabled(true);
+    expect(proxy.user.name).toBe('Ada');
+    const s = stats();
+    expect(s.proxy.calls).toBeGreaterThanOrEqual(2);
+    expect(s.decode.calls).toBe(0);
+  });
+
+  it('counts buffers that had to grow', () => {
+    setStatsEnabled(true);
+    encode({ rows: Array.from({ length: 10_000 }, (_, i) => ({ id: i, name: `row ${i}` })) });
+    expect(stats().reallocs).toBeGreaterThan(0);
+
+    resetStats();
+    const batch = new BatchEncoder({ initialCapacity: 1024 });
+    for (let i = 0; i < 100; i++) batch.add({ id: i, name: `row ${i}` });
+    expect(stats().reallocs).toBeGreaterThan(0);
+  });
+
+  it('resets counters without disabling them', () => {
+    setStatsEnabled(true);
+    encode({ a: 1 });
+    resetStats();
+    const s = stats();
+    expect(s.enabled).toBe(true);
+    expect(s.encode.calls).toBe(0);
+    expect(s.contexts).toBe(0);
+  });
+});
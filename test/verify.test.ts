@@ -0,0 +1,103 @@
+import { describe, it, expect } from 'vitest';
+import { encode, verify, isVerified, getValue, getKeys, Lite3Buffer } from '../src/index';
+
+const data = {
+  name: 'test',
+  count: 42,
+  blob: Buffer.from([1, 2, 3]),
+  nested: { items: [1, 'two', { three: 3 }], empty: {} },
+};
+
+/** Overwrite the length prefix of the 200-byte string in `buf` with 0xffffffff */
+function corruptLength(buf: Buffer) {
+  const at = buf.indexOf('x'.repeat(200));
+  expect(at).toBeGreaterThanOrEqual(4);
+  buf.fill(0xff, at - 4, at);
+}
+
+describe('verify', () => {
+  it('accepts encoded messages and marks them verified', () => {
+    const buf = encode(data);
+    expect(isVerified(buf)).toBe(false);
+    expect(verify(buf)).toBe(true);
+    expect(isVerified(buf)).toBe(true);
+    expect(verify(buf)).toBe(true);
+  });
+
+  it('accepts root arrays', () => {
+    expect(verify(encode([1, [2, [3]], { a: null }]))).toBe(true);
+  });
+
+  it('rejects empty and garbage buffers', () => {
+    expect(verify(Buffer.alloc(0))).toBe(false);
+    expect(verify(Buffer.alloc(64, 0xff))).toBe(false);
+  });
+
+  it('rejects truncated messages', () => {
+    const buf = encode({ text: 'x'.repeat(200), n: 1 });
+    const truncated = Buffer.from(buf.subarray(0, buf.length - 50));
+    expect(verify(truncated)).toBe(false);
+    expect(isVerified(truncated)).toBe(false);
+  });
+
+  it('only marks the Buffer object that was verified', () => {
+    const buf = encode(data);
+    verify(buf);
+    expect(isVerified(Buffer.from(buf))).toBe(false);
+  });
+
+  it('leaves reads from verified buffers unchanged', () => {
+    const buf = encode(data);
+    verify(buf);
+    expect(getValue(buf, 0, 'name')).toBe('test');
+    expect(getKeys(buf, 0).sort()).toEqual(['blob', 'count', 'name', 'nested']);
+    const proxy = Lite3Buffer.from<typeof data>(buf);
+    expect(proxy.nested.items[1]).toBe('two');
+  });
+
+  it('walks the message again and clears the mark when it fails', () => {
+    const buf = encode({ text: 'x'.repeat(200) });
+    expect(verify(buf)).toBe(true);
+    corruptLength(buf);
+    expect(verify(buf)).toBe(false);
+    expect(isVerified(buf)).toBe(false);
+    expect(() => getValue(buf, 0, 'text')).toThrow('Malformed Lite3 buffer');
+  });
+
+  it('bounds-checks reads from corrupted unverified buffers', () => {
+    const buf = encode({ text: 'x'.repeat(200), nested: { n: 1 } });
+    corruptLength(buf);
+    expect(() => getValue(buf, 0, 'text')).toThrow('Malformed Lite3 buffer');
+    expect(() => Lite3Buffer.from<{ text: string }>(buf).text).toThrow('Malformed Lite3 buffer');
+  });
+
+  it('rejects non-Buffer arguments', () => {
+    expect(() => verify('nope' as never)).toThrow(TypeError);
+  });
+});
+
+describe('proxy offset checks', () => {
+  it('rejects offsets outside the buffer', () => {
+    const buf = encode(data);
+    expect(() => getValue(buf, -1, 'name')).toThrow(RangeError);
+    expect(() => getValue(buf, buf.length, 'name')).toThrow(RangeError);
+    expect(() => getKeys(buf, buf.length + 10)).toThrow(RangeError);
+  });
+
+  it('checks reads from forged offsets into a verified buffer', () => {
+    // Every byte value occurs in `raw`, so some offsets inside it look like
+    // objects or arrays whose keys and lengths run past the end:
+    const buf = encode({ name: 'test', raw: new Uint8Array(256).map((_, i) => i) });
+    expect(verify(buf)).toBe(true);
+    for (let offset = 1; offset < buf.length; offset++) {
+      for (const read of [() => getKeys(buf, offset), () => getValue(buf, offset, 'name')]) {
+        try {
+          read();
+        } catch (err) {
+          expect(err).toBeInstanceOf(Error);
+        }
+      }
+    }
+    expect(getValue(buf, 0, 'name')).toBe('test');
+  });
+});